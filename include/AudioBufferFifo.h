@@ -0,0 +1,159 @@
+/*
+ * AudioBufferFifo.h - pre-allocated single-producer single-consumer FIFO of
+ *                     audio periods
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUDIO_BUFFER_FIFO_H
+#define LMMS_AUDIO_BUFFER_FIFO_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "LmmsTypes.h"
+#include "SampleFrame.h"
+
+
+namespace lmms
+{
+
+
+/**
+	@brief Ring of pre-allocated periods between the render thread and the audio device
+
+	The writer renders into the slot returned by beginWrite() and publishes it
+	with endWrite(). The reader gets the period in place from read(); it stays
+	valid until the next call to read(), which hands the slot back to the
+	writer. Both sides block (futex based) if there is nothing to do, nothing
+	is allocated after construction.
+*/
+class AudioBufferFifo
+{
+public:
+	//! @param depth number of periods the writer may render ahead of the reader
+	AudioBufferFifo(std::size_t depth, fpp_t framesPerPeriod) :
+		// one more slot, as the reader keeps its current period until the next read()
+		m_slots(depth + 1),
+		m_framesPerPeriod(framesPerPeriod),
+		m_buffer(std::make_unique<SampleFrame[]>(m_slots * framesPerPeriod)),
+		m_endOfStream(std::make_unique<bool[]>(m_slots)),
+		m_written(0),
+		m_read(0),
+		m_released(0)
+	{
+	}
+
+	std::size_t depth() const
+	{
+		return m_slots - 1;
+	}
+
+	//! Writer only: returns the slot for the next period, blocks while the ring is full
+	SampleFrame* beginWrite()
+	{
+		const auto written = m_written.load(std::memory_order_relaxed);
+		auto released = m_released.load(std::memory_order_acquire);
+		while (written - released >= m_slots)
+		{
+			m_released.wait(released, std::memory_order_acquire);
+			released = m_released.load(std::memory_order_acquire);
+		}
+		return slot(written);
+	}
+
+	//! Writer only: publishes the slot returned by beginWrite()
+	void endWrite(bool endOfStream = false)
+	{
+		const auto written = m_written.load(std::memory_order_relaxed);
+		m_endOfStream[written % m_slots] = endOfStream;
+		m_written.store(written + 1, std::memory_order_release);
+		m_written.notify_one();
+	}
+
+	//! Writer only: tells the reader to stop, read() will return nullptr
+	void writeEndOfStream()
+	{
+		beginWrite();
+		endWrite(true);
+	}
+
+	//! Writer only: blocks until the reader has fetched everything written so far
+	void waitUntilRead()
+	{
+		const auto written = m_written.load(std::memory_order_relaxed);
+		auto read = m_read.load(std::memory_order_acquire);
+		while (read != written)
+		{
+			m_read.wait(read, std::memory_order_acquire);
+			read = m_read.load(std::memory_order_acquire);
+		}
+	}
+
+	/**
+		Reader only: releases the previous period and returns the next one,
+		blocks until it is available. Returns nullptr at the end of the stream.
+	*/
+	const SampleFrame* read()
+	{
+		const auto read = m_read.load(std::memory_order_relaxed);
+		if (m_released.load(std::memory_order_relaxed) != read)
+		{
+			m_released.store(read, std::memory_order_release);
+			m_released.notify_one();
+		}
+
+		auto written = m_written.load(std::memory_order_acquire);
+		while (written == read)
+		{
+			m_written.wait(written, std::memory_order_acquire);
+			written = m_written.load(std::memory_order_acquire);
+		}
+
+		const bool endOfStream = m_endOfStream[read % m_slots];
+		m_read.store(read + 1, std::memory_order_release);
+		m_read.notify_one();
+
+		return endOfStream ? nullptr : slot(read);
+	}
+
+private:
+	SampleFrame* slot(std::size_t index) const
+	{
+		return m_buffer.get() + (index % m_slots) * m_framesPerPeriod;
+	}
+
+	const std::size_t m_slots;
+	const fpp_t m_framesPerPeriod;
+	const std::unique_ptr<SampleFrame[]> m_buffer;
+	const std::unique_ptr<bool[]> m_endOfStream;
+
+	// monotonic counters of written, fetched and given back periods
+	alignas(64) std::atomic_size_t m_written;
+	alignas(64) std::atomic_size_t m_read;
+	alignas(64) std::atomic_size_t m_released;
+} ;
+
+
+} // namespace lmms
+
+#endif // LMMS_AUDIO_BUFFER_FIFO_H
@@ -26,6 +26,7 @@
 #ifndef LMMS_AUDIO_BUS_HANDLE_H
 #define LMMS_AUDIO_BUS_HANDLE_H
 
+#include <atomic>
 #include <memory>
 #include <QString>
 #include <QMutex>
@@ -35,6 +36,7 @@
 namespace lmms
 {
 
+class AudioTap;
 class EffectChain;
 class FloatModel;
 class BoolModel;
@@ -75,6 +77,9 @@ public:
 	EffectChain* effects() { return m_effects.get(); }
 	bool processEffects();
 
+	//! Copies the output into @p tap while processing, see StemExporter. Not real-time safe.
+	void setTap(AudioTap* tap);
+
 	// ThreadableJob stuff
 	void doProcessing() override;
 	bool requiresProcessing() const override { return true; }
@@ -82,6 +87,13 @@ public:
 	void addPlayHandle(PlayHandle* handle);
 	void removePlayHandle(PlayHandle* handle);
 
+	// dependency counting for the per-period processing graph, see
+	// AudioEngine::renderStageProcessing()
+	void resetDependencies();
+	void addDependency() { ++m_dependencies; }
+	std::size_t dependencies() const { return m_dependencies; }
+	void incrementDeps();
+
 private:
 	volatile bool m_bufferUsage;
 
@@ -101,6 +113,14 @@ private:
 	FloatModel* m_panningModel;
 	BoolModel* m_mutedModel;
 
+	// number of play handles which have to be processed before this bus handle
+	std::size_t m_dependencies;
+	std::atomic_size_t m_dependenciesMet;
+	// mixer channel this bus handle mixes into during the current period
+	mix_ch_t m_currentMixerChannel;
+
+	AudioTap* m_tap = nullptr;
+
 	friend class AudioEngine;
 	friend class AudioEngineWorkerThread;
 };
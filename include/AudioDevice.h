@@ -133,8 +133,6 @@ private:
 
 	QMutex m_devMutex;
 
-	SampleFrame* m_buffer;
-
 };
 
 } // namespace lmms
@@ -37,9 +37,10 @@
 #include "LmmsTypes.h"
 #include "SampleFrame.h"
 #include "LocklessList.h"
-#include "FifoBuffer.h"
+#include "AudioBufferFifo.h"
 #include "AudioEngineProfiler.h"
 #include "PlayHandle.h"
+#include "VoiceGovernor.h"
 
 
 namespace lmms
@@ -188,6 +189,11 @@ public:
 		return m_profiler.cpuLoad();
 	}
 
+	VoiceGovernor& voiceGovernor()
+	{
+		return m_voiceGovernor;
+	}
+
 	int detailLoad(const AudioEngineProfiler::DetailType type) const
 	{
 		return m_profiler.detailLoad(type);
@@ -277,7 +283,7 @@ signals:
 
 
 private:
-	using Fifo = FifoBuffer<SampleFrame*>;
+	using Fifo = AudioBufferFifo;
 
 	class fifoWriter : public QThread
 	{
@@ -293,8 +299,6 @@ private:
 		volatile bool m_writing;
 
 		void run() override;
-
-		void write(SampleFrame* buffer);
 	} ;
 
 
@@ -309,8 +313,7 @@ private:
 	MidiClient * tryMidiClients();
 
 	void renderStageNoteSetup();
-	void renderStageInstruments();
-	void renderStageEffects();
+	void renderStageProcessing();
 	void renderStageMix();
 
 	const SampleFrame* renderNextBuffer();
@@ -363,6 +366,7 @@ private:
 	fifoWriter * m_fifoWriter;
 
 	AudioEngineProfiler m_profiler;
+	VoiceGovernor m_voiceGovernor;
 
 	bool m_clearSignal;
 
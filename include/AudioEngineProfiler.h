@@ -27,10 +27,11 @@
 
 #include <array>
 #include <atomic>
-#include <QFile>
+#include <QString>
 
 #include "LmmsTypes.h"
 #include "MicroTimer.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -39,11 +40,12 @@ class AudioEngineProfiler
 {
 public:
 	AudioEngineProfiler();
-	~AudioEngineProfiler() = default;
+	~AudioEngineProfiler();
 
 	void startPeriod()
 	{
 		m_periodTimer.reset();
+		m_periodBegin = TraceRecorder::isRecording(TraceRecorder::Category::Period) ? TraceRecorder::now() : 0;
 	}
 
 	void finishPeriod( sample_rate_t sampleRate, fpp_t framesPerPeriod );
@@ -53,12 +55,23 @@ public:
 		return m_cpuLoad;
 	}
 
+	//! Writes the duration of each period to the file, written by TraceRecorder
 	void setOutputFile( const QString& outputFile );
+	//! Writes a Chrome trace of all jobs to the file, see TraceRecorder
+	void setTraceFile(const QString& traceFile);
+
+	//! Whether a period log or a trace is being written
+	bool isProfiling() const
+	{
+		return !m_outputFile.isEmpty() || !m_traceFile.isEmpty();
+	}
+
+	//! Table of the CpuMeter of every mixer channel, instrument and effect
+	static QString cpuMeterReport();
 
 	enum class DetailType {
 		NoteSetup,
-		Instruments,
-		Effects,
+		Processing,
 		Mixing,
 		Count
 	};
@@ -70,12 +83,25 @@ public:
 		return m_detailLoad[static_cast<std::size_t>(type)].load(std::memory_order_relaxed);
 	}
 
+	//! Unaveraged time of the last finished period in microseconds, for use by the audio thread
+	int periodTime() const
+	{
+		return m_periodTime;
+	}
+
+	//! Unaveraged time of the given stage in the last period in microseconds
+	int detailTime(const DetailType type) const
+	{
+		return m_detailTime[static_cast<std::size_t>(type)];
+	}
+
 	class Probe
 	{
 	public:
 		Probe(AudioEngineProfiler& profiler, AudioEngineProfiler::DetailType type)
 			: m_profiler(profiler)
 			, m_type(type)
+			, m_span(profiler.m_detailNames[static_cast<std::size_t>(type)], TraceRecorder::Category::Stage)
 		{
 			profiler.startDetail(type);
 		}
@@ -87,6 +113,7 @@ public:
 	private:
 		AudioEngineProfiler &m_profiler;
 		const AudioEngineProfiler::DetailType m_type;
+		const TraceRecorder::Span m_span;
 	};
 
 private:
@@ -96,14 +123,20 @@ private:
 		m_detailTime[static_cast<std::size_t>(type)] = m_detailTimer[static_cast<std::size_t>(type)].elapsed();
 	}
 
+	void restartTrace();
+
 	MicroTimer m_periodTimer;
+	int m_periodTime = 0;
+	std::uint64_t m_periodBegin = 0;
 	std::atomic<float> m_cpuLoad;
-	QFile m_outputFile;
+	QString m_outputFile;
+	QString m_traceFile;
 
 	// Use arrays to avoid dynamic allocations in realtime code
 	std::array<MicroTimer, DetailCount> m_detailTimer;
 	std::array<int, DetailCount> m_detailTime{0};
 	std::array<std::atomic<float>, DetailCount> m_detailLoad{0};
+	std::array<std::uint32_t, DetailCount> m_detailNames{};
 };
 
 } // namespace lmms
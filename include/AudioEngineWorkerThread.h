@@ -28,6 +28,10 @@
 #include <QThread>
 
 #include <atomic>
+#include <memory>
+#include <vector>
+
+#include "WorkStealingDeque.h"
 
 class QWaitCondition;
 
@@ -51,29 +55,55 @@ public:
 			Dynamic	// jobs can be added while processing queue
 		} ;
 
+		enum class SchedulingMode
+		{
+			Shared,		// one job array which is scanned by all threads
+			WorkStealing	// one deque per thread, idle threads steal from the others
+		} ;
+
 		static constexpr size_t JOB_QUEUE_SIZE = 8192;
 
 		JobQueue() :
 			m_items(),
 			m_writeIndex( 0 ),
 			m_itemsDone( 0 ),
-			m_opMode( OperationMode::Static )
+			m_opMode( OperationMode::Static ),
+			m_schedulingMode( SchedulingMode::Shared )
 		{
 			std::fill(m_items, m_items + JOB_QUEUE_SIZE, nullptr);
 		}
 
+		//! Must be called before any worker thread is started
+		void setup( SchedulingMode _mode, size_t _numThreads );
+
+		SchedulingMode schedulingMode() const
+		{
+			return m_schedulingMode;
+		}
+
 		void reset( OperationMode _opMode );
 
-		void addJob( ThreadableJob * _job );
+		bool addJob( ThreadableJob * _job );
 
 		void run();
 		void wait();
 
 	private:
+		using Deque = WorkStealingDeque<ThreadableJob, JOB_QUEUE_SIZE>;
+
+		void runShared();
+		void runWorkStealing();
+		Deque & ownDeque();
+		ThreadableJob * steal();
+
 		std::atomic<ThreadableJob*> m_items[JOB_QUEUE_SIZE];
 		std::atomic_size_t m_writeIndex;
 		std::atomic_size_t m_itemsDone;
 		OperationMode m_opMode;
+		SchedulingMode m_schedulingMode;
+		// one deque per worker thread, the last one belongs to the thread
+		// calling startAndWaitForJobs()
+		std::vector<std::unique_ptr<Deque>> m_deques;
 	} ;
 
 
@@ -82,15 +112,21 @@ public:
 
 	virtual void quit();
 
+	static void setupJobQueue( JobQueue::SchedulingMode _mode, size_t _numThreads )
+	{
+		globalJobQueue.setup( _mode, _numThreads );
+	}
+
 	static void resetJobQueue( JobQueue::OperationMode _opMode =
 													JobQueue::OperationMode::Static )
 	{
 		globalJobQueue.reset( _opMode );
 	}
 
-	static void addJob( ThreadableJob * _job )
+	//! Returns false if the job did not require processing and was not queued
+	static bool addJob( ThreadableJob * _job )
 	{
-		globalJobQueue.addJob( _job );
+		return globalJobQueue.addJob( _job );
 	}
 
 	// a convenient helper function allowing to pass a container with pointers
@@ -114,9 +150,12 @@ private:
 
 	static JobQueue globalJobQueue;
 	static QWaitCondition * queueReadyWaitCond;
+	// incremented for each batch of jobs, work-stealing workers park on it
+	static std::atomic_uint queueReadyGeneration;
 	static QList<AudioEngineWorkerThread *> workerThreads;
 
 	volatile bool m_quit;
+	size_t m_index;
 } ;
 
 } // namespace lmms
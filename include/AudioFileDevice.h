@@ -26,6 +26,12 @@
 #ifndef LMMS_AUDIO_FILE_DEVICE_H
 #define LMMS_AUDIO_FILE_DEVICE_H
 
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <QFile>
 
 #include "AudioDevice.h"
@@ -34,6 +40,12 @@
 namespace lmms
 {
 
+/**
+	Rendered frames are not encoded by the thread which renders them. They are
+	collected into a ring of large blocks, and each full block is encoded by an
+	encoder thread of the device, so the render thread only copies frames. It
+	only waits for the encoder if all blocks are full.
+*/
 class AudioFileDevice : public AudioDevice
 {
 public:
@@ -49,8 +61,21 @@ public:
 
 	OutputSettings const & getOutputSettings() const { return m_outputSettings; }
 
+	//! Encodes audio which was not rendered for this device, e.g. a stem
+	void writeFrames(const SampleFrame* buffer, const fpp_t frames) { writeBuffer(buffer, frames); }
+
+	//! Frames encoded at once
+	static constexpr f_cnt_t BlockFrames = 65536;
+
 
 protected:
+	//! Encodes a block of frames, called by the encoder thread
+	virtual void encodeBuffer(const SampleFrame* buffer, const f_cnt_t frames) = 0;
+
+	//! Encodes what is left and stops the encoder thread. Subclasses must call
+	//! this in their destructor, before they finish the file.
+	void finishWriting();
+
 	int writeData( const void* data, int len );
 
 	inline bool outputFileOpened() const
@@ -64,8 +89,30 @@ protected:
 	}
 
 private:
+	//! Copies the frames into the ring, called by the render thread
+	void writeBuffer(const SampleFrame* buffer, const fpp_t frames) final;
+	//! Hands the block being filled to the encoder thread
+	void queueBlock();
+	void runEncoder();
+
+	static constexpr std::size_t NumBlocks = 3;
+
 	QFile m_outputFile;
 	OutputSettings m_outputSettings;
+
+	// allocated on the first write
+	std::vector<SampleFrame> m_ring;
+	std::array<f_cnt_t, NumBlocks> m_blockFrames = {};
+	std::size_t m_writeBlock = 0;
+	std::size_t m_readBlock = 0;
+	std::size_t m_queuedBlocks = 0;
+	f_cnt_t m_filled = 0;
+
+	std::mutex m_mutex;
+	std::condition_variable m_blockQueued;
+	std::condition_variable m_blockEncoded;
+	bool m_stopEncoder = false;
+	std::thread m_encoder;
 } ;
 
 using AudioFileDeviceInstantiaton
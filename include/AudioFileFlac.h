@@ -27,6 +27,8 @@
 
 #include "lmmsconfig.h"
 
+#include <vector>
+
 #include "AudioFileDevice.h"
 #include <sndfile.h>
 
@@ -65,7 +67,11 @@ private:
 	SF_INFO  m_sfinfo;
 	SNDFILE* m_sf;
 
-	void writeBuffer(const SampleFrame* _ab, fpp_t const frames) override;
+	// reused for every block
+	std::vector<sample_t> m_floatBuffer;
+	std::vector<int_sample_t> m_intBuffer;
+
+	void encodeBuffer(const SampleFrame* _ab, f_cnt_t const frames) override;
 
 	bool startEncoding();
 	void finishEncoding();
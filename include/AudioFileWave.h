@@ -26,6 +26,8 @@
 #ifndef LMMS_AUDIO_FILE_WAVE_H
 #define LMMS_AUDIO_FILE_WAVE_H
 
+#include <vector>
+
 #include "lmmsconfig.h"
 #include "AudioFileDevice.h"
 
@@ -56,7 +58,7 @@ public:
 
 
 private:
-	void writeBuffer(const SampleFrame* _ab, const fpp_t _frames) override;
+	void encodeBuffer(const SampleFrame* _ab, const f_cnt_t _frames) override;
 
 	bool startEncoding();
 	void finishEncoding();
@@ -64,6 +66,10 @@ private:
 private:
 	SF_INFO m_si;
 	SNDFILE * m_sf;
+
+	// reused for every block
+	std::vector<float> m_floatBuffer;
+	std::vector<int_sample_t> m_intBuffer;
 } ;
 
 
@@ -0,0 +1,81 @@
+/*
+ * AudioTap.h - copy of the output of an audio bus handle or mixer channel
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_AUDIO_TAP_H
+#define LMMS_AUDIO_TAP_H
+
+#include <algorithm>
+#include <vector>
+
+#include "MixHelpers.h"
+#include "SampleFrame.h"
+
+namespace lmms
+{
+
+/**
+	@brief Holds what an @ref AudioBusHandle or @ref MixerChannel output in the current period
+
+	The processing job of the source writes the period, the thread driving the
+	audio engine takes it once all jobs are done. Sources which did not write
+	anything, e.g. because they are muted, produce silence, so a tap always
+	yields exactly one period per period. See @ref StemExporter.
+*/
+class AudioTap
+{
+public:
+	explicit AudioTap(fpp_t framesPerPeriod) :
+		m_period(framesPerPeriod)
+	{
+	}
+
+	//! Called by the processing job of the source
+	void write(const SampleFrame* buffer, float gainLeft, float gainRight, fpp_t frames)
+	{
+		std::copy_n(buffer, frames, m_period.data());
+		if (gainLeft != 1.0f || gainRight != 1.0f)
+		{
+			MixHelpers::multiplyStereo(m_period.data(), gainLeft, gainRight, frames);
+		}
+		m_written = true;
+	}
+
+	//! Returns the output of the finished period and starts the next one
+	const SampleFrame* takePeriod()
+	{
+		if (!m_written) { zeroSampleFrames(m_period.data(), m_period.size()); }
+		m_written = false;
+		return m_period.data();
+	}
+
+	fpp_t framesPerPeriod() const { return m_period.size(); }
+
+private:
+	std::vector<SampleFrame> m_period;
+	bool m_written = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_AUDIO_TAP_H
@@ -212,6 +212,13 @@ public:
 	void setInitValue( const float value );
 
 	void setAutomatedValue( const float value );
+	/**
+		@brief Sets sample-exact automation for frames [offset, offset + frames) of the current period
+
+		The values are unscaled, like the ones passed to setAutomatedValue().
+		valueBuffer() returns them for the rest of the period, value() the last one.
+	*/
+	void setAutomatedValues(const float* values, f_cnt_t offset, f_cnt_t frames);
 	void setValue( const float value );
 
 	void incValue( int steps )
@@ -311,6 +318,12 @@ public:
 		s_periodCounter = 0;
 	}
 
+	//! Returns the number of periods rendered so far, constant while a period is rendered
+	static long periodCounter()
+	{
+		return s_periodCounter;
+	}
+
 	bool useControllerValue()
 	{
 		return m_useControllerValue;
@@ -169,6 +169,9 @@ public:
 	float valueAt( const TimePos & _time ) const;
 	float *valuesAfter( const TimePos & _time ) const;
 
+	//! Renders the values at the (fractional) ticks time, time + step, ... into values
+	void valuesAt(double time, double step, float* values, f_cnt_t frames) const;
+
 	QString name() const;
 
 	// settings-management
@@ -214,6 +217,7 @@ private:
 	void generateTangents();
 	void generateTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
+	void segmentValues(timeMap::const_iterator v, double offset, double step, float* values, f_cnt_t frames) const;
 
 	/**
 	 * @brief
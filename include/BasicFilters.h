@@ -33,16 +33,41 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <numbers>
 
 #include "lmms_constants.h"
 #include "LmmsTypes.h"
+#include "SampleFrame.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 
 namespace lmms
 {
 
+#ifdef __SSE2__
+namespace detail
+{
+
+// A stereo frame is moved as the lower half of a vector. Going through __m64, which may alias any type unlike
+// double, keeps the loads and stores of float data legal.
+inline __m128 loadStereo( const float* p )
+{
+	return _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( p ) );
+}
+
+inline void storeStereo( float* p, __m128 v )
+{
+	_mm_storel_pi( reinterpret_cast<__m64*>( p ), v );
+}
+
+} // namespace detail
+#endif
+
 template<ch_cnt_t CHANNELS=DEFAULT_CHANNELS> class BasicFilters;
 
 template<ch_cnt_t CHANNELS>
@@ -127,6 +152,48 @@ public:
 		return y;
 	}
 
+	//! Filters `frames` stereo frames from `in` into `out`, which may be the same buffer
+	inline void process( const SampleFrame* in, SampleFrame* out, fpp_t frames ) requires ( CHANNELS == 2 )
+	{
+#ifdef __SSE2__
+		// both channels side by side, in the same order of operations as update()
+		const __m128d a0 = _mm_set1_pd( m_a0 );
+		const __m128d a1 = _mm_set1_pd( m_a1 );
+		const __m128d a2 = _mm_set1_pd( m_a2 );
+		const __m128d b1 = _mm_set1_pd( m_b1 );
+		const __m128d b2 = _mm_set1_pd( m_b2 );
+		const __m128d b3 = _mm_set1_pd( m_b3 );
+		const __m128d b4 = _mm_set1_pd( m_b4 );
+		__m128d z1 = _mm_loadu_pd( m_z1.data() );
+		__m128d z2 = _mm_loadu_pd( m_z2.data() );
+		__m128d z3 = _mm_loadu_pd( m_z3.data() );
+		__m128d z4 = _mm_loadu_pd( m_z4.data() );
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const __m128d s = _mm_cvtps_pd( detail::loadStereo( in[f].data() ) );
+			const __m128d x = _mm_sub_pd( _mm_sub_pd( _mm_sub_pd( _mm_sub_pd( s, _mm_mul_pd( z1, b1 ) ),
+				_mm_mul_pd( z2, b2 ) ), _mm_mul_pd( z3, b3 ) ), _mm_mul_pd( z4, b4 ) );
+			const __m128d y = _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( a0, x ),
+				_mm_mul_pd( z1, a1 ) ), _mm_mul_pd( z2, a2 ) ), _mm_mul_pd( z3, a1 ) ), _mm_mul_pd( z4, a0 ) );
+			z4 = z3;
+			z3 = z2;
+			z2 = z1;
+			z1 = x;
+			detail::storeStereo( out[f].data(), _mm_cvtpd_ps( y ) );
+		}
+		_mm_storeu_pd( m_z1.data(), z1 );
+		_mm_storeu_pd( m_z2.data(), z2 );
+		_mm_storeu_pd( m_z3.data(), z3 );
+		_mm_storeu_pd( m_z4.data(), z4 );
+#else
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			out[f][0] = update( in[f][0], 0 );
+			out[f][1] = update( in[f][1], 1 );
+		}
+#endif
+	}
+
 private:
 	float m_sampleRate;
 	double m_wc4;
@@ -178,6 +245,100 @@ public:
 		m_z2[ch] = m_b2 * in - m_a2 * out;
 		return out;
 	}
+
+	//! Filters `frames` stereo frames from `in` into `out`, which may be the same buffer
+	inline void process( const SampleFrame* in, SampleFrame* out, fpp_t frames ) requires ( CHANNELS == 2 )
+	{
+#ifdef __SSE2__
+		// both channels in the lower lanes, in the same order of operations as update()
+		const __m128 a1 = _mm_set1_ps( m_a1 );
+		const __m128 a2 = _mm_set1_ps( m_a2 );
+		const __m128 b0 = _mm_set1_ps( m_b0 );
+		const __m128 b1 = _mm_set1_ps( m_b1 );
+		const __m128 b2 = _mm_set1_ps( m_b2 );
+		__m128 z1 = _mm_setr_ps( m_z1[0], m_z1[1], 0.0f, 0.0f );
+		__m128 z2 = _mm_setr_ps( m_z2[0], m_z2[1], 0.0f, 0.0f );
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const __m128 x = detail::loadStereo( in[f].data() );
+			const __m128 y = _mm_add_ps( z1, _mm_mul_ps( b0, x ) );
+			z1 = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( b1, x ), z2 ), _mm_mul_ps( a1, y ) );
+			z2 = _mm_sub_ps( _mm_mul_ps( b2, x ), _mm_mul_ps( a2, y ) );
+			detail::storeStereo( out[f].data(), y );
+		}
+		detail::storeStereo( m_z1, z1 );
+		detail::storeStereo( m_z2, z2 );
+#else
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			out[f][0] = update( in[f][0], 0 );
+			out[f][1] = update( in[f][1], 1 );
+		}
+#endif
+	}
+
+	//! Like process(), but the coefficients move linearly from those of `from` to the
+	//! current ones, which they reach `steps` frames after the first frame
+	inline void process( const SampleFrame* in, SampleFrame* out, fpp_t frames,
+						const BiQuad& from, fpp_t steps ) requires ( CHANNELS == 2 )
+	{
+		if( steps == 0 )
+		{
+			process( in, out, frames );
+			return;
+		}
+
+		const float t = 1.0f / steps;
+#ifdef __SSE2__
+		__m128 a1 = _mm_set1_ps( from.m_a1 );
+		__m128 a2 = _mm_set1_ps( from.m_a2 );
+		__m128 b0 = _mm_set1_ps( from.m_b0 );
+		__m128 b1 = _mm_set1_ps( from.m_b1 );
+		__m128 b2 = _mm_set1_ps( from.m_b2 );
+		const __m128 da1 = _mm_set1_ps( ( m_a1 - from.m_a1 ) * t );
+		const __m128 da2 = _mm_set1_ps( ( m_a2 - from.m_a2 ) * t );
+		const __m128 db0 = _mm_set1_ps( ( m_b0 - from.m_b0 ) * t );
+		const __m128 db1 = _mm_set1_ps( ( m_b1 - from.m_b1 ) * t );
+		const __m128 db2 = _mm_set1_ps( ( m_b2 - from.m_b2 ) * t );
+		__m128 z1 = _mm_setr_ps( m_z1[0], m_z1[1], 0.0f, 0.0f );
+		__m128 z2 = _mm_setr_ps( m_z2[0], m_z2[1], 0.0f, 0.0f );
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const __m128 x = detail::loadStereo( in[f].data() );
+			const __m128 y = _mm_add_ps( z1, _mm_mul_ps( b0, x ) );
+			z1 = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( b1, x ), z2 ), _mm_mul_ps( a1, y ) );
+			z2 = _mm_sub_ps( _mm_mul_ps( b2, x ), _mm_mul_ps( a2, y ) );
+			detail::storeStereo( out[f].data(), y );
+
+			a1 = _mm_add_ps( a1, da1 );
+			a2 = _mm_add_ps( a2, da2 );
+			b0 = _mm_add_ps( b0, db0 );
+			b1 = _mm_add_ps( b1, db1 );
+			b2 = _mm_add_ps( b2, db2 );
+		}
+		detail::storeStereo( m_z1, z1 );
+		detail::storeStereo( m_z2, z2 );
+#else
+		float a1 = from.m_a1, a2 = from.m_a2, b0 = from.m_b0, b1 = from.m_b1, b2 = from.m_b2;
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			for( ch_cnt_t ch = 0; ch < 2; ++ch )
+			{
+				const float x = in[f][ch];
+				const float y = m_z1[ch] + b0 * x;
+				m_z1[ch] = b1 * x + m_z2[ch] - a1 * y;
+				m_z2[ch] = b2 * x - a2 * y;
+				out[f][ch] = y;
+			}
+
+			a1 += ( m_a1 - from.m_a1 ) * t;
+			a2 += ( m_a2 - from.m_a2 ) * t;
+			b0 += ( m_b0 - from.m_b0 ) * t;
+			b1 += ( m_b1 - from.m_b1 ) * t;
+			b2 += ( m_b2 - from.m_b2 ) * t;
+		}
+#endif
+	}
 private:
 	float m_a1, m_a2, m_b0, m_b1, m_b2;
 	float m_z1 [CHANNELS], m_z2 [CHANNELS];
@@ -212,6 +373,35 @@ public:
 		if (std::abs(s) < F_EPSILON && std::abs(m_z1[ch]) < F_EPSILON) { return 0.0f; }
 		return m_z1[ch] = s * m_a0 + m_z1[ch] * m_b1;
 	}
+
+	//! Filters `frames` stereo frames from `in` into `out`, which may be the same buffer
+	inline void process( const SampleFrame* in, SampleFrame* out, fpp_t frames ) requires ( CHANNELS == 2 )
+	{
+#ifdef __SSE2__
+		const __m128 a0 = _mm_set1_ps( m_a0 );
+		const __m128 b1 = _mm_set1_ps( m_b1 );
+		const __m128 epsilon = _mm_set1_ps( F_EPSILON );
+		const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+		__m128 z1 = _mm_setr_ps( m_z1[0], m_z1[1], 0.0f, 0.0f );
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const __m128 x = detail::loadStereo( in[f].data() );
+			// like update(), a channel which is silent outputs zero and keeps its state
+			const __m128 silent = _mm_and_ps( _mm_cmplt_ps( _mm_and_ps( x, absMask ), epsilon ),
+				_mm_cmplt_ps( _mm_and_ps( z1, absMask ), epsilon ) );
+			const __m128 y = _mm_add_ps( _mm_mul_ps( x, a0 ), _mm_mul_ps( z1, b1 ) );
+			z1 = _mm_or_ps( _mm_and_ps( silent, z1 ), _mm_andnot_ps( silent, y ) );
+			detail::storeStereo( out[f].data(), _mm_andnot_ps( silent, y ) );
+		}
+		detail::storeStereo( m_z1, z1 );
+#else
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			out[f][0] = update( in[f][0], 0 );
+			out[f][1] = update( in[f][1], 1 );
+		}
+#endif
+	}
 	
 private:
 	float m_a0, m_b1; 
@@ -702,6 +892,64 @@ public:
 	}
 
 
+	//! Whether the filter type is a biquad, whose coefficients processInterpolated() can interpolate
+	inline bool isBiQuad() const
+	{
+		switch( m_type )
+		{
+			case FilterType::LowPass:
+			case FilterType::HiPass:
+			case FilterType::BandPass_CSG:
+			case FilterType::BandPass_CZPG:
+			case FilterType::Notch:
+			case FilterType::AllPass:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+
+	//! Filters `frames` stereo frames from `in` into `out`, which may be the same buffer
+	inline void process( const SampleFrame* in, SampleFrame* out, fpp_t frames ) requires ( CHANNELS == 2 )
+	{
+		if( isBiQuad() )
+		{
+			// update() runs these types through m_biQuad and the sub filter only
+			m_biQuad.process( in, out, frames );
+			if( m_doubleFilter )
+			{
+				m_subFilter->process( out, out, frames );
+			}
+			return;
+		}
+
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			out[f][0] = update( in[f][0], 0 );
+			out[f][1] = update( in[f][1], 1 );
+		}
+	}
+
+
+	//! Sets the coefficients like calcFilterCoeffs( _freq, _q ) and filters like process(), but the
+	//! coefficients move linearly from the old ones and reach the new ones `steps` frames after the
+	//! first frame. Only for the biquad types, see isBiQuad()
+	inline void processInterpolated( const SampleFrame* in, SampleFrame* out, fpp_t frames, fpp_t steps,
+						float _freq, float _q ) requires ( CHANNELS == 2 )
+	{
+		assert( isBiQuad() );
+		const auto from = m_biQuad;
+		calcFilterCoeffs( _freq, _q );
+		m_biQuad.process( in, out, frames, from, steps );
+		if( m_doubleFilter )
+		{
+			// the sub filter always has the same coefficients
+			m_subFilter->m_biQuad.process( out, out, frames, from, steps );
+		}
+	}
+
+
 	inline void calcFilterCoeffs( float _freq, float _q )
 	{
 		using namespace std::numbers;
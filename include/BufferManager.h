@@ -26,6 +26,8 @@
 #ifndef LMMS_BUFFER_MANAGER_H
 #define LMMS_BUFFER_MANAGER_H
 
+#include <cstddef>
+
 #include "lmms_export.h"
 #include "LmmsTypes.h"
 
@@ -34,13 +36,35 @@ namespace lmms
 
 class SampleFrame;
 
+/**
+	@brief Pool of period-sized audio buffers
+
+	Buffers are taken from pre-allocated, cache-line aligned lockless pools, so
+	acquire() and release() are real-time safe. When the pool is running low, a
+	background thread adds another pool. Only if that could not keep up, the
+	buffer is allocated from the heap, which is counted as a miss.
+*/
 class LMMS_EXPORT BufferManager
 {
 public:
+	struct Statistics
+	{
+		std::size_t hits;
+		std::size_t misses;
+		std::size_t inUse;
+		std::size_t highWater;
+		std::size_t capacity;
+	};
+
 	static void init( fpp_t fpp );
 	static SampleFrame* acquire();
 	static void release( SampleFrame* buf );
 
+	//! Grow the pool to hold at least @p buffers buffers. Not real-time safe.
+	static void reserve( std::size_t buffers );
+
+	static Statistics statistics();
+
 private:
 	static fpp_t s_framesPerPeriod;
 };
@@ -85,6 +85,12 @@ public:
 		return m_dataDir;
 	}
 
+	//! The configuration file which was loaded
+	const QString & rcFile() const
+	{
+		return m_lmmsRcFile;
+	}
+
 	QString factoryProjectsDir() const
 	{
 		return dataDir() + PROJECTS_PATH;
@@ -0,0 +1,118 @@
+/*
+ * CpuMeter.h - CPU time accounting for instruments, effects and mixer channels
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_CPU_METER_H
+#define LMMS_CPU_METER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "lmms_export.h"
+#include "TraceRecorder.h"
+
+namespace lmms
+{
+
+/**
+	@brief Time one instrument, effect or mixer channel spends processing
+
+	The time measured within a period is added up, possibly from several
+	threads at once, and turned into a load at the end of the period by
+	finishPeriod(): the percentage of the time the period may take. All meters
+	are disabled by default, then measuring costs one relaxed atomic load.
+*/
+class LMMS_EXPORT CpuMeter
+{
+public:
+	CpuMeter();
+	~CpuMeter();
+
+	CpuMeter(const CpuMeter&) = delete;
+	CpuMeter& operator=(const CpuMeter&) = delete;
+
+	static bool isEnabled()
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+
+	//! Enabling resets all meters
+	static void setEnabled(bool enabled);
+
+	//! Real-time safe, may be called by several threads at once
+	void add(std::uint64_t nanoseconds)
+	{
+		m_periodTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+	}
+
+	//! Load in percent, averaged over the last periods
+	float averageLoad() const { return m_averageLoad.load(std::memory_order_relaxed); }
+	//! Highest load of a single period since the meters were enabled or reset
+	float worstLoad() const { return m_worstLoad.load(std::memory_order_relaxed); }
+	//! Time measured since the meters were enabled or reset, in microseconds
+	std::uint64_t totalTime() const { return m_totalTime.load(std::memory_order_relaxed) / 1000; }
+
+	//! Resets all meters. Not real-time safe.
+	static void resetAll();
+
+	//! Called by the audio engine at the end of each period
+	static void finishPeriod(std::uint64_t periodLimitNanoseconds);
+
+	//! Adds the lifetime of the object to the meter
+	class Scope
+	{
+	public:
+		explicit Scope(CpuMeter& meter) :
+			m_meter(meter),
+			m_begin(isEnabled() ? TraceRecorder::now() : 0)
+		{
+		}
+
+		~Scope()
+		{
+			if (m_begin != 0) { m_meter.add(TraceRecorder::now() - m_begin); }
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		CpuMeter& m_meter;
+		const std::uint64_t m_begin;
+	};
+
+private:
+	void reset();
+	void fold(std::uint64_t periodLimitNanoseconds, int periods);
+
+	std::atomic<std::uint64_t> m_periodTime = 0;
+	std::atomic<std::uint64_t> m_totalTime = 0;
+	std::atomic<float> m_averageLoad = 0.f;
+	std::atomic<float> m_worstLoad = 0.f;
+
+	static std::atomic_bool s_enabled;
+};
+
+} // namespace lmms
+
+#endif // LMMS_CPU_METER_H
@@ -30,9 +30,11 @@
 
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
+#include "CpuMeter.h"
 #include "Engine.h"
 #include "Plugin.h"
 #include "TempoSyncKnobModel.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -141,6 +143,11 @@ public:
 		return m_parent;
 	}
 
+	const CpuMeter& cpuMeter() const
+	{
+		return m_cpuMeter;
+	}
+
 	virtual EffectControls * controls() = 0;
 
 	static Effect * instantiate( const QString & _plugin_name,
@@ -202,6 +209,10 @@ private:
 
 	bool m_autoQuitEnabled = false;
 
+	//! Id of the name of the effect in traces
+	std::uint32_t m_traceName = TraceRecorder::Unnamed;
+	CpuMeter m_cpuMeter;
+
 	friend class gui::EffectView;
 	friend class EffectChain;
 
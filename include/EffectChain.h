@@ -66,6 +66,16 @@ public:
 	bool processAudioBuffer( SampleFrame* _buf, const fpp_t _frames, bool hasInputNoise );
 	void startRunning();
 
+	bool isEnabled() const
+	{
+		return m_enabledModel.value();
+	}
+
+	const std::vector<Effect*>& effects() const
+	{
+		return m_effects;
+	}
+
 	void clear();
 
 
@@ -25,7 +25,9 @@
 #ifndef LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 #define LMMS_ENVELOPE_AND_LFO_PARAMETERS_H
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "JournallingObject.h"
 #include "AutomatableModel.h"
@@ -103,7 +105,7 @@ public:
 
 	inline bool isUsed() const
 	{
-		return m_used;
+		return m_used.load(std::memory_order_relaxed);
 	}
 
 
@@ -116,12 +118,12 @@ public:
 
 	inline f_cnt_t PAHD_Frames() const
 	{
-		return m_pahdFrames;
+		return m_pahdFrames.load(std::memory_order_relaxed);
 	}
 
 	inline f_cnt_t releaseFrames() const
 	{
-		return m_rFrames;
+		return m_releaseFrames.load(std::memory_order_relaxed);
 	}
 
 	// Envelope
@@ -136,9 +138,9 @@ public:
 
 
 	// LFO
-	inline f_cnt_t getLfoPredelayFrames() const { return m_lfoPredelayFrames; }
-	inline f_cnt_t getLfoAttackFrames() const { return m_lfoAttackFrames; }
-	inline f_cnt_t getLfoOscillationFrames() const { return m_lfoOscillationFrames; }
+	inline f_cnt_t getLfoPredelayFrames() const { return m_lfoPredelayFrames.load(std::memory_order_relaxed); }
+	inline f_cnt_t getLfoAttackFrames() const { return m_lfoAttackFrames.load(std::memory_order_relaxed); }
+	inline f_cnt_t getLfoOscillationFrames() const { return m_lfoOscillationFrames.load(std::memory_order_relaxed); }
 
 	const FloatModel& getLfoAmountModel() const { return m_lfoAmountModel; }
 	FloatModel& getLfoAmountModel() { return m_lfoAmountModel; }
@@ -146,20 +148,56 @@ public:
 	const BoolModel& getX100Model() const { return m_x100Model; }
 	const IntModel& getLfoWaveModel() const { return m_lfoWaveModel; }
 	std::shared_ptr<const SampleBuffer> getLfoUserWave() const { return m_userWave; }
+	void setLfoUserWave(std::shared_ptr<const SampleBuffer> wave);
 
 public slots:
 	void updateSampleVars();
 
 
-protected:
-	void fillLfoLevel( float * _buf, f_cnt_t _frame, const fpp_t _frames );
+private:
+	/**
+		Everything fillLevel() needs, computed from the models by updateSampleVars().
+
+		A snapshot is never changed once it is published, so the voices can render from it without locking while
+		the GUI or automation publish the next one. A replaced snapshot is retired and deleted by the audio engine
+		after the end of the period, when no voice can be rendering from it anymore.
+	*/
+	struct Snapshot
+	{
+		//! Pre-delay, attack, hold and decay, so its size is the number of frames until the sustain
+		std::vector<sample_t> pahdEnv;
+		//! Release, relative to the level at the beginning of the release
+		std::vector<sample_t> rEnv;
+		float sustainLevel = 0.0f;
+		bool controlEnvAmount = false;
+
+		f_cnt_t lfoPredelayFrames = 0;
+		f_cnt_t lfoAttackFrames = 0;
+		f_cnt_t lfoOscillationFrames = 1;
+		float lfoAmount = 0.0f;
+		bool lfoAmountIsZero = true;
+		LfoShape lfoShape = LfoShape::SineWave;
+		std::shared_ptr<const SampleBuffer> userWave;
+	};
 
+	void fillLfoLevel( const Snapshot& snapshot, float * _buf, f_cnt_t _frame, const fpp_t _frames );
+	void deleteRetiredSnapshots();
 
-private:
 	static LfoInstances * s_lfoInstances;
-	bool m_used;
+	std::atomic<bool> m_used;
 
+	//! Serialises updateSampleVars(), the voices never take it
 	QMutex m_paramMutex;
+	std::atomic<const Snapshot*> m_snapshot;
+	//! Replaced snapshots, deleted by deleteRetiredSnapshots() between the periods
+	std::vector<const Snapshot*> m_retiredSnapshots;
+
+	// the frame counts of the current snapshot, for readers outside of the periods like the GUI
+	std::atomic<f_cnt_t> m_pahdFrames;
+	std::atomic<f_cnt_t> m_releaseFrames;
+	std::atomic<f_cnt_t> m_lfoPredelayFrames;
+	std::atomic<f_cnt_t> m_lfoAttackFrames;
+	std::atomic<f_cnt_t> m_lfoOscillationFrames;
 
 	FloatModel m_predelayModel;
 	FloatModel m_attackModel;
@@ -169,16 +207,7 @@ private:
 	FloatModel m_releaseModel;
 	FloatModel m_amountModel;
 
-	float  m_sustainLevel;
-	float  m_amount;
 	float  m_valueForZeroAmount;
-	float  m_amountAdd;
-	f_cnt_t m_pahdFrames;
-	f_cnt_t m_rFrames;
-	sample_t * m_pahdEnv;
-	sample_t * m_rEnv;
-	f_cnt_t m_pahdBufSize;
-	f_cnt_t m_rBufSize;
 
 
 	FloatModel m_lfoPredelayModel;
@@ -191,20 +220,16 @@ private:
 	BoolModel m_controlEnvAmountModel;
 
 
-	f_cnt_t m_lfoPredelayFrames;
-	f_cnt_t m_lfoAttackFrames;
-	f_cnt_t m_lfoOscillationFrames;
+	// only touched by the thread driving the audio engine, between the periods
 	f_cnt_t m_lfoFrame;
-	float m_lfoAmount;
-	bool m_lfoAmountIsZero;
+	//! The LFO shape of the current period, without the LFO amount
 	sample_t * m_lfoShapeData;
 	sample_t m_random;
-	bool m_bad_lfoShapeData;
 	std::shared_ptr<const SampleBuffer> m_userWave = SampleBuffer::emptyBuffer();
 
 	constexpr static auto NumLfoShapes = static_cast<std::size_t>(LfoShape::Count);
 
-	sample_t lfoShapeSample( fpp_t _frame_offset );
+	sample_t lfoShapeSample( const Snapshot& snapshot, fpp_t _frame_offset );
 	void updateLfoShapeData();
 
 
@@ -28,6 +28,7 @@
 
 #include <QString>
 
+#include "CpuMeter.h"
 #include "Flags.h"
 #include "lmms_export.h"
 #include "LmmsTypes.h"
@@ -158,6 +159,12 @@ public:
 		return m_instrumentTrack;
 	}
 
+	//! Time spent in play() and playNote()
+	CpuMeter& cpuMeter()
+	{
+		return m_cpuMeter;
+	}
+
 
 protected:
 	// fade in to prevent clicks
@@ -174,6 +181,7 @@ protected:
 private:
 	InstrumentTrack * m_instrumentTrack;
 	Flags m_flags;
+	CpuMeter m_cpuMeter;
 };
 
 
@@ -0,0 +1,117 @@
+/*
+ * IntervalIndex.h - static interval tree for overlap queries
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_INTERVAL_INDEX_H
+#define LMMS_INTERVAL_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace lmms
+{
+
+/**
+	@brief Sorted array of closed intervals [start, end] with an implicit interval tree on top
+
+	The array, sorted by start, is read as a balanced binary tree: the middle
+	element of every range is the root of the range and stores the largest end
+	within it. An overlap query visits O(log n) elements plus O(log n) for each
+	of the k results, and O(log n + k) if the intervals barely overlap each
+	other, like the clips on a track.
+	The index is built at once by rebuild(), there are no incremental updates.
+*/
+template<typename T>
+class IntervalIndex
+{
+public:
+	struct Interval
+	{
+		int start;
+		int end;
+		T item;
+	};
+
+	//! Replaces the contents, intervals with the same start keep their order
+	void rebuild(std::vector<Interval> intervals)
+	{
+		m_intervals = std::move(intervals);
+		std::stable_sort(m_intervals.begin(), m_intervals.end(),
+			[](const Interval& a, const Interval& b) { return a.start < b.start; });
+		m_maxEnd.resize(m_intervals.size());
+		buildMaxEnd(0, m_intervals.size());
+	}
+
+	std::size_t size() const { return m_intervals.size(); }
+
+	bool contains(const T& item) const
+	{
+		return std::any_of(m_intervals.begin(), m_intervals.end(),
+			[&](const Interval& interval) { return interval.item == item; });
+	}
+
+	//! Calls f(item) for every interval overlapping [start, end], in the order of their starts
+	template<typename F>
+	void forEachOverlapping(int start, int end, F&& f) const
+	{
+		visit(0, m_intervals.size(), start, end, f);
+	}
+
+private:
+	int buildMaxEnd(std::size_t begin, std::size_t end)
+	{
+		if (begin >= end) { return std::numeric_limits<int>::min(); }
+		const auto mid = begin + (end - begin) / 2;
+		m_maxEnd[mid] = std::max({ m_intervals[mid].end, buildMaxEnd(begin, mid), buildMaxEnd(mid + 1, end) });
+		return m_maxEnd[mid];
+	}
+
+	template<typename F>
+	void visit(std::size_t begin, std::size_t end, int start, int stop, F& f) const
+	{
+		while (begin < end)
+		{
+			const auto mid = begin + (end - begin) / 2;
+			// nothing in this range reaches the query
+			if (m_maxEnd[mid] < start) { return; }
+
+			visit(begin, mid, start, stop, f);
+
+			// the middle and everything after it start too late
+			const auto& interval = m_intervals[mid];
+			if (interval.start > stop) { return; }
+			if (interval.end >= start) { f(interval.item); }
+
+			begin = mid + 1;
+		}
+	}
+
+	std::vector<Interval> m_intervals;
+	std::vector<int> m_maxEnd;
+};
+
+} // namespace lmms
+
+#endif // LMMS_INTERVAL_INDEX_H
@@ -36,13 +36,31 @@ namespace lmms
 class LocklessAllocator
 {
 public:
-	LocklessAllocator( size_t nmemb, size_t size );
+	LocklessAllocator( size_t nmemb, size_t size, size_t alignment = sizeof( void * ) );
 	virtual ~LocklessAllocator();
 	void * alloc();
+	// like alloc(), but silently returns nullptr if there is no free space
+	void * tryAlloc();
 	void free( void * ptr );
 
+	bool owns( const void * ptr ) const
+	{
+		return ptr >= m_pool && ptr < m_pool + m_capacity * m_elementSize;
+	}
+
+	size_t capacity() const
+	{
+		return m_capacity;
+	}
+
+	size_t available() const
+	{
+		return m_available.load( std::memory_order_relaxed );
+	}
+
 
 private:
+	char * m_poolMemory;
 	char * m_pool;
 	size_t m_capacity;
 	size_t m_elementSize;
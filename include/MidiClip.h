@@ -61,6 +61,9 @@ public:
 
 	// note management
 	Note * addNote( const Note & _new_note, const bool _quant_pos = true );
+	//! Adds copies of all @p notes, but sorts, updates the length and emits
+	//! dataChanged() only once. Returns the new notes in the order given.
+	NoteVector addNotes(const std::vector<Note>& notes, const bool quantPos = true);
 
 	NoteVector::const_iterator removeNote(NoteVector::const_iterator it);
 	NoteVector::const_iterator removeNote(Note* note);
@@ -36,6 +36,24 @@ class SampleFrame;
 namespace MixHelpers
 {
 
+/*! \brief Instruction sets the mixing kernels are available for */
+enum class Isa
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512,
+	Neon
+};
+
+/*! \brief Instruction set used by the kernels, the best one supported by the CPU is picked at startup */
+Isa isa();
+
+/*! \brief Switch the kernels to `isa`, fails if the CPU or the build doesn't support it */
+bool setIsa( Isa isa );
+
+const char* isaName( Isa isa );
+
 bool isSilent( const SampleFrame* src, int frames );
 
 bool useNaNHandler();
@@ -50,6 +68,9 @@ void add( SampleFrame* dst, const SampleFrame* src, int frames );
 /*! \brief Multiply samples from `dst` by `coeff` */
 void multiply(SampleFrame* dst, float coeff, int frames);
 
+/*! \brief Multiply left samples from `dst` by `coeffLeft` and right ones by `coeffRight` */
+void multiplyStereo(SampleFrame* dst, float coeffLeft, float coeffRight, int frames);
+
 /*! \brief Add samples from src multiplied by coeffSrc to dst */
 void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames );
 
@@ -26,6 +26,7 @@
 #define LMMS_MIXER_H
 
 #include "Model.h"
+#include "CpuMeter.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "ThreadableJob.h"
@@ -38,6 +39,7 @@ namespace lmms
 {
 
 
+class AudioTap;
 class MixerRoute;
 using MixerRouteVector = std::vector<MixerRoute*>;
 
@@ -72,6 +74,12 @@ class MixerChannel : public ThreadableJob
 		// pointers to other channels that send to this one
 		MixerRouteVector m_receives;
 
+		// time spent on this channel, including its effects
+		CpuMeter m_cpuMeter;
+
+		// receives the output of the channel while exporting stems, see StemExporter
+		AudioTap* m_tap;
+
 		int index() const { return m_channelIndex; }
 		void setIndex(int index) { m_channelIndex = index; }
 
@@ -86,6 +94,8 @@ class MixerChannel : public ThreadableJob
 		void setColor(const std::optional<QColor>& color) { m_color = color; }
 
 		std::atomic_size_t m_dependenciesMet;
+		// number of audio bus handles mixing into this channel in the current period
+		std::size_t m_busHandleInputs;
 		void incrementDeps();
 		void processed();
 		
@@ -143,10 +153,18 @@ public:
 	Mixer();
 	~Mixer() override;
 
-	void mixToChannel( const SampleFrame* _buf, mix_ch_t _ch );
+	// mixes _buf into channel _ch, scaling the left and right channels by the given gains
+	void mixToChannel( const SampleFrame* _buf, mix_ch_t _ch, float gainLeft = 1.0f, float gainRight = 1.0f );
+
+	// processing graph: register an audio bus handle feeding channel _ch
+	// and notify the channel once that bus handle has been processed
+	void addChannelInput( mix_ch_t _ch );
+	void channelInputProcessed( mix_ch_t _ch );
 
 	void prepareMasterMix();
-	void masterMix( SampleFrame* _buf );
+	void scheduleChannels();
+	// adds the output of the master channel, multiplied by gain, to _buf
+	void masterMix( SampleFrame* _buf, float gain );
 
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
@@ -84,6 +84,9 @@ public:
 
 	Fader* fader() const { return m_fader; }
 
+	//! Shows the CPU usage of the channel, if the meters are enabled
+	void updateCpuMeter();
+
 public slots:
 	void renameChannel();
 	void resetColor();
@@ -118,6 +121,7 @@ private:
 	AutomatableButton* m_muteButton;
 	AutomatableButton* m_soloButton;
 	PeakIndicator* m_peakIndicator = nullptr;
+	QLabel* m_cpuLabel = nullptr;
 	Fader* m_fader;
 	EffectRackView* m_effectRackView;
 	MixerView* m_mixerView;
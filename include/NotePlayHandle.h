@@ -26,15 +26,15 @@
 #ifndef LMMS_NOTE_PLAY_HANDLE_H
 #define LMMS_NOTE_PLAY_HANDLE_H
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 
 #include "BasicFilters.h"
 #include "Note.h"
 #include "PlayHandle.h"
 #include "Track.h"
 
-class QReadWriteLock;
-
 namespace lmms
 {
 
@@ -48,7 +48,8 @@ class LMMS_EXPORT NotePlayHandle : public PlayHandle, public Note
 {
 public:
 	void * m_pluginData;
-	std::unique_ptr<BasicFilters<>> m_filter;
+	// lives in the pooled storage of the handle, so starting a filtered note doesn't allocate
+	std::optional<BasicFilters<>> m_filter;
 
 	// length of the declicking fade in
 	fpp_t m_fadeInLength;
@@ -130,6 +131,23 @@ public:
 	/*! Releases the note (and plays release frames) */
 	void noteOff( const f_cnt_t offset = 0 );
 
+	/*! Releases the note and fades it out within the given number of frames,
+	    used to shed voices when the audio engine is overloaded */
+	void fadeOut( const f_cnt_t frames );
+
+	/*! Returns whether the note is being faded out by fadeOut() */
+	bool isFadingOut() const
+	{
+		return m_fadeOutLength > 0;
+	}
+
+	/*! Returns the gain of the fade out at the given frame of the current period */
+	float fadeOutGain( const f_cnt_t frame ) const
+	{
+		const f_cnt_t left = m_framesBeforeRelease + m_releaseFramesToDo - m_releaseFramesDone - frame;
+		return std::clamp( static_cast<float>( left ) / m_fadeOutLength, 0.0f, 1.0f );
+	}
+
 	/*! Returns number of frames to be played until the note is going to be released */
 	f_cnt_t framesBeforeRelease() const
 	{
@@ -263,10 +281,10 @@ public:
 		return m_songGlobalParentOffset;
 	}
 
-	void setFrequencyUpdate()
-	{
-		m_frequencyNeedsUpdate = true;
-	}
+	//! Recomputes the frequency of the note and its sub-notes, only to be called
+	//! while no notes are rendered, so instruments can read the frequencies of
+	//! other notes
+	void updateFrequency();
 
 private:
 	class BaseDetuning
@@ -290,8 +308,6 @@ private:
 
 	} ;
 
-	void updateFrequency();
-
 	InstrumentTrack* m_instrumentTrack;		// needed for calling
 											// InstrumentTrack::playNote
 	f_cnt_t m_frames;						// total frames to play
@@ -304,6 +320,8 @@ private:
 											// played after release
 	f_cnt_t m_releaseFramesDone;			// number of frames done after
 											// release of note
+	f_cnt_t m_fadeOutLength;				// length of the fade out when
+											// the voice is shed, 0 otherwise
 	NotePlayHandleList m_subNotes;			// used for chords and arpeggios
 	volatile bool m_released;				// indicates whether note is released
 	bool m_releaseStarted;
@@ -328,17 +346,29 @@ private:
 
 	int m_midiChannel;
 	Origin m_origin;
-
-	bool m_frequencyNeedsUpdate;				// used to update pitch
 } ;
 
 
 const int INITIAL_NPH_CACHE = 256;
 const int NPH_CACHE_INCREMENT = 16;
 
-class NotePlayHandleManager
+/**
+	@brief Lock-free allocator for NotePlayHandles
+
+	Free handles are kept in magazines of NPH_CACHE_INCREMENT handles. Each
+	thread caches two magazines and only exchanges full or empty magazines
+	with a global lock-free depot, so acquiring and releasing handles
+	usually doesn't touch any shared state at all.
+*/
+class LMMS_EXPORT NotePlayHandleManager
 {
 public:
+	struct Statistics
+	{
+		int inUse;
+		int allocated;
+	};
+
 	static void init();
 	static NotePlayHandle * acquire( InstrumentTrack* instrumentTrack,
 					const f_cnt_t offset,
@@ -351,11 +381,10 @@ public:
 	static void extend( int i );
 	static void free();
 
-private:
-	static NotePlayHandle ** s_available;
-	static QReadWriteLock s_mutex;
-	static std::atomic_int s_availableIndex;
-	static int s_size;
+	static Statistics statistics();
+
+	//! The most handles that can exist at once
+	static constexpr int MaxHandles = 8192 * NPH_CACHE_INCREMENT;
 };
 
 
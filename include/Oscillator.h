@@ -36,6 +36,7 @@
 #include "lmms_math.h"
 #include "AudioEngine.h"
 #include "OscillatorConstants.h"
+#include "RandomGenerator.h"
 #include "SampleBuffer.h"
 
 namespace lmms
@@ -162,7 +163,7 @@ public:
 
 	static inline sample_t noiseSample( const float )
 	{
-		return 1.0f - rand() * 2.0f / static_cast<float>(RAND_MAX);
+		return RandomGenerator::forThread().bipolar();
 	}
 
 	static sample_t userWaveSample(const SampleBuffer* buffer, const float sample)
@@ -175,53 +176,6 @@ public:
 		return std::lerp(buffer->data()[f1][0], buffer->data()[(f1 + 1) % frames][0], fraction(frame));
 	}
 
-	struct wtSampleControl {
-		float frame;
-		f_cnt_t f1;
-		f_cnt_t f2;
-		int band;
-	};
-
-	inline wtSampleControl getWtSampleControl(const float sample) const
-	{
-		wtSampleControl control;
-		control.frame = absFraction(sample) * OscillatorConstants::WAVETABLE_LENGTH;
-		control.f1 = static_cast<f_cnt_t>(control.frame);
-		control.f2 = control.f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ?
-					control.f1 + 1 :
-					0;
-		control.band = waveTableBandFromFreq(
-			m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate());
-		return control;
-	}
-
-	inline sample_t wtSample(
-		const sample_t table[OscillatorConstants::WAVE_TABLES_PER_WAVEFORM_COUNT][OscillatorConstants::WAVETABLE_LENGTH],
-		const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(table[control.band][control.f1], table[control.band][control.f2], fraction(control.frame));
-	}
-
-	sample_t wtSample(const OscillatorConstants::waveform_t* table, const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(
-			(*table)[control.band][control.f1],
-			(*table)[control.band][control.f2],
-			fraction(control.frame)
-		);
-	}
-
-	inline sample_t wtSample(sample_t **table, const float sample) const
-	{
-		assert(table != nullptr);
-		wtSampleControl control = getWtSampleControl(sample);
-		return std::lerp(table[control.band][control.f1], table[control.band][control.f2], fraction(control.frame));
-	}
-
 	static inline int waveTableBandFromFreq(float freq)
 	{
 		// Frequency bands are indexed relative to default MIDI key frequencies.
@@ -240,6 +194,12 @@ public:
 		return 440.0f * std::exp2((band * OscillatorConstants::SEMITONES_PER_TABLE - 69.0f) / 12.0f);
 	}
 
+	//! Returns the first band of the band-limited tables of a wave shape, the other bands follow it
+	static const sample_t* waveTable(WaveShape shape)
+	{
+		return s_waveTables[static_cast<std::size_t>(shape) - FirstWaveShapeTable][0];
+	}
+
 private:
 	const IntModel * m_waveShapeModel;
 	const IntModel * m_modulationAlgoModel;
@@ -310,8 +270,19 @@ private:
 	void updateFM( SampleFrame* _ab, const fpp_t _frames,
 							const ch_cnt_t _chnl );
 
-	template<WaveShape W>
-	inline sample_t getSample( const float _sample );
+	template<WaveShape W, typename Fn>
+	inline void withSampler(Fn&& fn) const;
+
+	//! Interpolates one band of a wave table
+	static auto tableSampler(const sample_t* table)
+	{
+		return [table](const float sample) {
+			const float frame = absFraction(sample) * OscillatorConstants::WAVETABLE_LENGTH;
+			const auto f1 = static_cast<f_cnt_t>(frame);
+			const auto f2 = f1 < OscillatorConstants::WAVETABLE_LENGTH - 1 ? f1 + 1 : 0;
+			return std::lerp(table[f1], table[f2], fraction(frame));
+		};
+	}
 
 	inline void recalcPhase();
 
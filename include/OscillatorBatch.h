@@ -0,0 +1,90 @@
+/*
+ * OscillatorBatch.h - renders the oscillators of several voices at once
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_OSCILLATOR_BATCH_H
+#define LMMS_OSCILLATOR_BATCH_H
+
+#include <array>
+#include <span>
+
+#include "lmms_export.h"
+#include "Oscillator.h"
+
+namespace lmms
+{
+
+/**
+	@brief Renders a chain of oscillators for several voices at once
+
+	A chain works like an Oscillator with its sub-oscillators: the first
+	oscillator is modulated by the second one, which is modulated by the third
+	one and so on. All voices of a batch share the settings of the chain and
+	only differ in their frequencies and phases. The phases are kept in
+	structure-of-arrays form with one lane per voice, so the same frame of all
+	voices is computed with SIMD instructions, including the wave table lookups.
+*/
+class LMMS_EXPORT OscillatorBatch
+{
+public:
+	//! Number of voices rendered together
+	static constexpr int Lanes = 8;
+	//! Maximum number of oscillators in a chain
+	static constexpr int MaxOscillators = 3;
+
+	//! Settings of one oscillator of a chain
+	struct Stage
+	{
+		Oscillator::WaveShape waveShape;
+		//! How the output of the next oscillator is used, ignored for the last one
+		Oscillator::ModulationAlgo modulationAlgo;
+		//! Detuning divided by the sample rate
+		float detuning;
+		float phaseOffset;
+		float volume;
+		bool useWaveTable;
+		const SampleBuffer* userWave;
+		const OscillatorConstants::waveform_t* userAntiAliasWaveTable;
+	};
+
+	using Chain = std::span<const Stage>;
+
+	//! Starts a new voice in a lane, with all phases at the phase offsets of the chain
+	void startVoice(int lane, Chain chain);
+
+	//! Renders all lanes set in the bit mask `lanes`, frame f of lane l is written
+	//! to out[f * Lanes + l]. Other lanes and lanes whose frequency is above the
+	//! Nyquist frequency keep their phases and are set to zero.
+	void render(Chain chain, const std::array<float, Lanes>& freqs, unsigned lanes, float* out, fpp_t frames);
+
+	//! Renders a single lane into one channel of a buffer, like Oscillator::update()
+	void renderVoice(int lane, Chain chain, float freq, SampleFrame* buf, fpp_t frames, ch_cnt_t chnl);
+
+private:
+	std::array<std::array<float, Lanes>, MaxOscillators> m_phases = {};
+	std::array<std::array<float, Lanes>, MaxOscillators> m_phaseOffsets = {};
+} ;
+
+} // namespace lmms
+
+#endif // LMMS_OSCILLATOR_BATCH_H
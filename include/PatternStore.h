@@ -92,7 +92,7 @@ public:
 	void fixIncorrectPositions();
 	void createClipsForPattern(int pattern);
 
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum) const override;
+	AutomationSourceMap automationSourcesAt(TimePos time, int clipNum, TimePos* validUntil = nullptr) const override;
 
 public slots:
 	void play();
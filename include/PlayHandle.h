@@ -66,6 +66,7 @@ public:
 		m_affinity = p.m_affinity;
 		m_usesBuffer = p.m_usesBuffer;
 		m_audioBusHandle = p.m_audioBusHandle;
+		setTraceName(p.traceName());
 		return *this;
 	}
 
@@ -139,10 +140,8 @@ public:
 		return m_audioBusHandle;
 	}
 	
-	void setAudioBusHandle(AudioBusHandle* busHandle)
-	{
-		m_audioBusHandle = busHandle;
-	}
+	//! Also names the play handle after the bus handle in traces
+	void setAudioBusHandle(AudioBusHandle* busHandle);
 	
 	void releaseBuffer();
 	
@@ -34,6 +34,7 @@
 namespace lmms
 {
 
+class StemExporter;
 
 class LMMS_EXPORT ProjectRenderer : public QThread
 {
@@ -67,6 +68,12 @@ public:
 		return m_fileDev != nullptr;
 	}
 
+	//! Lets @p stems capture every exported period, see StemExporter
+	void setStemExporter(StemExporter* stems)
+	{
+		m_stems = stems;
+	}
+
 	static ExportFileFormat getFileFormatFromExtension(
 							const QString & _ext );
 
@@ -89,6 +96,7 @@ private:
 	void run() override;
 
 	AudioFileDevice * m_fileDev;
+	StemExporter* m_stems;
 
 	volatile int m_progress;
 	volatile bool m_abort;
@@ -0,0 +1,124 @@
+/*
+ * RandomGenerator.h - fast random numbers for audio threads
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_RANDOM_GENERATOR_H
+#define LMMS_RANDOM_GENERATOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace lmms
+{
+
+/**
+	@brief Uniform random numbers for noise and other audio rate uses
+
+	`rand()` shares one state between all threads, which glibc guards with a lock, so noise rendered by several
+	worker threads at once mostly waits for the other threads. A generator instead belongs to one voice or one
+	thread, see forThread().
+
+	The generator consists of several xorshift32 generators. Single values come from the first one, while
+	fillBipolar() advances all of them side by side, which the compiler turns into vector instructions. The quality is
+	plenty for audio, but not for anything security related.
+*/
+class RandomGenerator
+{
+public:
+	static constexpr auto Lanes = std::size_t{8};
+
+	explicit RandomGenerator(std::uint64_t seed)
+	{
+		for (auto& state : m_state)
+		{
+			// splitmix64, so similar seeds still give unrelated states
+			seed += 0x9e3779b97f4a7c15;
+			auto z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			z ^= z >> 31;
+			// xorshift must not start from zero
+			state = static_cast<std::uint32_t>(z) | 1;
+		}
+	}
+
+	//! Uniformly distributed over all 32 bit values except zero
+	std::uint32_t next() noexcept { return step(m_state[0]); }
+
+	//! Uniformly distributed in [0, 1)
+	float unipolar() noexcept { return toUnipolar(next()); }
+
+	//! Uniformly distributed in [-1, 1)
+	float bipolar() noexcept { return 2.f * unipolar() - 1.f; }
+
+	//! Fills `dst` with values uniformly distributed in [-1, 1)
+	void fillBipolar(float* dst, std::size_t count) noexcept
+	{
+		auto i = std::size_t{0};
+		for (; i + Lanes <= count; i += Lanes)
+		{
+			for (auto lane = std::size_t{0}; lane < Lanes; ++lane)
+			{
+				dst[i + lane] = 2.f * toUnipolar(step(m_state[lane])) - 1.f;
+			}
+		}
+		for (; i < count; ++i)
+		{
+			dst[i] = bipolar();
+		}
+	}
+
+	//! The generator of the calling thread, for code that has no place to keep its own
+	static RandomGenerator& forThread() noexcept
+	{
+		static auto s_threads = std::atomic<std::uint64_t>{0};
+		thread_local auto t_generator = RandomGenerator{
+			s_threads.fetch_add(1, std::memory_order_relaxed) * 0x632be59bd9b4e019
+			^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())};
+		return t_generator;
+	}
+
+private:
+	static std::uint32_t step(std::uint32_t& state) noexcept
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	static float toUnipolar(std::uint32_t value) noexcept
+	{
+		// the upper 24 bits fit into the mantissa exactly
+		return static_cast<float>(value >> 8) * (1.f / 16777216.f);
+	}
+
+	std::array<std::uint32_t, Lanes> m_state;
+};
+
+} // namespace lmms
+
+#endif // LMMS_RANDOM_GENERATOR_H
@@ -102,6 +102,20 @@ public:
 
 	bool process( const SampleFrame* _in_buf, SampleFrame* _out_buf );
 
+	/**
+		In pipelined mode process() hands the period to the remote process and
+		returns the one submitted the period before, so the remote process runs
+		in parallel with the rest of the period at the cost of one period of
+		latency. The periods alternate between two slots of the shared memory.
+		The mode is taken from the settings when the plugin is created and is
+		off by default, as the engine has no delay compensation yet: a
+		pipelined plugin plays one period behind all other tracks.
+	*/
+	bool isPipelined() const
+	{
+		return m_pipelined;
+	}
+
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
 	void updateSampleRate( sample_rate_t _sr )
@@ -158,6 +172,8 @@ protected:
 	bool m_failed;
 private:
 	void resizeSharedProcessingMemory();
+	//! Waits until no more than the given number of periods are left with the remote process
+	void waitForPeriodsInFlight(int periods);
 
 
 	QProcess m_process;
@@ -176,6 +192,12 @@ private:
 	SharedMemory<float[]> m_audioBuffer;
 	std::size_t m_audioBufferSize;
 
+	bool m_pipelined;
+	//! slot of the period the remote process is working on in pipelined mode, -1 if none
+	int m_pendingSlot;
+	//! periods sent with IdStartProcessing whose IdProcessingDone hasn't arrived yet
+	int m_periodsInFlight;
+
 	int m_inputCount;
 	int m_outputCount;
 
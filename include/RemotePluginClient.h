@@ -126,7 +126,7 @@ public:
 
 private:
 	void setShmKey(const std::string& key);
-	void doProcessing();
+	void doProcessing(int slot);
 
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
@@ -296,7 +296,8 @@ bool RemotePluginClient::processMessage( const message & _m )
 			break;
 
 		case IdStartProcessing:
-			doProcessing();
+			// the host passes the slot only in pipelined mode
+			doProcessing(_m.data.empty() ? 0 : _m.getInt(0));
 			reply_message.id = IdProcessingDone;
 			reply = true;
 			break;
@@ -342,12 +343,14 @@ void RemotePluginClient::setShmKey(const std::string& key)
 
 
 
-void RemotePluginClient::doProcessing()
+void RemotePluginClient::doProcessing(int slot)
 {
-	if (m_audioBuffer)
+	const std::size_t slotSize = (m_inputCount + m_outputCount) * m_bufferSize;
+	if (m_audioBuffer && (slot + 1) * slotSize <= m_audioBuffer.size())
 	{
-		process( (SampleFrame*)( m_inputCount > 0 ? m_audioBuffer.get() : nullptr ),
-				(SampleFrame*)( m_audioBuffer.get() +
+		float* buffer = m_audioBuffer.get() + slot * slotSize;
+		process( (SampleFrame*)( m_inputCount > 0 ? buffer : nullptr ),
+				(SampleFrame*)( buffer +
 					( m_inputCount*m_bufferSize ) ) );
 	}
 	else
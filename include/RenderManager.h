@@ -30,6 +30,8 @@
 
 #include "ProjectRenderer.h"
 #include "OutputSettings.h"
+#include "SegmentRenderer.h"
+#include "StemExporter.h"
 
 
 namespace lmms
@@ -50,6 +52,16 @@ public:
 	/// Export all unmuted tracks into individual file
 	void renderTracks();
 
+	/// Export all unmuted tracks, and optionally all mixer channels, into
+	/// individual files while rendering the song only once. The full mix is
+	/// written next to them.
+	void renderTracksInOnePass(bool mixerChannels);
+
+	/// Export all unmuted tracks into a single file, rendering up to
+	/// `segments` parts of the song in parallel processes. Falls back to
+	/// renderProject() if the song can't be split.
+	void renderProjectInSegments(int segments, int prerollBars, bool verify);
+
 	void abortProcessing();
 
 signals:
@@ -58,10 +70,14 @@ signals:
 
 private slots:
 	void renderNextTrack();
+	void finishStems();
+	void finishSegments();
 	void updateConsoleProgress();
 
 private:
 	QString pathForTrack( const Track *track, int num );
+	QString pathForMixerChannel(const MixerChannel* channel);
+	std::vector<Track*> unmutedTracks() const;
 	void restoreMutedState();
 
 	void render( QString outputPath );
@@ -74,6 +90,9 @@ private:
 
 	std::vector<Track*> m_tracksToRender;
 	std::vector<Track*> m_unmuted;
+
+	std::unique_ptr<StemExporter> m_stemExporter;
+	std::unique_ptr<SegmentRenderer> m_segmentRenderer;
 } ;
 
 
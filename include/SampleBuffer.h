@@ -26,6 +26,7 @@
 #define LMMS_SAMPLE_BUFFER_H
 
 #include <QString>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -34,19 +35,31 @@
 #include "LmmsTypes.h"
 #include "lmms_export.h"
 
+class QFile;
+
 namespace lmms {
+
+/**
+	Holds the frames of a sample, which never change after construction.
+
+	Files which decode to more than `MappedSizeThreshold` bytes are converted once into a float file in the cache
+	directory, which is then mapped into memory. The OS pages it in on demand and can drop it again under memory
+	pressure, so long recordings neither stay resident nor have to be decoded again on the next load.
+*/
 class LMMS_EXPORT SampleBuffer
 {
 public:
 	using value_type = SampleFrame;
-	using reference = SampleFrame&;
+	using reference = const SampleFrame&;
 	using const_reference = const SampleFrame&;
-	using iterator = std::vector<SampleFrame>::iterator;
-	using const_iterator = std::vector<SampleFrame>::const_iterator;
-	using difference_type = std::vector<SampleFrame>::difference_type;
-	using size_type = std::vector<SampleFrame>::size_type;
-	using reverse_iterator = std::vector<SampleFrame>::reverse_iterator;
-	using const_reverse_iterator = std::vector<SampleFrame>::const_reverse_iterator;
+	using iterator = const SampleFrame*;
+	using const_iterator = const SampleFrame*;
+	using difference_type = std::ptrdiff_t;
+	using size_type = std::size_t;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	static constexpr auto MappedSizeThreshold = std::size_t{64} << 20;
 
 	SampleBuffer() = default;
 	explicit SampleBuffer(const QString& audioFile);
@@ -61,32 +74,38 @@ public:
 	auto audioFile() const -> const QString& { return m_audioFile; }
 	auto sampleRate() const -> sample_rate_t { return m_sampleRate; }
 
-	auto begin() -> iterator { return m_data.begin(); }
-	auto end() -> iterator { return m_data.end(); }
+	auto begin() const -> const_iterator { return data(); }
+	auto end() const -> const_iterator { return data() + size(); }
 
-	auto begin() const -> const_iterator { return m_data.begin(); }
-	auto end() const -> const_iterator { return m_data.end(); }
+	auto cbegin() const -> const_iterator { return begin(); }
+	auto cend() const -> const_iterator { return end(); }
 
-	auto cbegin() const -> const_iterator { return m_data.cbegin(); }
-	auto cend() const -> const_iterator { return m_data.cend(); }
+	auto rbegin() const -> const_reverse_iterator { return const_reverse_iterator{end()}; }
+	auto rend() const -> const_reverse_iterator { return const_reverse_iterator{begin()}; }
 
-	auto rbegin() -> reverse_iterator { return m_data.rbegin(); }
-	auto rend() -> reverse_iterator { return m_data.rend(); }
+	auto crbegin() const -> const_reverse_iterator { return rbegin(); }
+	auto crend() const -> const_reverse_iterator { return rend(); }
 
-	auto rbegin() const -> const_reverse_iterator { return m_data.rbegin(); }
-	auto rend() const -> const_reverse_iterator { return m_data.rend(); }
+	auto data() const -> const SampleFrame* { return m_mappedData ? m_mappedData : m_data.data(); }
+	auto size() const -> size_type { return m_mappedData ? m_mappedSize : m_data.size(); }
+	auto empty() const -> bool { return size() == 0; }
 
-	auto crbegin() const -> const_reverse_iterator { return m_data.crbegin(); }
-	auto crend() const -> const_reverse_iterator { return m_data.crend(); }
-
-	auto data() const -> const SampleFrame* { return m_data.data(); }
-	auto size() const -> size_type { return m_data.size(); }
-	auto empty() const -> bool { return m_data.empty(); }
+	//! Whether the frames are read from a mapped cache file
+	auto isMapped() const -> bool { return m_mappedData != nullptr; }
 
 	static auto emptyBuffer() -> std::shared_ptr<const SampleBuffer>;
 
 private:
+	auto mapCacheFile(const QString& cacheFile) -> bool;
+	void writeCacheFile(const QString& cacheFile) const;
+
 	std::vector<SampleFrame> m_data;
+
+	//! Used instead of `m_data` if the frames are mapped from a cache file
+	std::shared_ptr<QFile> m_mappedFile;
+	const SampleFrame* m_mappedData = nullptr;
+	size_type m_mappedSize = 0;
+
 	QString m_audioFile;
 	sample_rate_t m_sampleRate = Engine::audioEngine()->outputSampleRate();
 };
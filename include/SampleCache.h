@@ -0,0 +1,97 @@
+/*
+ * SampleCache.h - shares decoded samples between everything that loads them
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SAMPLE_CACHE_H
+#define LMMS_SAMPLE_CACHE_H
+
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "lmms_export.h"
+
+namespace lmms {
+
+class SampleBuffer;
+
+/**
+	Decodes every audio file only once, however many clips, instruments or projects use it.
+
+	A buffer is shared as long as anything holds it. Once the last user lets it go, it is kept for a while, so
+	reloading a project or a preset doesn't decode it again. Those unused buffers are dropped, least recently used
+	first, when they take more than `MemoryBudget` bytes.
+
+	Entries are keyed by the canonical path, the modification time and size of the file, and the output sample rate,
+	since some decoders render at that rate. Editing a file therefore makes it load again.
+*/
+class LMMS_EXPORT SampleCache
+{
+public:
+	struct Stats
+	{
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t evictions = 0;
+		//! Bytes held by buffers nothing but the cache uses
+		std::size_t unusedBytes = 0;
+	};
+
+	static constexpr auto MemoryBudget = std::size_t{256} << 20;
+
+	//! Returns the buffer of `audioFile`, decoding it if necessary. Throws like the `SampleBuffer` constructor.
+	auto get(const QString& audioFile) -> std::shared_ptr<const SampleBuffer>;
+
+	auto stats() const -> Stats;
+
+	//! Return the global `SampleCache` instance.
+	static auto instance() -> SampleCache&;
+
+private:
+	struct Entry
+	{
+		//! The buffer is unused when this is the only reference left
+		std::shared_ptr<const SampleBuffer> buffer;
+		std::size_t bytes = 0;
+		std::uint64_t lastUse = 0;
+	};
+
+	struct Hash
+	{
+		std::size_t operator()(const QString& key) const noexcept { return qHash(key); }
+	};
+
+	auto unusedBytes() const -> std::size_t;
+	void evict();
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<QString, Entry, Hash> m_entries;
+	std::uint64_t m_useCounter = 0;
+	Stats m_stats;
+};
+
+} // namespace lmms
+
+#endif // LMMS_SAMPLE_CACHE_H
@@ -27,8 +27,12 @@
 #define LMMS_SAMPLE_THUMBNAIL_H
 
 #include <QDateTime>
+#include <QPointer>
 #include <QRect>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 #include "lmms_export.h"
 #include "SampleBuffer.h"
@@ -50,6 +54,10 @@ class Sample;
    Given that we are dealing with far less data to generate
    the visualization however (i.e., we are not reading from original sample data when drawing), this provides a
    significant performance boost that wouldn't be possible otherwise.
+
+   Thumbnails of long samples are generated on the global `ThreadPool` and stored in a peak file in the cache
+   directory, so they don't block the GUI and are only generated once per file. A placeholder is drawn until they
+   are ready.
  */
 class LMMS_EXPORT SampleThumbnail
 {
@@ -71,9 +79,15 @@ public:
 	};
 
 	SampleThumbnail() = default;
-	SampleThumbnail(const Sample& sample);
+
+	//! If the thumbnail has to be generated in the background, `onReady` is called on the GUI thread once it is
+	//! ready, unless `context` was destroyed by then.
+	SampleThumbnail(const Sample& sample, QObject* context = nullptr, std::function<void()> onReady = {});
+
 	void visualize(VisualizeParameters parameters, QPainter& painter) const;
 
+	bool isReady() const { return m_thumbnailCache->ready.load(std::memory_order_acquire); }
+
 private:
 	class Thumbnail
 	{
@@ -108,6 +122,7 @@ private:
 		Thumbnail zoomOut(float factor) const;
 
 		Peak* data() { return m_peaks.data(); }
+		const Peak* data() const { return m_peaks.data(); }
 		Peak& operator[](size_t index) { return m_peaks[index]; }
 		const Peak& operator[](size_t index) const { return m_peaks[index]; }
 
@@ -119,6 +134,22 @@ private:
 		double m_samplesPerPeak = 0.0;
 	};
 
+	struct ThumbnailCache
+	{
+		std::vector<Thumbnail> thumbnails;
+
+		//! Set once `thumbnails` is complete, after which it is not modified anymore
+		std::atomic<bool> ready = false;
+
+		std::mutex waitingMutex;
+		std::vector<std::pair<QPointer<QObject>, std::function<void()>>> waiting;
+	};
+
+	static void generate(ThumbnailCache& cache, const SampleBuffer& buffer);
+	static bool load(ThumbnailCache& cache, const QString& peakFile, std::size_t frames);
+	static void save(const ThumbnailCache& cache, const QString& peakFile, std::size_t frames);
+	static void finish(ThumbnailCache& cache);
+
 	struct SampleThumbnailEntry
 	{
 		QString filePath;
@@ -135,7 +166,6 @@ private:
 		std::size_t operator()(const SampleThumbnailEntry& entry) const noexcept { return qHash(entry.filePath); }
 	};
 
-	using ThumbnailCache = std::vector<Thumbnail>;
 	std::shared_ptr<ThumbnailCache> m_thumbnailCache = std::make_shared<ThumbnailCache>();
 	std::shared_ptr<const SampleBuffer> m_buffer = SampleBuffer::emptyBuffer();
 	inline static std::unordered_map<SampleThumbnailEntry, std::shared_ptr<ThumbnailCache>, Hash> s_sampleThumbnailCacheMap;
@@ -0,0 +1,140 @@
+/*
+ * SegmentRenderer.h - renders segments of the song in parallel processes
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_SEGMENT_RENDERER_H
+#define LMMS_SEGMENT_RENDERER_H
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QProcess>
+#include <QTemporaryDir>
+
+#include "OutputSettings.h"
+#include "ProjectRenderer.h"
+#include "TimePos.h"
+
+namespace lmms
+{
+
+/**
+	@brief Renders the song faster than one engine can by splitting it into segments
+
+	A @ref ProjectRenderer renders one period after the other, so an export can
+	never use more cores than the jobs of a single period keep busy. The engine
+	and the song are global, so the segments can't be rendered side by side in
+	one process. Instead, each segment is rendered by a child process running
+	`lmms render --segment`, into a 32 bit float file.
+
+	Every segment starts rendering some bars before the part it contributes,
+	so notes, effect tails and automation have settled once it matters. The
+	pre-roll is dropped when the segments are stitched together and encoded
+	into the output file, with a short crossfade over each boundary.
+
+	The result is only identical to a normal export if the instruments and
+	effects are in the same state at the beginning of each segment, whichever
+	way they got there. Notes longer than the pre-roll, free running LFOs or
+	random generators make the segments differ. The renderer can therefore also
+	render the song normally and compare both, which should be done for a
+	corpus of projects before relying on segments. Songs with tempo automation
+	or repeated loops can't be split and have to be rendered normally.
+*/
+class LMMS_EXPORT SegmentRenderer : public QObject
+{
+	Q_OBJECT
+public:
+	SegmentRenderer(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format,
+		const QString& outputPath);
+	~SegmentRenderer() override;
+
+	//! Splits the song into at most @p segments, returns false if it can't be split
+	bool plan(int segments, int prerollBars);
+
+	//! Starts the child processes, and a normal export to compare with if @p verify is set
+	void start(bool verify);
+	//! Stops all processes, finished() is not emitted afterwards
+	void abort();
+
+	bool successful() const { return m_successful; }
+	int progress() const { return m_progress; }
+	std::size_t count() const { return m_segments.size(); }
+
+	//! Describes how far the segments differ from a normal export, if they were verified
+	const QString& report() const { return m_report; }
+
+signals:
+	void progressChanged(int);
+	void finished();
+
+private slots:
+	void verificationRendered();
+
+private:
+	struct Segment
+	{
+		//! The part of the song the segment contributes
+		TimePos begin;
+		TimePos end;
+		//! The part which is rendered, including pre-roll and crossfade
+		TimePos renderBegin;
+		TimePos renderEnd;
+
+		QString file;
+		QProcess* process = nullptr;
+		bool done = false;
+	};
+
+	void startNextSegment();
+	void segmentRendered(std::size_t index, int exitCode, QProcess::ExitStatus exitStatus);
+	void finish();
+	bool stitch();
+	//! Position of @p time in the output file
+	f_cnt_t frameOf(const TimePos& time) const;
+
+	const OutputSettings m_outputSettings;
+	const ProjectRenderer::ExportFileFormat m_format;
+	const QString m_outputPath;
+
+	TimePos m_begin;
+	float m_framesPerTick = 0.f;
+	std::vector<Segment> m_segments;
+	std::size_t m_nextSegment = 0;
+	std::size_t m_running = 0;
+	std::size_t m_maxRunning = 1;
+
+	std::unique_ptr<QTemporaryDir> m_directory;
+	std::unique_ptr<ProjectRenderer> m_verificationRenderer;
+	QString m_verificationFile;
+	bool m_verificationDone = true;
+
+	int m_progress = 0;
+	bool m_failed = false;
+	bool m_successful = false;
+	QString m_report;
+};
+
+} // namespace lmms
+
+#endif // LMMS_SEGMENT_RENDERER_H
@@ -98,6 +98,10 @@ private slots:
 	void vstEmbedMethodChanged();
 	void toggleVSTAlwaysOnTop(bool en);
 	void toggleDisableAutoQuit(bool enabled);
+	void toggleRemotePipelining(bool enabled);
+	void toggleWorkStealing(bool enabled);
+	void toggleCpuMeters(bool enabled);
+	void toggleVoiceSheddingQuality(bool enabled);
 
 	// Audio settings widget.
 	void audioInterfaceChanged(const QString & driver);
@@ -168,6 +172,12 @@ private:
 	QCheckBox * m_vstAlwaysOnTopCheckBox;
 	bool m_vstAlwaysOnTop;
 	bool m_disableAutoQuit;
+	bool m_remotePipelining;
+	QLabel * m_remotePipeliningWarnLbl;
+	bool m_workStealing;
+	bool m_cpuMeters;
+	QComboBox* m_voiceSheddingComboBox;
+	bool m_voiceSheddingQuality;
 
 	using AswMap = QMap<QString, AudioDeviceSetupWidget*>;
 	using MswMap = QMap<QString, MidiSetupWidget*>;
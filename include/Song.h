@@ -27,9 +27,11 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include <QString>
 #include <QHash>  // IWYU pragma: keep
+#include <QSet>
 
 #include "AudioEngine.h"
 #include "Controller.h"
@@ -222,6 +224,11 @@ public:
 		m_exportLoop = exportLoop;
 	}
 
+	inline bool exportLoop() const
+	{
+		return m_exportLoop;
+	}
+
 	inline bool isRecording() const
 	{
 		return m_recording;
@@ -249,6 +256,11 @@ public:
 		m_renderBetweenMarkers = renderBetweenMarkers;
 	}
 
+	inline bool renderBetweenMarkers() const
+	{
+		return m_renderBetweenMarkers;
+	}
+
 	inline PlayMode playMode() const
 	{
 		return m_playMode;
@@ -290,8 +302,8 @@ public:
 		return m_globalAutomationTrack;
 	}
 
-	//TODO: Add Q_DECL_OVERRIDE when Qt4 is dropped
-	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const override;
+	AutomationSourceMap automationSourcesAt(TimePos time, int clipNum = -1,
+		TimePos* validUntil = nullptr) const override;
 
 	// file management
 	void createNewProject();
@@ -447,7 +459,10 @@ private:
 	void saveKeymapStates(QDomDocument &doc, QDomElement &element);
 	void restoreKeymapStates(const QDomElement &element);
 
-	void processAutomations(const TrackList& tracks, TimePos timeStart, fpp_t frames);
+	TrackContainer* automationContainer(const TrackList& tracks, int& clipNum);
+	void processAutomationRecording(const TrackList& tracks, TimePos timeStart);
+	//! Renders the automation into the models for frames [frameOffset, frameOffset + frames) of the period
+	void processAutomations(const TrackList& tracks, const PlayPos& timeStart, f_cnt_t frameOffset, f_cnt_t frames);
 	void processMetronome(size_t bufferOffset);
 
 	void setModified(bool value);
@@ -513,6 +528,9 @@ private:
 	std::shared_ptr<Keymap> m_keymaps[MaxKeymapCount];
 
 	AutomatedValueMap m_oldAutomatedValues;
+	QSet<const AutomatableModel*> m_recordedModels;
+	TimePos m_automationValidUntil;
+	std::vector<float> m_automationBuffer;
 
 	Metronome m_metronome;
 
@@ -0,0 +1,108 @@
+/*
+ * StemExporter.h - writes many tracks and mixer channels during one render
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_STEM_EXPORTER_H
+#define LMMS_STEM_EXPORTER_H
+
+#include <memory>
+#include <vector>
+
+#include "AudioTap.h"
+#include "OutputSettings.h"
+#include "ProjectRenderer.h"
+
+namespace lmms
+{
+
+class AudioBusHandle;
+class AudioFileDevice;
+class MixerChannel;
+class Track;
+
+/**
+	@brief Exports many stems while the song is rendered once
+
+	Rendering each track on its own re-renders the whole song, including all
+	automation and MIDI, once per track. Instead, the exporter taps the audio
+	bus handle of every track, and optionally every mixer channel, while the
+	song is rendered once by a @ref ProjectRenderer. The output of each tap is
+	handed to the file device of the stem, which encodes it on its own thread,
+	so all files are encoded in parallel and alongside the rendering.
+
+	Track stems are taken where the track enters its mixer channel, i.e. after
+	the effects, volume and panning of the track but before any mixer effects.
+	Mixer channel stems are taken after the effects and fader of the channel.
+*/
+class LMMS_EXPORT StemExporter
+{
+public:
+	StemExporter(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format);
+	//! Waits for the encoders and closes the files
+	~StemExporter();
+
+	StemExporter(const StemExporter&) = delete;
+	StemExporter& operator=(const StemExporter&) = delete;
+
+	//! Exports an instrument or sample track into @p file
+	bool addTrack(Track* track, const QString& file);
+	//! Exports a mixer channel into @p file
+	bool addMixerChannel(MixerChannel* channel, const QString& file);
+
+	std::size_t count() const { return m_stems.size(); }
+
+	//! Starts tapping the sources, call before rendering
+	void attach();
+	//! Stops tapping the sources and writes what is left, call after rendering
+	void finish();
+	//! Stops tapping the sources and removes the files
+	void abort();
+
+	//! Called after each rendered period which is part of the export
+	void capture();
+	//! Called after each rendered period which must not be exported
+	void skip();
+
+private:
+	struct Stem
+	{
+		Stem(fpp_t framesPerPeriod) : tap(framesPerPeriod) {}
+
+		AudioTap tap;
+		std::unique_ptr<AudioFileDevice> device;
+		AudioBusHandle* busHandle = nullptr;
+		MixerChannel* channel = nullptr;
+	};
+
+	Stem* addStem(const QString& file);
+	void detach();
+
+	const OutputSettings m_outputSettings;
+	const ProjectRenderer::ExportFileFormat m_format;
+	std::vector<std::unique_ptr<Stem>> m_stems;
+	bool m_attached = false;
+};
+
+} // namespace lmms
+
+#endif // LMMS_STEM_EXPORTER_H
@@ -26,8 +26,10 @@
 #define LMMS_THREADABLE_JOB_H
 
 #include "LmmsTypes.h"
+#include "TraceRecorder.h"
 
 #include <atomic>
+#include <cstdint>
 
 namespace lmms
 {
@@ -44,8 +46,9 @@ public:
 		Done
 	};
 
-	ThreadableJob() :
-		m_state(ProcessingState::Unstarted)
+	explicit ThreadableJob(TraceRecorder::Category traceCategory) :
+		m_state(ProcessingState::Unstarted),
+		m_traceCategory(traceCategory)
 	{
 	}
 
@@ -61,6 +64,7 @@ public:
 
 	inline void queue()
 	{
+		m_queuedAt = TraceRecorder::isRecording(m_traceCategory) ? TraceRecorder::now() : 0;
 		m_state = ProcessingState::Queued;
 	}
 	
@@ -74,11 +78,38 @@ public:
 		auto expected = ProcessingState::Queued;
 		if (m_state.compare_exchange_strong(expected, ProcessingState::InProgress))
 		{
-			doProcessing();
+			if (TraceRecorder::isRecording(m_traceCategory))
+			{
+				const auto begin = TraceRecorder::now();
+				doProcessing();
+				TraceRecorder::record({m_queuedAt, begin, TraceRecorder::now(), traceName(), m_traceCategory});
+			}
+			else
+			{
+				doProcessing();
+			}
 			m_state = ProcessingState::Done;
 		}
 	}
 
+	//! Id of the name of this job in traces, see TraceRecorder::intern()
+	std::uint32_t traceName() const
+	{
+		return m_traceName.load(std::memory_order_relaxed);
+	}
+
+	//! Real-time safe
+	void setTraceName(std::uint32_t name)
+	{
+		m_traceName.store(name, std::memory_order_relaxed);
+	}
+
+	//! Not real-time safe
+	void setTraceName(const QString& name)
+	{
+		setTraceName(TraceRecorder::intern(name));
+	}
+
 	virtual bool requiresProcessing() const = 0;
 
 
@@ -86,6 +117,12 @@ protected:
 	virtual void doProcessing() = 0;
 
 	std::atomic<ProcessingState> m_state;
+
+private:
+	const TraceRecorder::Category m_traceCategory;
+	std::atomic<std::uint32_t> m_traceName = TraceRecorder::Unnamed;
+	// published to the processing thread by the store to m_state
+	std::uint64_t m_queuedAt = 0;
 } ;
 
 } // namespace lmms
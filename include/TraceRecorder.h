@@ -0,0 +1,140 @@
+/*
+ * TraceRecorder.h - per-thread lock-free trace of the audio threads
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_TRACE_RECORDER_H
+#define LMMS_TRACE_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <QString>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+/**
+	@brief Records what the audio threads spend their time on
+
+	Every thread writes its events into its own pre-allocated single-producer
+	ring, so recording is lock-free and never allocates. A background thread
+	drains the rings and writes them out as Chrome trace-event JSON, which can
+	be opened in Perfetto or chrome://tracing, and/or as a plain text log with
+	the duration of each period in microseconds, one per line.
+
+	Names are interned outside of the audio threads with intern(), events only
+	carry the returned id. If nothing is being written, recording a span costs
+	one relaxed atomic load.
+*/
+class LMMS_EXPORT TraceRecorder
+{
+public:
+	enum class Category : std::uint8_t
+	{
+		Period,
+		Stage,
+		PlayHandle,
+		AudioBusHandle,
+		MixerChannel,
+		Effect,
+		Count
+	};
+
+	struct Event
+	{
+		//! Time the job was queued, 0 if it wasn't
+		std::uint64_t queued;
+		std::uint64_t begin;
+		std::uint64_t end;
+		std::uint32_t name;
+		Category category;
+	};
+
+	//! Id of names which were never set
+	static constexpr std::uint32_t Unnamed = 0;
+
+	//! Starts writing periods, and all other events if @p traceFile is not empty. Not real-time safe.
+	static bool start(const QString& traceFile, const QString& periodLogFile = QString{});
+	//! Writes the remaining events and closes the files. Not real-time safe.
+	static void stop();
+
+	static bool isRecording(Category category)
+	{
+		const auto mode = s_mode.load(std::memory_order_relaxed);
+		return category == Category::Period ? mode != 0 : (mode & TraceMode) != 0;
+	}
+
+	//! Monotonic time in nanoseconds
+	static std::uint64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//! Returns the id of @p name. Not real-time safe.
+	static std::uint32_t intern(const QString& name);
+
+	//! Names the calling thread in the trace. Not real-time safe.
+	static void setThreadName(const QString& name);
+
+	//! Real-time safe. The event is dropped if the ring of the thread is full, or if all rings are taken by other threads.
+	static void record(const Event& event);
+
+	//! Records the lifetime of the object as an event
+	class Span
+	{
+	public:
+		Span(std::uint32_t name, Category category) :
+			m_begin(isRecording(category) ? now() : 0),
+			m_name(name),
+			m_category(category)
+		{
+		}
+
+		~Span()
+		{
+			if (m_begin != 0) { record({0, m_begin, now(), m_name, m_category}); }
+		}
+
+		Span(const Span&) = delete;
+		Span& operator=(const Span&) = delete;
+
+	private:
+		const std::uint64_t m_begin;
+		const std::uint32_t m_name;
+		const Category m_category;
+	};
+
+private:
+	static constexpr int PeriodLogMode = 1;
+	static constexpr int TraceMode = 2;
+
+	static std::atomic_int s_mode;
+};
+
+} // namespace lmms
+
+#endif // LMMS_TRACE_RECORDER_H
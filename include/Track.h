@@ -25,11 +25,14 @@
 #ifndef LMMS_TRACK_H
 #define LMMS_TRACK_H
 
+#include <array>
+#include <atomic>
 #include <vector>
 
 #include <QColor>
 
 #include "AutomatableModel.h"
+#include "IntervalIndex.h"
 #include "JournallingObject.h"
 #include "LmmsTypes.h"
 #include <optional>
@@ -226,7 +229,21 @@ private:
 
 	clipVector m_clips;
 
+	//! m_clips by position, rebuilt by rebuildClipIndex() after any clip was added, removed, moved or resized.
+	//! Lookups read the current one while the other one is rebuilt.
+	std::array<IntervalIndex<Clip*>, 2> m_clipIndices;
+	//! number of getClipsInRange() calls currently reading each index
+	std::array<std::atomic<int>, 2> m_clipIndexReaders;
+	std::atomic<int> m_currentClipIndex;
+	//! > 0 while clips are added in bulk, they are indexed once at the end
+	int m_clipIndexBatch;
+	//! serializes publishClipIndex(), lookups never take it
+	QMutex m_clipIndexMutex;
+
 	QMutex m_processingLock;
+
+	void rebuildClipIndex();
+	void publishClipIndex(const clipVector& clips);
 	
 	std::optional<QColor> m_color;
 
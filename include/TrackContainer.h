@@ -26,6 +26,7 @@
 #ifndef LMMS_TRACK_CONTAINER_H
 #define LMMS_TRACK_CONTAINER_H
 
+#include <limits>
 #include <QReadWriteLock>
 
 #include "Track.h"
@@ -37,6 +38,16 @@ namespace lmms
 class AutomationClip;
 class InstrumentTrack;
 
+//! The automation clip a model follows, at the clip time min(time - shift, limit)
+struct AutomationSource
+{
+	const AutomationClip* clip;
+	tick_t shift;
+	tick_t limit = std::numeric_limits<tick_t>::max();
+};
+
+using AutomationSourceMap = QMap<AutomatableModel*, AutomationSource>;
+
 namespace gui
 {
 
@@ -95,13 +106,22 @@ public:
 		return m_TrackContainerType;
 	}
 
-	virtual AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+	AutomatedValueMap automatedValuesAt(TimePos time, int clipNum = -1) const;
+
+	/**
+		@brief Returns the automation clips controlling the models at the given time
+		@param validUntil if not null, lowered to the time at which the clips or
+			their mapping may change, as long as time advances continuously
+	*/
+	virtual AutomationSourceMap automationSourcesAt(TimePos time, int clipNum = -1,
+		TimePos* validUntil = nullptr) const;
 
 signals:
 	void trackAdded( lmms::Track * _track );
 
 protected:
-	static AutomatedValueMap automatedValuesFromTracks(const TrackList &tracks, TimePos timeStart, int clipNum = -1);
+	static AutomationSourceMap automationSourcesFromTracks(const TrackList& tracks, TimePos time,
+		int clipNum = -1, TimePos* validUntil = nullptr);
 
 	mutable QReadWriteLock m_tracksMutex;
 
@@ -0,0 +1,143 @@
+/*
+ * VoiceGovernor.h - sheds voices when the audio engine runs out of time
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_VOICE_GOVERNOR_H
+#define LMMS_VOICE_GOVERNOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+
+#include "lmms_export.h"
+#include "PlayHandle.h"
+
+namespace lmms
+{
+
+class NotePlayHandle;
+
+/**
+	@brief Keeps the audio engine within its deadline by shedding voices
+
+	After each period the governor compares the time the period took with the
+	time it may take. Once there is less headroom left than needed, it fades
+	out voices in the next note setup, starting with the ones which are least
+	audible: notes which have been releasing for the longest time first, then,
+	if the policy allows it and the overload persists, the quietest and oldest
+	sustained notes. New notes are kept rather than old ones. The legacy policy
+	drops new notes instead, like LMMS always did.
+
+	While overloaded, instruments may also switch to cheaper modes for new
+	notes, see reducedQuality(). Nothing is ever shed while exporting.
+*/
+class LMMS_EXPORT VoiceGovernor
+{
+public:
+	enum class Policy
+	{
+		Off,		//!< never shed voices
+		DropNew,	//!< drop new notes while the averaged load is critical
+		FadeReleasing,	//!< fade out releasing notes, drop new ones if there are none left
+		StealVoices	//!< also fade out sustained notes, always keep new ones
+	};
+
+	//! Reads the policy from the configuration
+	VoiceGovernor();
+
+	Policy policy() const { return m_policy.load(std::memory_order_relaxed); }
+	void setPolicy(Policy policy) { m_policy = policy; }
+
+	//! Value used in the configuration file
+	static QString policyName(Policy policy);
+	static Policy policyFromName(const QString& name);
+
+	//! Whether instruments may use cheaper modes while overloaded
+	void setReducedQualityAllowed(bool allowed) { m_reducedQualityAllowed = allowed; }
+
+	//! Whether new notes should use cheaper interpolation or oscillator modes
+	bool reducedQuality() const
+	{
+		return m_reducedQuality.load(std::memory_order_relaxed)
+			&& m_reducedQualityAllowed.load(std::memory_order_relaxed);
+	}
+
+	//! Whether the audio engine may add @p handle. Counts rejected notes.
+	bool admit(const PlayHandle* handle);
+
+	//! Fades out voices if the last period overran, called during note setup
+	void shed(const PlayHandleList& playHandles);
+
+	//! Called by the audio engine at the end of each period, times in microseconds
+	void finishPeriod(int periodTime, int periodLimit);
+
+	//! Load of the last periods, 1 means the whole period was used
+	float load() const { return m_load.load(std::memory_order_relaxed); }
+
+	//! New notes which were not played
+	std::uint64_t rejectedVoices() const { return m_rejectedVoices.load(std::memory_order_relaxed); }
+	//! Releasing notes which were faded out early
+	std::uint64_t fadedVoices() const { return m_fadedVoices.load(std::memory_order_relaxed); }
+	//! Sustained notes which were faded out
+	std::uint64_t stolenVoices() const { return m_stolenVoices.load(std::memory_order_relaxed); }
+	//! Periods in which reducedQuality() was requested
+	std::uint64_t reducedQualityPeriods() const { return m_reducedQualityPeriods.load(std::memory_order_relaxed); }
+
+	void resetStatistics();
+
+private:
+	struct Candidate
+	{
+		NotePlayHandle* handle;
+		bool released;
+		float priority;
+	};
+
+	bool exporting() const;
+
+	std::atomic<Policy> m_policy;
+	std::atomic_bool m_reducedQualityAllowed;
+	std::atomic_bool m_reducedQuality = false;
+
+	std::atomic<float> m_load = 0.f;
+	// consecutive periods with too little headroom
+	int m_overloadedPeriods = 0;
+	// periods to wait for faded voices to finish before shedding again
+	int m_cooldown = 0;
+	// whether the last shed() left releasing voices which could be faded
+	std::atomic_bool m_canShed = true;
+
+	// reserved up front, shed() must not allocate
+	std::vector<Candidate> m_candidates;
+
+	std::atomic<std::uint64_t> m_rejectedVoices = 0;
+	std::atomic<std::uint64_t> m_fadedVoices = 0;
+	std::atomic<std::uint64_t> m_stolenVoices = 0;
+	std::atomic<std::uint64_t> m_reducedQualityPeriods = 0;
+};
+
+} // namespace lmms
+
+#endif // LMMS_VOICE_GOVERNOR_H
@@ -0,0 +1,134 @@
+/*
+ * WorkStealingDeque.h - fixed-size Chase-Lev work-stealing deque
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_WORK_STEALING_DEQUE_H
+#define LMMS_WORK_STEALING_DEQUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lmms
+{
+
+/**
+	@brief Lock-free single-owner deque of pointers (Chase-Lev)
+
+	The owning thread pushes and pops at the bottom, every other thread may
+	steal from the top. The capacity is fixed so that no memory is allocated
+	while processing; push() fails if the deque is full.
+	Memory orderings follow Lê et al., "Correct and Efficient Work-Stealing
+	for Weak Memory Models" (PPoPP 2013).
+*/
+template<typename T, std::size_t Capacity>
+class WorkStealingDeque
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	WorkStealingDeque() :
+		m_top(0),
+		m_bottom(0)
+	{
+		for (auto& item : m_items) { item.store(nullptr, std::memory_order_relaxed); }
+	}
+
+	//! Owner only
+	bool push(T* item)
+	{
+		const auto bottom = m_bottom.load(std::memory_order_relaxed);
+		const auto top = m_top.load(std::memory_order_acquire);
+		if (bottom - top >= static_cast<std::int64_t>(Capacity)) { return false; }
+
+		m_items[bottom & Mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//! Owner only, returns nullptr if the deque is empty
+	T* pop()
+	{
+		const auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// empty
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T* item = m_items[bottom & Mask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// last item, race against thieves
+			if (!m_top.compare_exchange_strong(top, top + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				item = nullptr;
+			}
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	//! Any thread, returns nullptr if the deque is empty or another thread won the race
+	T* steal()
+	{
+		auto top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom) { return nullptr; }
+
+		T* item = m_items[top & Mask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1,
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+		return item;
+	}
+
+	bool empty() const
+	{
+		return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr auto Mask = static_cast<std::int64_t>(Capacity - 1);
+
+	// keep the indices on separate cache lines, thieves only write m_top
+	alignas(64) std::atomic<std::int64_t> m_top;
+	alignas(64) std::atomic<std::int64_t> m_bottom;
+	alignas(64) std::array<std::atomic<T*>, Capacity> m_items;
+};
+
+} // namespace lmms
+
+#endif // LMMS_WORK_STEALING_DEQUE_H
@@ -35,6 +35,7 @@
 #include <concepts>
 
 #include "lmms_constants.h"
+#include "RandomGenerator.h"
 
 #ifdef __SSE2__
 #include <emmintrin.h>
@@ -81,11 +82,10 @@ inline auto absFraction(std::floating_point auto x) noexcept
 	return x - std::floor(x);
 }
 
+//! Random number in [0, 32767], safe to use from several threads at once
 inline auto fastRand() noexcept
 {
-	static unsigned long next = 1;
-	next = next * 1103515245 + 12345;
-	return next / 65536 % 32768;
+	return RandomGenerator::forThread().next() >> 17;
 }
 
 template<std::floating_point T>
@@ -25,6 +25,7 @@
 #include "AudioFileProcessor.h"
 #include "AudioFileProcessorView.h"
 
+#include "AudioEngine.h"
 #include "InstrumentTrack.h"
 #include "PathUtil.h"
 #include "SampleLoader.h"
@@ -141,7 +142,10 @@ void AudioFileProcessor::playNote( NotePlayHandle * _n,
 				interpolationMode = AudioResampler::Mode::Linear;
 				break;
 			case 2:
-				interpolationMode = AudioResampler::Mode::SincMedium;
+				// sinc is expensive, new notes fall back to linear while the audio engine is overloaded
+				interpolationMode = Engine::audioEngine()->voiceGovernor().reducedQuality()
+					? AudioResampler::Mode::Linear
+					: AudioResampler::Mode::SincMedium;
 				break;
 		}
 
@@ -346,7 +346,11 @@ void AudioFileProcessorWaveView::updateGraph()
 	QPainter p(&m_graph);
 	p.setPen(QColor(255, 255, 255));
 
-	m_sampleThumbnail = SampleThumbnail{*m_sample};
+	m_sampleThumbnail = SampleThumbnail{*m_sample, this, [this] {
+		// the graph only shows a placeholder, draw it again even though the range didn't change
+		m_last_amp = -1;
+		update();
+	}};
 
 	const auto param = SampleThumbnail::VisualizeParameters{
 		.sampleRect = m_graph.rect(),
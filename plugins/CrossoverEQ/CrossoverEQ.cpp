@@ -26,6 +26,7 @@
  
 #include "CrossoverEQ.h"
 #include "lmms_math.h"
+#include "MixHelpers.h"
 #include "embed.h"
 #include "plugin_export.h"
 
@@ -134,55 +135,40 @@ Effect::ProcessStatus CrossoverEQEffect::processImpl(SampleFrame* buf, const fpp
 	
 	m_needsUpdate = false;
 	
-	zeroSampleFrames(m_work, frames);
-	
 	// run temp bands
-	for (auto f = std::size_t{0}; f < frames; ++f)
-	{
-		m_tmp1[f][0] = m_lp2.update( buf[f][0], 0 );
-		m_tmp1[f][1] = m_lp2.update( buf[f][1], 1 );
-		m_tmp2[f][0] = m_hp3.update( buf[f][0], 0 );
-		m_tmp2[f][1] = m_hp3.update( buf[f][1], 1 );
-	}
+	m_lp2.process( buf, m_tmp1, frames );
+	m_hp3.process( buf, m_tmp2, frames );
 
 	// run band 1
 	if( mute1 )
 	{
-		for (auto f = std::size_t{0}; f < frames; ++f)
-		{
-			m_work[f][0] += m_lp1.update( m_tmp1[f][0], 0 ) * m_gain1;
-			m_work[f][1] += m_lp1.update( m_tmp1[f][1], 1 ) * m_gain1;
-		}
+		m_lp1.process( m_tmp1, m_work, frames );
+		MixHelpers::multiply( m_work, m_gain1, frames );
 	}
-	
-	// run band 2
+	else
+	{
+		zeroSampleFrames( m_work, frames );
+	}
+
+	// run band 2, the first temp band isn't needed anymore afterwards
 	if( mute2 )
 	{
-		for (auto f = std::size_t{0}; f < frames; ++f)
-		{
-			m_work[f][0] += m_hp2.update( m_tmp1[f][0], 0 ) * m_gain2;
-			m_work[f][1] += m_hp2.update( m_tmp1[f][1], 1 ) * m_gain2;
-		}
+		m_hp2.process( m_tmp1, m_tmp1, frames );
+		MixHelpers::addMultiplied( m_work, m_tmp1, m_gain2, frames );
 	}
-	
+
 	// run band 3
 	if( mute3 )
 	{
-		for (auto f = std::size_t{0}; f < frames; ++f)
-		{
-			m_work[f][0] += m_lp3.update( m_tmp2[f][0], 0 ) * m_gain3;
-			m_work[f][1] += m_lp3.update( m_tmp2[f][1], 1 ) * m_gain3;
-		}
+		m_lp3.process( m_tmp2, m_tmp1, frames );
+		MixHelpers::addMultiplied( m_work, m_tmp1, m_gain3, frames );
 	}
-	
+
 	// run band 4
 	if( mute4 )
 	{
-		for (auto f = std::size_t{0}; f < frames; ++f)
-		{
-			m_work[f][0] += m_hp4.update( m_tmp2[f][0], 0 ) * m_gain4;
-			m_work[f][1] += m_hp4.update( m_tmp2[f][1], 1 ) * m_gain4;
-		}
+		m_hp4.process( m_tmp2, m_tmp2, frames );
+		MixHelpers::addMultiplied( m_work, m_tmp2, m_gain4, frames );
 	}
 	
 	const float d = dryLevel();
@@ -1,5 +1,8 @@
 #include "HydrogenImport.h"
 
+#include <map>
+#include <vector>
+
 #include <QDomDocument>
 
 #include "LocalFileMng.h"
@@ -265,6 +268,8 @@ bool HydrogenImport::readSong()
 		pattern_length[sName] = nSize;
 		QDomNode pNoteListNode = patternNode.firstChildElement( "noteList" );
 		if ( ! pNoteListNode.isNull() ) {
+			// the notes of each clip are added at once
+			std::map<MidiClip*, std::vector<Note>> clipNotes;
 			QDomNode noteNode = pNoteListNode.firstChildElement( "note" );
 			while ( ! noteNode.isNull()  ) {
 				int nPosition = LocalFileMng::readXmlInt( noteNode, "position", 0 );
@@ -291,10 +296,14 @@ bool HydrogenImport::readSong()
 				n.setVolume( fVelocity * 100 );
 				n.setPanning( ( fPan_R - fPan_L ) * 100 );
 				n.setKey( NoteKey::stringToNoteKey( sKey ) );
-				p->addNote( n,false );
+				clipNotes[p].push_back( n );
 				pn = pn + 1;
 				noteNode = ( QDomNode ) noteNode.nextSiblingElement( "note" );
 			}        
+			for( const auto& [clip, notes] : clipNotes )
+			{
+				clip->addNotes( notes, false );
+			}
 		}
 		patternNode = ( QDomNode ) patternNode.nextSiblingElement( "pattern" );
 	}
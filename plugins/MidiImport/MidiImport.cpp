@@ -29,8 +29,10 @@
 #include <QMessageBox>
 #include <QProgressDialog>
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
+#include <vector>
 
 #include "MidiImport.h"
 #include "TrackContainer.h"
@@ -193,6 +195,7 @@ public:
 	Instrument* it_inst = nullptr;
 	bool isSF2 = false;
 	bool hasNotes = false;
+	std::vector<Note> notes;
 	QString trackName;
 
 	smfMidiChannel* create(TrackContainer* tc, QString tn)
@@ -229,8 +232,8 @@ public:
 
 	void addNote(Note& n)
 	{
-		if (!p) { p = dynamic_cast<MidiClip*>(it->createClip(0)); }
-		p->addNote(n, false);
+		// collected and added to the clips at once in splitMidiClips()
+		notes.push_back(n);
 		hasNotes = true;
 	}
 
@@ -238,22 +241,29 @@ public:
 	void splitMidiClips()
 	{
 		MidiClip* newMidiClip = nullptr;
+		std::vector<Note> clipNotes;
 		TimePos lastEnd(0);
 
-		p->rearrangeAllNotes();
-		for (auto n : p->notes())
+		std::stable_sort(notes.begin(), notes.end(),
+			[](const Note& a, const Note& b) { return Note::lessThan(&a, &b); });
+		for (const auto& n : notes)
 		{
-			if (!newMidiClip || n->pos() > lastEnd + DefaultTicksPerBar)
+			if (!newMidiClip || n.pos() > lastEnd + DefaultTicksPerBar)
 			{
-				TimePos pPos = TimePos(n->pos().getBar(), 0);
+				if (newMidiClip) { newMidiClip->addNotes(clipNotes, false); }
+				clipNotes.clear();
+
+				TimePos pPos = TimePos(n.pos().getBar(), 0);
 				newMidiClip = dynamic_cast<MidiClip*>(it->createClip(pPos));
 			}
-			lastEnd = n->pos() + n->length();
+			lastEnd = n.pos() + n.length();
 
-			Note newNote(*n);
-			newNote.setPos(n->pos(newMidiClip->startPosition()));
-			newMidiClip->addNote(newNote, false);
+			Note newNote(n);
+			newNote.setPos(n.pos(newMidiClip->startPosition()));
+			clipNotes.push_back(newNote);
 		}
+		if (newMidiClip) { newMidiClip->addNotes(clipNotes, false); }
+		notes.clear();
 
 		delete p;
 		p = nullptr;
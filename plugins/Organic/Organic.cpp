@@ -33,6 +33,7 @@
 #include "NotePlayHandle.h"
 #include "Oscillator.h"
 #include "PixmapButton.h"
+#include "RandomGenerator.h"
 
 #include "embed.h"
 #include "plugin_export.h"
@@ -236,9 +237,9 @@ void OrganicInstrument::playNote( NotePlayHandle * _n,
 		for( int i = m_numOscillators - 1; i >= 0; --i )
 		{
 			static_cast<oscPtr *>( _n->m_pluginData )->phaseOffsetLeft[i]
-				= rand() / (static_cast<float>(RAND_MAX) + 1.0f);
+				= RandomGenerator::forThread().unipolar();
 			static_cast<oscPtr *>( _n->m_pluginData )->phaseOffsetRight[i]
-				= rand() / (static_cast<float>(RAND_MAX) + 1.0f);
+				= RandomGenerator::forThread().unipolar();
 
 			// initialise ocillators
 
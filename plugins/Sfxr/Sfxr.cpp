@@ -46,6 +46,7 @@ float frnd(float range)
 #include "Knob.h"
 #include "NotePlayHandle.h"
 #include "PixmapButton.h"
+#include "RandomGenerator.h"
 #include "MidiEvent.h"
 
 #include "embed.h"
@@ -143,10 +144,7 @@ void SfxrSynth::resetSample( bool restart )
 		ipp=0;
 		
 		phaser_buffer.fill(0.0f);
-		for (auto& noiseSample : noise_buffer) 
-		{
-			noiseSample = frnd(2.0f) - 1.0f; 
-		}
+		RandomGenerator::forThread().fillBipolar(noise_buffer, std::size(noise_buffer));
 
 		rep_time=0;
 		rep_limit = static_cast<int>(std::pow(1.0f - s->m_repeatSpeedModel.value(), 2.0f) * 20000 + 32);
@@ -241,10 +239,7 @@ void SfxrSynth::update( SampleFrame* buffer, const int32_t frameNum )
 //				phase=0;
 				phase%=period;
 				if(s->m_waveFormModel.value()==3)
-					for (auto& noiseSample : noise_buffer) 
-					{
-						noiseSample = frnd(2.0f) - 1.0f;
-					}
+					RandomGenerator::forThread().fillBipolar(noise_buffer, std::size(noise_buffer));
 			}
 			// base waveform
 			float fp=(float)phase/period;
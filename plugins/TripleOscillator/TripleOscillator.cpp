@@ -23,6 +23,8 @@
  */
 
 
+#include <algorithm>
+
 #include <QDomElement>
 #include <QFileInfo>
 
@@ -139,8 +141,12 @@ void OscillatorObject::oscUserDefWaveDblClick()
 	auto af = gui::SampleLoader::openWaveformFile();
 	if( af != "" )
 	{
-		m_sampleBuffer = gui::SampleLoader::createBufferFromFile(af);
-		m_userAntiAliasWaveTable = Oscillator::generateAntiAliasUserWaveTable(m_sampleBuffer.get());
+		auto sampleBuffer = gui::SampleLoader::createBufferFromFile(af);
+		auto userAntiAliasWaveTable = Oscillator::generateAntiAliasUserWaveTable(sampleBuffer.get());
+		// playing notes use the buffers directly
+		const auto guard = Engine::audioEngine()->requestChangesGuard();
+		m_sampleBuffer = std::move(sampleBuffer);
+		m_userAntiAliasWaveTable = std::move(userAntiAliasWaveTable);
 		// TODO:
 		//m_usrWaveBtn->setToolTip(m_sampleBuffer->audioFile());
 	}
@@ -284,8 +290,11 @@ void TripleOscillator::loadSettings( const QDomElement & _this )
 		{
 			if (QFileInfo(PathUtil::toAbsolute(userWaveFile)).exists())
 			{
-				m_osc[i]->m_sampleBuffer = gui::SampleLoader::createBufferFromFile(userWaveFile);
-				m_osc[i]->m_userAntiAliasWaveTable = Oscillator::generateAntiAliasUserWaveTable(m_osc[i]->m_sampleBuffer.get());
+				auto sampleBuffer = gui::SampleLoader::createBufferFromFile(userWaveFile);
+				auto userAntiAliasWaveTable = Oscillator::generateAntiAliasUserWaveTable(sampleBuffer.get());
+				const auto guard = Engine::audioEngine()->requestChangesGuard();
+				m_osc[i]->m_sampleBuffer = std::move(sampleBuffer);
+				m_osc[i]->m_userAntiAliasWaveTable = std::move(userAntiAliasWaveTable);
 			}
 			else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), userWaveFile)); }
 		}
@@ -303,80 +312,124 @@ QString TripleOscillator::nodeName() const
 
 
 
+TripleOscillator::Chain TripleOscillator::chain(bool right) const
+{
+	auto stages = Chain{};
+	for (int i = 0; i < NUM_OF_OSCILLATORS; ++i)
+	{
+		const OscillatorObject* osc = m_osc[i];
+		stages[i] = {
+			static_cast<Oscillator::WaveShape>(osc->m_waveShapeModel.value()),
+			static_cast<Oscillator::ModulationAlgo>(osc->m_modulationAlgoModel.value()),
+			right ? osc->m_detuningRight : osc->m_detuningLeft,
+			right ? osc->m_phaseOffsetRight : osc->m_phaseOffsetLeft,
+			right ? osc->m_volumeRight : osc->m_volumeLeft,
+			osc->m_useWaveTable,
+			osc->m_sampleBuffer.get(),
+			osc->m_userAntiAliasWaveTable.get()
+		};
+	}
+	return stages;
+}
+
+
+
+
+TripleOscillator::VoiceBatch* TripleOscillator::acquireVoice(NotePlayHandle* n, const std::array<Chain, 2>& chains)
+{
+	const auto start = [&](VoiceBatch& batch, int lane) {
+		batch.notes[lane] = n;
+		batch.startPeriods[lane] = AutomatableModel::periodCounter();
+		batch.oscillators[0].startVoice(lane, chains[0]);
+		batch.oscillators[1].startVoice(lane, chains[1]);
+	};
+
+	const auto lock = std::lock_guard{m_voiceBatchesMutex};
+	for (const auto& batch : m_voiceBatches)
+	{
+		const auto batchLock = std::lock_guard{batch->mutex};
+		const auto it = std::find(batch->notes.begin(), batch->notes.end(), nullptr);
+		if (it != batch->notes.end())
+		{
+			start(*batch, static_cast<int>(it - batch->notes.begin()));
+			return batch.get();
+		}
+	}
+
+	auto& batch = m_voiceBatches.emplace_back(std::make_unique<VoiceBatch>());
+	batch->output.resize(2 * OscillatorBatch::Lanes * Engine::audioEngine()->framesPerPeriod());
+	start(*batch, 0);
+	return batch.get();
+}
+
+
+
+
 void TripleOscillator::playNote( NotePlayHandle * _n,
 						SampleFrame* _working_buffer )
 {
+	const auto chains = std::array{chain(false), chain(true)};
 	if (!_n->m_pluginData)
 	{
-		auto oscs_l = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
-		auto oscs_r = std::array<Oscillator*, NUM_OF_OSCILLATORS>{};
+		_n->m_pluginData = acquireVoice(_n, chains);
+	}
+	auto batch = static_cast<VoiceBatch*>(_n->m_pluginData);
 
-		for( int i = NUM_OF_OSCILLATORS - 1; i >= 0; --i )
-		{
+	const fpp_t frames = _n->framesLeftForCurrentPeriod();
+	const f_cnt_t offset = _n->noteOffset();
+	const auto period = AutomatableModel::periodCounter();
 
-			// the last oscs needs no sub-oscs...
-			if( i == NUM_OF_OSCILLATORS - 1 )
+	{
+		const auto lock = std::lock_guard{batch->mutex};
+		const auto lane = static_cast<int>(std::find(batch->notes.begin(), batch->notes.end(), _n) - batch->notes.begin());
+
+		if (batch->startPeriods[lane] == period)
+		{
+			// the first period of a note starts at its offset, so it can't be
+			// rendered together with the other notes
+			for (ch_cnt_t chnl = 0; chnl < 2; ++chnl)
 			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft );
-				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight );
-				oscs_r[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
+				batch->oscillators[chnl].renderVoice(lane, chains[chnl], _n->frequency(),
+					_working_buffer + offset, frames, chnl);
 			}
-			else
+		}
+		else
+		{
+			const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+			if (batch->renderedPeriod != period)
 			{
-				oscs_l[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningLeft,
-						m_osc[i]->m_phaseOffsetLeft,
-						m_osc[i]->m_volumeLeft,
-						oscs_l[i + 1] );
-				oscs_l[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
-				oscs_r[i] = new Oscillator(
-						&m_osc[i]->m_waveShapeModel,
-						&m_osc[i]->m_modulationAlgoModel,
-						_n->frequency(),
-						m_osc[i]->m_detuningRight,
-						m_osc[i]->m_phaseOffsetRight,
-						m_osc[i]->m_volumeRight,
-						oscs_r[i + 1] );
-				oscs_r[i]->setUseWaveTable(m_osc[i]->m_useWaveTable);
+				// the first note played in this period renders all notes of the
+				// batch, the frequencies of other notes only change while no
+				// notes are played
+				auto freqs = std::array<float, OscillatorBatch::Lanes>{};
+				auto lanes = 0u;
+				for (int l = 0; l < OscillatorBatch::Lanes; ++l)
+				{
+					if (batch->notes[l] && batch->startPeriods[l] != period)
+					{
+						freqs[l] = batch->notes[l]->frequency();
+						lanes |= 1u << l;
+					}
+				}
+				for (ch_cnt_t chnl = 0; chnl < 2; ++chnl)
+				{
+					batch->oscillators[chnl].render(chains[chnl], freqs, lanes,
+						batch->output.data() + chnl * fpp * OscillatorBatch::Lanes, fpp);
+				}
+				batch->renderedPeriod = period;
 			}
 
-			oscs_l[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-			oscs_r[i]->setUserWave( m_osc[i]->m_sampleBuffer );
-			oscs_l[i]->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
-			oscs_r[i]->setUserAntiAliasWaveTable(m_osc[i]->m_userAntiAliasWaveTable);
+			for (ch_cnt_t chnl = 0; chnl < 2; ++chnl)
+			{
+				const float* out = batch->output.data() + chnl * fpp * OscillatorBatch::Lanes + lane;
+				for (fpp_t f = 0; f < frames; ++f)
+				{
+					_working_buffer[offset + f][chnl] = out[f * OscillatorBatch::Lanes];
+				}
+			}
 		}
-
-		_n->m_pluginData = new oscPtr;
-		static_cast<oscPtr *>( _n->m_pluginData )->oscLeft = oscs_l[0];
-		static_cast< oscPtr *>( _n->m_pluginData )->oscRight =
-								oscs_r[0];
 	}
 
-	Oscillator * osc_l = static_cast<oscPtr *>( _n->m_pluginData )->oscLeft;
-	Oscillator * osc_r = static_cast<oscPtr *>( _n->m_pluginData )->oscRight;
-
-	const fpp_t frames = _n->framesLeftForCurrentPeriod();
-	const f_cnt_t offset = _n->noteOffset();
-
-	osc_l->update( _working_buffer + offset, frames, 0 );
-	osc_r->update( _working_buffer + offset, frames, 1 );
-
 	applyFadeIn(_working_buffer, _n);
 	applyRelease( _working_buffer, _n );
 }
@@ -386,11 +439,9 @@ void TripleOscillator::playNote( NotePlayHandle * _n,
 
 void TripleOscillator::deleteNotePluginData( NotePlayHandle * _n )
 {
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscLeft );
-	delete static_cast<Oscillator *>( static_cast<oscPtr *>(
-						_n->m_pluginData )->oscRight );
-	delete static_cast<oscPtr *>( _n->m_pluginData );
+	auto batch = static_cast<VoiceBatch*>(_n->m_pluginData);
+	const auto lock = std::lock_guard{batch->mutex};
+	std::replace(batch->notes.begin(), batch->notes.end(), _n, static_cast<NotePlayHandle*>(nullptr));
 }
 
 
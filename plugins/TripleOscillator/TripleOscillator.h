@@ -26,11 +26,15 @@
 #ifndef _TRIPLE_OSCILLATOR_H
 #define _TRIPLE_OSCILLATOR_H
 
+#include <array>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Instrument.h"
 #include "InstrumentView.h"
 #include "AutomatableModel.h"
+#include "OscillatorBatch.h"
 #include "OscillatorConstants.h"
 #include "SampleBuffer.h"
 
@@ -39,7 +43,6 @@ namespace lmms
 
 
 class NotePlayHandle;  // IWYU pragma: keep
-class Oscillator;
 
 
 namespace gui
@@ -133,14 +136,30 @@ protected slots:
 
 
 private:
-	OscillatorObject * m_osc[NUM_OF_OSCILLATORS];
+	using Chain = std::array<OscillatorBatch::Stage, NUM_OF_OSCILLATORS>;
 
-	struct oscPtr
+	//! Up to OscillatorBatch::Lanes notes whose oscillators are rendered together
+	struct VoiceBatch
 	{
-		Oscillator * oscLeft;
-		Oscillator * oscRight;
+		std::mutex mutex;
+		//! Left and right channel
+		std::array<OscillatorBatch, 2> oscillators;
+		std::array<NotePlayHandle*, OscillatorBatch::Lanes> notes = {};
+		//! Period in which the note of a lane started playing
+		std::array<long, OscillatorBatch::Lanes> startPeriods = {};
+		long renderedPeriod = -1;
+		//! Both channels of all lanes of the last rendered period
+		std::vector<float> output;
 	} ;
 
+	Chain chain(bool right) const;
+	VoiceBatch* acquireVoice(NotePlayHandle* n, const std::array<Chain, 2>& chains);
+
+	OscillatorObject * m_osc[NUM_OF_OSCILLATORS];
+
+	std::mutex m_voiceBatchesMutex;
+	std::vector<std::unique_ptr<VoiceBatch>> m_voiceBatches;
+
 
 	friend class gui::TripleOscillatorView;
 
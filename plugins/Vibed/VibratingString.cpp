@@ -29,7 +29,6 @@
 #include "LmmsTypes.h"
 
 #include <algorithm>
-#include <cstdlib>
 
 namespace lmms
 {
@@ -40,7 +39,7 @@ VibratingString::VibratingString(float pitch, float pick, float pickup, const fl
 	m_oversample{2 * oversample / static_cast<int>(sampleRate / Engine::audioEngine()->baseSampleRate())},
 	m_randomize{randomize},
 	m_stringLoss{1.0f - stringLoss},
-	m_choice{static_cast<int>(m_oversample * static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX))},
+	m_choice{static_cast<int>(m_oversample * RandomGenerator::forThread().unipolar())},
 	m_state{0.1f},
 	m_outsamp{std::make_unique<sample_t[]>(m_oversample)}
 {
@@ -76,9 +75,10 @@ std::unique_ptr<VibratingString::DelayLine> VibratingString::initDelayLine(int l
 	if (len > 0)
 	{
 		dl->data = std::make_unique<sample_t[]>(len);
+		auto& random = RandomGenerator::forThread();
 		for (int i = 0; i < dl->length; ++i)
 		{
-			float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+			float r = random.unipolar();
 			float offset = (m_randomize / 2.0f - m_randomize) * r;
 			dl->data[i] = offset;
 		}
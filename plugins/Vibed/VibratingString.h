@@ -26,9 +26,9 @@
 #define LMMS_VIBRATING_STRING_H
 
 #include <memory>
-#include <cstdlib>
 
 #include "LmmsTypes.h"
+#include "RandomGenerator.h"
 
 namespace lmms
 {
@@ -103,17 +103,18 @@ private:
 	 */
 	void setDelayLine(DelayLine* dl, int pick, const float* values, int len, float scale, bool state)
 	{
+		auto& random = RandomGenerator::forThread();
 		if (!state)
 		{
 			for (int i = 0; i < pick; ++i)
 			{
-				float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+				float r = random.unipolar();
 				float offset = (m_randomize / 2.0f - m_randomize) * r;
 				dl->data[i] = scale * values[dl->length - i - 1] + offset;
 			}
 			for (int i = pick; i < dl->length; ++i)
 			{
-				float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+				float r = random.unipolar();
 				float offset = (m_randomize / 2.0f - m_randomize) * r;
 				dl->data[i] = scale * values[i - pick]  + offset;
 			}
@@ -124,7 +125,7 @@ private:
 			{
 				for (int i = pick; i < dl->length; ++i)
 				{
-					float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+					float r = random.unipolar();
 					float offset = (m_randomize / 2.0f - m_randomize) * r;
 					dl->data[i] = scale * values[i - pick] + offset;
 				}
@@ -133,7 +134,7 @@ private:
 			{
 				for (int i = 0; i < len; ++i)
 				{
-					float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+					float r = random.unipolar();
 					float offset = (m_randomize / 2.0f - m_randomize) * r;
 					dl->data[i+pick] = scale * values[i] + offset;
 				}
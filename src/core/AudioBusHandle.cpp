@@ -28,6 +28,8 @@
 #include "AudioBusHandle.h"
 #include "AudioDevice.h"
 #include "AudioEngine.h"
+#include "AudioEngineWorkerThread.h"
+#include "AudioTap.h"
 #include "EffectChain.h"
 #include "Mixer.h"
 #include "Engine.h"
@@ -40,6 +42,7 @@ namespace lmms
 AudioBusHandle::AudioBusHandle(const QString& name, bool hasEffectChain,
 	FloatModel* volumeModel, FloatModel* panningModel,
 	BoolModel* mutedModel) :
+	ThreadableJob(TraceRecorder::Category::AudioBusHandle),
 	m_bufferUsage(false),
 	m_buffer(BufferManager::acquire()),
 	m_extOutputEnabled(false),
@@ -48,8 +51,12 @@ AudioBusHandle::AudioBusHandle(const QString& name, bool hasEffectChain,
 	m_effects(hasEffectChain ? new EffectChain(nullptr) : nullptr),
 	m_volumeModel(volumeModel),
 	m_panningModel(panningModel),
-	m_mutedModel(mutedModel)
+	m_mutedModel(mutedModel),
+	m_dependencies(0),
+	m_dependenciesMet(0),
+	m_currentMixerChannel(0)
 {
+	setTraceName(name);
 	Engine::audioEngine()->addAudioBusHandle(this);
 	setExtOutputEnabled(true);
 }
@@ -89,12 +96,22 @@ void AudioBusHandle::setExtOutputEnabled(bool enabled)
 void AudioBusHandle::setName(const QString& newName)
 {
 	m_name = newName;
+	setTraceName(newName);
 	Engine::audioEngine()->audioDev()->renamePort(this);
 }
 
 
 
 
+void AudioBusHandle::setTap(AudioTap* tap)
+{
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
+	m_tap = tap;
+}
+
+
+
+
 bool AudioBusHandle::processEffects()
 {
 	if (m_effects)
@@ -110,6 +127,8 @@ void AudioBusHandle::doProcessing()
 {
 	if (m_mutedModel && m_mutedModel->value())
 	{
+		// our mixer channel still waits for us
+		Engine::mixer()->channelInputProcessed(m_currentMixerChannel);
 		return;
 	}
 
@@ -135,6 +154,10 @@ void AudioBusHandle::doProcessing()
 		}
 	}
 
+	// constant volume and panning are applied while mixing into the mixer channel
+	float gainLeft = 1.0f;
+	float gainRight = 1.0f;
+
 	if (m_bufferUsage)
 	{
 		// handle volume and panning
@@ -187,11 +210,8 @@ void AudioBusHandle::doProcessing()
 			{
 				float p = m_panningModel->value() * 0.01f;
 				float v = m_volumeModel->value() * 0.01f;
-				for (f_cnt_t f = 0; f < fpp; ++f)
-				{
-					m_buffer[f][0] *= (p <= 0 ? 1.0f : 1.0f - p) * v;
-					m_buffer[f][1] *= (p >= 0 ? 1.0f : 1.0f + p) * v;
-				}
+				gainLeft = (p <= 0 ? 1.0f : 1.0f - p) * v;
+				gainRight = (p >= 0 ? 1.0f : 1.0f + p) * v;
 			}
 		}
 
@@ -211,29 +231,65 @@ void AudioBusHandle::doProcessing()
 			}
 			else
 			{
-				float v = m_volumeModel->value() * 0.01f;
-				for (f_cnt_t f = 0; f < fpp; ++f)
-				{
-					m_buffer[f][0] *= v;
-					m_buffer[f][1] *= v;
-				}
+				gainLeft = gainRight = m_volumeModel->value() * 0.01f;
 			}
 		}
 	}
 	// as of now there's no situation where we only have panning model but no volume model
 	// if we have neither, we don't have to do anything here - just pass the audio as is
 
+	// effects have to see the signal after volume and panning
+	if (m_effects && m_effects->isEnabled() && (gainLeft != 1.0f || gainRight != 1.0f))
+	{
+		MixHelpers::multiplyStereo(m_buffer, gainLeft, gainRight, fpp);
+		gainLeft = gainRight = 1.0f;
+	}
+
 	// handle effects
 	const bool anyOutputAfterEffects = processEffects();
+
+	// stems are taken where the track enters its mixer channel
+	if (m_tap)
+	{
+		m_tap->write(m_buffer, gainLeft, gainRight, fpp);
+	}
 	if (anyOutputAfterEffects || m_bufferUsage)
 	{
-		Engine::mixer()->mixToChannel(m_buffer, m_nextMixerChannel);	// send output to mixer
-																		// TODO: improve the flow here - convert to pull model
+		// send output to mixer
+		Engine::mixer()->mixToChannel(m_buffer, m_currentMixerChannel, gainLeft, gainRight);
 		m_bufferUsage = false;
 	}
+
+	// our mixer channel may start as soon as all of its inputs are processed
+	Engine::mixer()->channelInputProcessed(m_currentMixerChannel);
+}
+
+
+void AudioBusHandle::resetDependencies()
+{
+	m_dependencies = 0;
+	m_dependenciesMet = 0;
+
+	// the target channel must not change while the graph is processed,
+	// otherwise the wrong mixer channel would wait for us
+	m_currentMixerChannel = m_nextMixerChannel;
+	Engine::mixer()->addChannelInput(m_currentMixerChannel);
+}
+
+
+
+
+void AudioBusHandle::incrementDeps()
+{
+	if (++m_dependenciesMet == m_dependencies)
+	{
+		AudioEngineWorkerThread::addJob(this);
+	}
 }
 
 
+
+
 void AudioBusHandle::addPlayHandle(PlayHandle* handle)
 {
 	QMutexLocker lockGuard(&m_playHandleLock);
@@ -24,7 +24,6 @@
 
 #include "AudioEngine.h"
 
-#include "MixHelpers.h"
 #include "denormals.h"
 
 #include "lmmsconfig.h"
@@ -59,6 +58,8 @@
 #include "MidiDummy.h"
 
 #include "BufferManager.h"
+#include "CpuMeter.h"
+#include "TraceRecorder.h"
 
 namespace lmms
 {
@@ -86,6 +87,7 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_oldAudioDev( nullptr ),
 	m_audioDevStartFailed( false ),
 	m_profiler(),
+	m_voiceGovernor(),
 	m_clearSignal(false)
 {
 	for( int i = 0; i < 2; ++i )
@@ -127,8 +129,12 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 		}
 	}
 
+	// a deeper FIFO than needed for the buffer size trades latency for
+	// more headroom against load peaks
+	fifoSize = std::max(fifoSize, ConfigManager::inst()->value("audioengine", "fifodepth").toInt());
+
 	// allocate the FIFO from the determined size
-	m_fifo = new Fifo( fifoSize );
+	m_fifo = new Fifo( fifoSize, m_framesPerPeriod );
 
 	// now that framesPerPeriod is fixed initialize global BufferManager
 	BufferManager::init( m_framesPerPeriod );
@@ -137,6 +143,14 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_outputBufferWrite = std::make_unique<SampleFrame[]>(m_framesPerPeriod);
 
 
+	CpuMeter::setEnabled(ConfigManager::inst()->value("audioengine", "cpumeters").toInt());
+
+	// the work-stealing scheduler can be disabled to compare it against the shared job queue
+	const bool workStealing = ConfigManager::inst()->value("audioengine", "workstealing", "1").toInt();
+	AudioEngineWorkerThread::setupJobQueue(workStealing
+		? AudioEngineWorkerThread::JobQueue::SchedulingMode::WorkStealing
+		: AudioEngineWorkerThread::JobQueue::SchedulingMode::Shared, m_numWorkers + 1);
+
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
 		auto wt = new AudioEngineWorkerThread(this);
@@ -165,10 +179,6 @@ AudioEngine::~AudioEngine()
 		m_workers[w]->wait( 500 );
 	}
 
-	while( m_fifo->available() )
-	{
-		delete[] m_fifo->read();
-	}
 	delete m_fifo;
 
 	delete m_midiClient;
@@ -179,6 +189,14 @@ AudioEngine::~AudioEngine()
 	{
 		delete[] input;
 	}
+
+	const auto bufferStats = BufferManager::statistics();
+	if (m_profiler.isProfiling() && bufferStats.misses > 0)
+	{
+		qWarning("BufferManager: %zu of %zu buffers had to be allocated from the heap, at most %zu were in use. "
+			"Consider raising audioengine/bufferpoolsize.",
+			bufferStats.misses, bufferStats.hits + bufferStats.misses, bufferStats.highWater);
+	}
 }
 
 
@@ -326,26 +344,52 @@ void AudioEngine::renderStageNoteSetup()
 		m_newPlayHandles.free( e );
 		e = next;
 	}
+
+	// make room if the last period took too long
+	m_voiceGovernor.shed(m_playHandles);
 }
 
 
 
-void AudioEngine::renderStageInstruments()
+void AudioEngine::renderStageProcessing()
 {
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Instruments);
+	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Processing);
 
-	AudioEngineWorkerThread::fillJobQueue(m_playHandles);
-	AudioEngineWorkerThread::startAndWaitForJobs();
-}
+	// STAGE 1: process the whole period as one dependency graph. Each play handle
+	// has to be processed before its audio bus handle, each audio bus handle
+	// before its mixer channel and each mixer channel before the channels it
+	// sends to. A job is queued as soon as all of its inputs are done, so cheap
+	// tracks do not have to wait for the slowest instrument of the period.
+	AudioEngineWorkerThread::resetJobQueue(AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic);
 
+	// set up all dependency counters before the first job gets queued
+	for (const auto& busHandle : m_audioBusHandles)
+	{
+		busHandle->resetDependencies();
+	}
+	for (const auto& playHandle : m_playHandles)
+	{
+		playHandle->audioBusHandle()->addDependency();
+	}
 
+	Engine::mixer()->scheduleChannels();
 
-void AudioEngine::renderStageEffects()
-{
-	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Effects);
+	for (const auto& playHandle : m_playHandles)
+	{
+		if (!AudioEngineWorkerThread::addJob(playHandle))
+		{
+			// finished play handles are not processed anymore
+			playHandle->audioBusHandle()->incrementDeps();
+		}
+	}
+	for (const auto& busHandle : m_audioBusHandles)
+	{
+		if (busHandle->dependencies() == 0)
+		{
+			AudioEngineWorkerThread::addJob(busHandle);
+		}
+	}
 
-	// STAGE 2: process effects of all instrument- and sampletracks
-	AudioEngineWorkerThread::fillJobQueue(m_audioBusHandles);
 	AudioEngineWorkerThread::startAndWaitForJobs();
 
 	// removed all play handles which are done
@@ -382,9 +426,9 @@ void AudioEngine::renderStageMix()
 	AudioEngineProfiler::Probe profilerProbe(m_profiler, AudioEngineProfiler::DetailType::Mixing);
 
 	Mixer *mixer = Engine::mixer();
-	mixer->masterMix(m_outputBufferWrite.get());
-
-	MixHelpers::multiply(m_outputBufferWrite.get(), m_masterGain, m_framesPerPeriod);
+	// the output buffer is cleared in swapBuffers(), so applying the master
+	// gain while mixing is the same as multiplying afterwards
+	mixer->masterMix(m_outputBufferWrite.get(), m_masterGain);
 
 	emit nextAudioBuffer(m_outputBufferRead.get());
 
@@ -404,12 +448,13 @@ const SampleFrame* AudioEngine::renderNextBuffer()
 	s_renderingThread = true;
 
 	renderStageNoteSetup();     // STAGE 0: clear old play handles and buffers, setup new play handles
-	renderStageInstruments();   // STAGE 1: run and render all play handles
-	renderStageEffects();       // STAGE 2: process effects of all instrument- and sampletracks
-	renderStageMix();           // STAGE 3: do master mix in mixer
+	renderStageProcessing();    // STAGE 1: render all play handles, audio bus handles and mixer channels
+	renderStageMix();           // STAGE 2: do master mix in mixer
 
 	s_renderingThread = false;
 	m_profiler.finishPeriod(outputSampleRate(), m_framesPerPeriod);
+	m_voiceGovernor.finishPeriod(m_profiler.periodTime(),
+		static_cast<int>(1000000ull * m_framesPerPeriod / outputSampleRate()));
 
 	return m_outputBufferRead.get();
 }
@@ -542,10 +587,9 @@ void AudioEngine::removeAudioBusHandle(AudioBusHandle* busHandle)
 
 bool AudioEngine::addPlayHandle( PlayHandle* handle )
 {
-	// Only add play handles if we have the CPU capacity to process them.
-	// Instrument play handles are not added during playback, but when the
-	// associated instrument is created, so add those unconditionally.
-	if (handle->type() == PlayHandle::Type::InstrumentPlayHandle || !criticalXRuns())
+	// Only add play handles if we have the CPU capacity to process them,
+	// depending on the policy, the governor makes room by shedding old voices instead
+	if (m_voiceGovernor.admit(handle))
 	{
 		m_newPlayHandles.push( handle );
 		handle->audioBusHandle()->addPlayHandle(handle);
@@ -1074,18 +1118,19 @@ void AudioEngine::fifoWriter::finish()
 void AudioEngine::fifoWriter::run()
 {
 	disable_denormals();
+	TraceRecorder::setThreadName("Audio engine");
 
 	const fpp_t frames = m_audioEngine->framesPerPeriod();
 	while( m_writing )
 	{
-		auto buffer = new SampleFrame[frames];
+		SampleFrame* buffer = m_fifo->beginWrite();
 		const SampleFrame* b = m_audioEngine->renderNextBuffer();
 		memcpy(buffer, b, frames * sizeof(SampleFrame));
-		m_fifo->write(buffer);
+		m_fifo->endWrite();
 	}
 
 	// Let audio backend stop processing
-	m_fifo->write(nullptr);
+	m_fifo->writeEndOfStream();
 	m_fifo->waitUntilRead();
 }
 
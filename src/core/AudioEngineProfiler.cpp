@@ -26,6 +26,15 @@
 
 #include <cstdint>
 
+#include "CpuMeter.h"
+#include "Effect.h"
+#include "Engine.h"
+#include "Instrument.h"
+#include "InstrumentTrack.h"
+#include "Mixer.h"
+#include "PatternStore.h"
+#include "Song.h"
+
 namespace lmms
 {
 
@@ -34,6 +43,20 @@ AudioEngineProfiler::AudioEngineProfiler() :
 	m_cpuLoad( 0 ),
 	m_outputFile()
 {
+	m_detailNames[static_cast<std::size_t>(DetailType::NoteSetup)] = TraceRecorder::intern("Note setup");
+	m_detailNames[static_cast<std::size_t>(DetailType::Processing)] = TraceRecorder::intern("Processing");
+	m_detailNames[static_cast<std::size_t>(DetailType::Mixing)] = TraceRecorder::intern("Mixing");
+}
+
+
+
+
+AudioEngineProfiler::~AudioEngineProfiler()
+{
+	if (!m_outputFile.isEmpty() || !m_traceFile.isEmpty())
+	{
+		TraceRecorder::stop();
+	}
 }
 
 
@@ -42,6 +65,7 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 {
 	// Time taken to process all data and fill the audio buffer.
 	const unsigned int periodElapsed = m_periodTimer.elapsed();
+	m_periodTime = periodElapsed;
 	// Maximum time the processing can take before causing buffer underflow. Convert to us.
 	const uint64_t timeLimit = static_cast<uint64_t>(1000000) * framesPerPeriod / sampleRate;
 
@@ -59,9 +83,13 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 		m_detailLoad[i].store(newLoad * 0.05f + oldLoad * 0.95f, std::memory_order_relaxed);
 	}
 
-	if( m_outputFile.isOpen() )
+	CpuMeter::finishPeriod(timeLimit * 1000);
+
+	// written to the output file by the thread of TraceRecorder, not here
+	if (m_periodBegin != 0)
 	{
-		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
+		TraceRecorder::record({0, m_periodBegin, TraceRecorder::now(), TraceRecorder::Unnamed,
+			TraceRecorder::Category::Period});
 	}
 }
 
@@ -69,9 +97,69 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 
 void AudioEngineProfiler::setOutputFile( const QString& outputFile )
 {
-	m_outputFile.close();
-	m_outputFile.setFileName( outputFile );
-	m_outputFile.open( QFile::WriteOnly | QFile::Truncate );
+	m_outputFile = outputFile;
+	restartTrace();
+}
+
+
+
+void AudioEngineProfiler::setTraceFile(const QString& traceFile)
+{
+	m_traceFile = traceFile;
+	restartTrace();
+}
+
+
+
+void AudioEngineProfiler::restartTrace()
+{
+	TraceRecorder::start(m_traceFile, m_outputFile);
+}
+
+
+
+QString AudioEngineProfiler::cpuMeterReport()
+{
+	// names are padded by hand, arg() would expand placeholders in them
+	QString report = QString{"Name"}.leftJustified(40) + QString{"Avg %"}.rightJustified(9)
+		+ QString{"Worst %"}.rightJustified(9) + QString{"Total ms"}.rightJustified(11) + '\n';
+
+	const auto addLine = [&](const QString& name, const CpuMeter& meter) {
+		report += name.leftJustified(40, ' ', true)
+			+ QString::number(meter.averageLoad(), 'f', 2).rightJustified(9)
+			+ QString::number(meter.worstLoad(), 'f', 2).rightJustified(9)
+			+ QString::number(meter.totalTime() / 1000., 'f', 1).rightJustified(11) + '\n';
+	};
+	const auto addEffects = [&](const EffectChain* chain) {
+		if (!chain) { return; }
+		for (const auto effect : chain->effects())
+		{
+			addLine("    " + effect->displayName(), effect->cpuMeter());
+		}
+	};
+
+	for (const auto& tracks : {Engine::getSong()->tracks(), Engine::patternStore()->tracks()})
+	{
+		for (const auto track : tracks)
+		{
+			const auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track);
+			if (!instrumentTrack || !instrumentTrack->instrument()) { continue; }
+
+			addLine(QString("%1 (%2)").arg(instrumentTrack->name(), instrumentTrack->instrumentName()),
+				instrumentTrack->instrument()->cpuMeter());
+			addEffects(instrumentTrack->audioBusHandle()->effects());
+		}
+	}
+
+	const auto mixer = Engine::mixer();
+	for (mix_ch_t i = 0; i < mixer->numChannels(); ++i)
+	{
+		const auto channel = mixer->mixerChannel(i);
+		addLine(QString::number(i) + ": " + channel->m_name, channel->m_cpuMeter);
+		addEffects(&channel->m_fxChain);
+	}
+
+	return report;
 }
 
 } // namespace lmms
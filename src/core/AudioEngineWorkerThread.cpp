@@ -28,9 +28,13 @@
 #include <QMutex>
 #include <QWaitCondition>
 
+#include <limits>
+#include <thread>
+
 #include "denormals.h"
 #include "AudioEngine.h"
 #include "ThreadableJob.h"
+#include "TraceRecorder.h"
 
 #if __SSE__
 #include <xmmintrin.h>
@@ -41,9 +45,33 @@ namespace lmms
 
 AudioEngineWorkerThread::JobQueue AudioEngineWorkerThread::globalJobQueue;
 QWaitCondition * AudioEngineWorkerThread::queueReadyWaitCond = nullptr;
+std::atomic_uint AudioEngineWorkerThread::queueReadyGeneration = 0;
 QList<AudioEngineWorkerThread *> AudioEngineWorkerThread::workerThreads;
 
+// index of the deque owned by the current thread - threads which are no
+// worker threads (i.e. the audio engine thread) use the last one
+static thread_local size_t s_threadIndex = std::numeric_limits<size_t>::max();
+
+// number of unsuccessful steal attempts before an idle thread yields
+constexpr int IdleSpinCount = 64;
+
 // implementation of internal JobQueue
+void AudioEngineWorkerThread::JobQueue::setup( SchedulingMode _mode, size_t _numThreads )
+{
+	m_schedulingMode = _mode;
+	m_deques.clear();
+	if( m_schedulingMode == SchedulingMode::WorkStealing )
+	{
+		for( size_t i = 0; i < std::max<size_t>( _numThreads, 1 ); ++i )
+		{
+			m_deques.push_back( std::make_unique<Deque>() );
+		}
+	}
+}
+
+
+
+
 void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 {
 	m_writeIndex = 0;
@@ -54,26 +82,60 @@ void AudioEngineWorkerThread::JobQueue::reset( OperationMode _opMode )
 
 
 
-void AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
+bool AudioEngineWorkerThread::JobQueue::addJob( ThreadableJob * _job )
 {
 	if( _job->requiresProcessing() )
 	{
 		// update job state
 		_job->queue();
+
+		if( m_schedulingMode == SchedulingMode::WorkStealing )
+		{
+			// count the job before other threads can see it, so that
+			// wait() cannot return before it has been processed
+			++m_writeIndex;
+			if( !ownDeque().push( _job ) )
+			{
+				qWarning() << "Job queue is full!";
+				_job->process();
+				++m_itemsDone;
+			}
+			return true;
+		}
+
 		// actually queue the job via atomic operations
 		auto index = m_writeIndex++;
 		if (index < JOB_QUEUE_SIZE) {
 			m_items[index] = _job;
 		} else {
 			qWarning() << "Job queue is full!";
+			// process it right away, jobs depending on it would wait forever otherwise
+			_job->process();
 			++m_itemsDone;
 		}
+		return true;
 	}
+	return false;
 }
 
 
 
 void AudioEngineWorkerThread::JobQueue::run()
+{
+	if( m_schedulingMode == SchedulingMode::WorkStealing )
+	{
+		runWorkStealing();
+	}
+	else
+	{
+		runShared();
+	}
+}
+
+
+
+
+void AudioEngineWorkerThread::JobQueue::runShared()
 {
 	bool processedJob = true;
 	while (processedJob && m_itemsDone < m_writeIndex)
@@ -97,6 +159,68 @@ void AudioEngineWorkerThread::JobQueue::run()
 
 
 
+void AudioEngineWorkerThread::JobQueue::runWorkStealing()
+{
+	// keep going until the whole batch is done - with dependent jobs
+	// (OperationMode::Dynamic) new work may show up at any time
+	Deque & deque = ownDeque();
+	int idleCount = 0;
+	while( m_itemsDone < m_writeIndex )
+	{
+		ThreadableJob * job = deque.pop();
+		if( job == nullptr )
+		{
+			job = steal();
+		}
+
+		if( job )
+		{
+			job->process();
+			++m_itemsDone;
+			idleCount = 0;
+		}
+		else if( ++idleCount < IdleSpinCount )
+		{
+#ifdef __SSE__
+			_mm_pause();
+#endif
+		}
+		else
+		{
+			std::this_thread::yield();
+			idleCount = 0;
+		}
+	}
+}
+
+
+
+
+AudioEngineWorkerThread::JobQueue::Deque & AudioEngineWorkerThread::JobQueue::ownDeque()
+{
+	return *m_deques[std::min( s_threadIndex, m_deques.size() - 1 )];
+}
+
+
+
+
+ThreadableJob * AudioEngineWorkerThread::JobQueue::steal()
+{
+	const size_t numDeques = m_deques.size();
+	const size_t self = std::min( s_threadIndex, numDeques - 1 );
+	for( size_t i = 1; i < numDeques; ++i )
+	{
+		if( ThreadableJob * job = m_deques[( self + i ) % numDeques]->steal() )
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+
+
+
 void AudioEngineWorkerThread::JobQueue::wait()
 {
 	while (m_itemsDone < m_writeIndex)
@@ -115,7 +239,8 @@ void AudioEngineWorkerThread::JobQueue::wait()
 
 AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	QThread( audioEngine ),
-	m_quit( false )
+	m_quit( false ),
+	m_index( workerThreads.size() )
 {
 	// initialize global static data
 	if( queueReadyWaitCond == nullptr )
@@ -153,7 +278,15 @@ void AudioEngineWorkerThread::quit()
 
 void AudioEngineWorkerThread::startAndWaitForJobs()
 {
-	queueReadyWaitCond->wakeAll();
+	if( globalJobQueue.schedulingMode() == JobQueue::SchedulingMode::WorkStealing )
+	{
+		queueReadyGeneration.fetch_add( 1, std::memory_order_release );
+		queueReadyGeneration.notify_all();
+	}
+	else
+	{
+		queueReadyWaitCond->wakeAll();
+	}
 	// The last worker-thread is never started. Instead it's processed "inline"
 	// i.e. within the global AudioEngine thread. This way we can reduce latencies
 	// that otherwise would be caused by synchronizing with another thread.
@@ -167,6 +300,23 @@ void AudioEngineWorkerThread::startAndWaitForJobs()
 void AudioEngineWorkerThread::run()
 {
 	disable_denormals();
+	TraceRecorder::setThreadName(QString("Worker %1").arg(m_index + 1));
+
+	if( globalJobQueue.schedulingMode() == JobQueue::SchedulingMode::WorkStealing )
+	{
+		s_threadIndex = m_index;
+
+		auto generation = queueReadyGeneration.load( std::memory_order_acquire );
+		while( m_quit == false )
+		{
+			// park until the next batch is started - unlike the wait condition
+			// this cannot miss a wake-up which happened before we got here
+			queueReadyGeneration.wait( generation, std::memory_order_acquire );
+			generation = queueReadyGeneration.load( std::memory_order_acquire );
+			globalJobQueue.run();
+		}
+		return;
+	}
 
 	QMutex m;
 	while( m_quit == false )
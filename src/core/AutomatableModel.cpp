@@ -25,6 +25,7 @@
 #include "AutomatableModel.h"
 
 #include <QRegularExpression>
+#include <algorithm>
 
 #include "lmms_math.h"
 
@@ -394,6 +395,60 @@ void AutomatableModel::setAutomatedValue( const float value )
 
 
 
+void AutomatableModel::setAutomatedValues(const float* values, f_cnt_t offset, f_cnt_t frames)
+{
+	Q_ASSERT(offset + frames <= static_cast<f_cnt_t>(m_valueBuffer.length()));
+	if (frames == 0) { return; }
+
+	QMutexLocker m(&m_valueBufferMutex);
+	const bool automatedThisPeriod = m_lastUpdatedPeriod == s_periodCounter && m_hasSampleExactData;
+
+	// nothing changes within the span, let valueBuffer() interpolate from the
+	// old value as for automation evaluated once per period
+	if (!automatedThisPeriod && std::all_of(values, values + frames, [&](float v) { return v == values[0]; }))
+	{
+		m.unlock();
+		setAutomatedValue(values[0]);
+		return;
+	}
+
+	setUseControllerValue(false);
+	++m_setValueDepth;
+	const float oldValue = m_value;
+
+	float* buffer = m_valueBuffer.values();
+	if (!automatedThisPeriod)
+	{
+		std::fill(buffer, buffer + offset, m_value);
+	}
+	for (f_cnt_t f = 0; f < frames; ++f)
+	{
+		buffer[offset + f] = fittedValue(scaledValue(values[f]));
+	}
+	m_lastUpdatedPeriod = s_periodCounter;
+	m_hasSampleExactData = true;
+	m_oldValue = m_value = buffer[offset + frames - 1];
+	m.unlock();
+
+	// the linked models need the whole span, even if the last value stayed the same
+	for (const auto& linkedModel : m_linkedModels)
+	{
+		if (!linkedModel->controllerConnection() && linkedModel->m_setValueDepth < 1)
+		{
+			linkedModel->setAutomatedValues(values, offset, frames);
+		}
+	}
+	if (oldValue != m_value)
+	{
+		m_valueChanged = true;
+		emit dataChanged();
+	}
+	--m_setValueDepth;
+}
+
+
+
+
 void AutomatableModel::setRange( const float min, const float max,
 							const float step )
 {
@@ -26,6 +26,9 @@
 
 #include "AutomationClip.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "AutomationNode.h"
 #include "AutomationClipView.h"
 #include "AutomationTrack.h"
@@ -648,6 +651,104 @@ float AutomationClip::valueAt( timeMap::const_iterator v, int offset ) const
 
 
 
+void AutomationClip::valuesAt(double time, double step, float* values, f_cnt_t frames) const
+{
+	QMutexLocker m(&m_clipMutex);
+
+	if (m_timeMap.isEmpty())
+	{
+		std::fill(values, values + frames, 0.f);
+		return;
+	}
+
+	// number of frames whose time lies before the given tick
+	const auto framesBefore = [&](double tick)
+	{
+		const auto f = std::ceil((tick - time) / step);
+		return f <= 0 ? f_cnt_t{0} : std::min(static_cast<f_cnt_t>(f), frames);
+	};
+
+	// before the first node
+	f_cnt_t frame = framesBefore(POS(m_timeMap.begin()));
+	std::fill(values, values + frame, 0.f);
+	if (frame == frames) { return; }
+
+	// the last node at or before the first remaining frame
+	auto v = m_timeMap.upperBound(static_cast<int>(std::floor(time + frame * step)));
+	if (v != m_timeMap.begin()) { v = std::prev(v); }
+
+	while (frame < frames)
+	{
+		const double offset = time + frame * step - POS(v);
+		const auto nv = std::next(v);
+		if (nv == m_timeMap.end())
+		{
+			// after the last node
+			std::fill(values + frame, values + frames, OUTVAL(v));
+			if (offset == 0) { values[frame] = INVAL(v); }
+			break;
+		}
+
+		const auto end = std::max(framesBefore(POS(nv)), frame);
+		segmentValues(v, offset, step, values + frame, end - frame);
+		frame = end;
+		v = nv;
+	}
+}
+
+
+
+
+// Same as valueAt(v, offset) for offset, offset + step, ..., the loops are kept
+// free of dependencies between frames so that the compiler can vectorize them.
+void AutomationClip::segmentValues(timeMap::const_iterator v, double offset, double step,
+	float* values, f_cnt_t frames) const
+{
+	if (frames == 0) { return; }
+
+	if (m_progressionType == ProgressionType::Discrete)
+	{
+		std::fill(values, values + frames, OUTVAL(v));
+	}
+	else if (m_progressionType == ProgressionType::Linear)
+	{
+		auto const nv = std::next(v);
+		const float slope = (INVAL(nv) - OUTVAL(v)) / (POS(nv) - POS(v));
+		const float start = OUTVAL(v) + static_cast<float>(offset) * slope;
+		const float delta = static_cast<float>(step) * slope;
+		for (f_cnt_t f = 0; f < frames; ++f)
+		{
+			values[f] = start + static_cast<float>(f) * delta;
+		}
+	}
+	else /* ProgressionType::CubicHermite */
+	{
+		// the spline of valueAt(v, offset) as a polynomial in t
+		auto const nv = std::next(v);
+		const int numValues = POS(nv) - POS(v);
+		const float p1 = OUTVAL(v);
+		const float p2 = INVAL(nv);
+		const float m1 = OUTTAN(v) * numValues * m_tension;
+		const float m2 = INTAN(nv) * numValues * m_tension;
+
+		const float a = 2 * p1 + m1 - 2 * p2 + m2;
+		const float b = -3 * p1 - 2 * m1 + 3 * p2 - m2;
+		const float t0 = static_cast<float>(offset / numValues);
+		const float dt = static_cast<float>(step / numValues);
+		for (f_cnt_t f = 0; f < frames; ++f)
+		{
+			const float t = t0 + static_cast<float>(f) * dt;
+			values[f] = ((a * t + b) * t + m1) * t + p1;
+		}
+	}
+
+	// When the time is exactly the node's time, we want the inValue
+	if (offset == 0) { values[0] = INVAL(v); }
+}
+
+
+
+
 float *AutomationClip::valuesAfter( const TimePos & _time ) const
 {
 	QMutexLocker m(&m_clipMutex);
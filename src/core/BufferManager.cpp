@@ -26,30 +26,210 @@
 
 #include "BufferManager.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ConfigManager.h"
+#include "LocklessAllocator.h"
 #include "SampleFrame.h"
 
 
 namespace lmms
 {
 
+namespace
+{
+
+constexpr std::size_t MaxPools = 32;
+constexpr std::size_t CacheLineSize = 64;
+constexpr std::size_t DefaultPoolSize = 512;
+
+// pools are only ever added, never removed: buffers may still be released
+// while the application shuts down
+std::array<std::atomic<LocklessAllocator*>, MaxPools> s_pools{};
+std::atomic_size_t s_numPools = 0;
+std::size_t s_poolSize = DefaultPoolSize;
+// serializes growing, never locked by the audio threads
+std::mutex s_growMutex;
+
+std::atomic_size_t s_hits = 0;
+std::atomic_size_t s_misses = 0;
+std::atomic_size_t s_inUse = 0;
+std::atomic_size_t s_highWater = 0;
+std::atomic_size_t s_capacity = 0;
+
+
+bool addPool( fpp_t fpp )
+{
+	const auto lock = std::lock_guard{s_growMutex};
+
+	const auto numPools = s_numPools.load( std::memory_order_relaxed );
+	if( numPools >= MaxPools ) { return false; }
+
+	s_pools[numPools].store( new LocklessAllocator( s_poolSize, fpp * sizeof( SampleFrame ), CacheLineSize ),
+		std::memory_order_release );
+	s_numPools.store( numPools + 1, std::memory_order_release );
+	s_capacity += s_pools[numPools].load( std::memory_order_relaxed )->capacity();
+	return true;
+}
+
+
+//! Adds pools on request, so the audio threads never have to allocate
+class PoolGrower
+{
+public:
+	~PoolGrower()
+	{
+		if( m_thread.joinable() )
+		{
+			m_quit = true;
+			request();
+			m_thread.join();
+		}
+	}
+
+	void start( fpp_t fpp )
+	{
+		if( m_thread.joinable() ) { return; }
+		m_thread = std::thread{[this, fpp] { run( fpp ); }};
+	}
+
+	//! Real-time safe
+	void request()
+	{
+		if( !m_requested.exchange( true ) )
+		{
+			m_requested.notify_one();
+		}
+	}
+
+private:
+	void run( fpp_t fpp )
+	{
+		while( true )
+		{
+			m_requested.wait( false );
+			if( m_quit ) { return; }
+			// cleared first, so a request made while the pool is added isn't lost
+			m_requested = false;
+			addPool( fpp );
+		}
+	}
+
+	std::thread m_thread;
+	std::atomic_bool m_requested = false;
+	std::atomic_bool m_quit = false;
+};
+
+PoolGrower s_grower;
+
+
+void requestGrowth()
+{
+	if( s_numPools.load( std::memory_order_relaxed ) < MaxPools )
+	{
+		s_grower.request();
+	}
+}
+
+} // namespace
+
+
 fpp_t BufferManager::s_framesPerPeriod;
 
 void BufferManager::init( fpp_t fpp )
 {
 	s_framesPerPeriod = fpp;
+
+	if( s_numPools == 0 )
+	{
+		s_poolSize = std::max( ConfigManager::inst()->value( "audioengine", "bufferpoolsize",
+					QString::number( DefaultPoolSize ) ).toInt(), 32 );
+		addPool( fpp );
+	}
+	s_grower.start( fpp );
 }
 
 
 SampleFrame* BufferManager::acquire()
 {
-	return new SampleFrame[s_framesPerPeriod];
+	SampleFrame* buf = nullptr;
+
+	const auto numPools = s_numPools.load( std::memory_order_acquire );
+	for( std::size_t i = 0; i < numPools && !buf; ++i )
+	{
+		buf = static_cast<SampleFrame*>( s_pools[i].load( std::memory_order_acquire )->tryAlloc() );
+	}
+
+	if( buf )
+	{
+		std::uninitialized_default_construct_n( buf, s_framesPerPeriod );
+		s_hits.fetch_add( 1, std::memory_order_relaxed );
+	}
+	else
+	{
+		// the pool could not keep up, fall back to the heap
+		buf = new SampleFrame[s_framesPerPeriod];
+		s_misses.fetch_add( 1, std::memory_order_relaxed );
+		requestGrowth();
+	}
+
+	const auto inUse = s_inUse.fetch_add( 1, std::memory_order_relaxed ) + 1;
+	auto highWater = s_highWater.load( std::memory_order_relaxed );
+	while( inUse > highWater && !s_highWater.compare_exchange_weak( highWater, inUse, std::memory_order_relaxed ) ) {}
+
+	// grow early, so the audio threads don't have to fall back to the heap
+	if( inUse + s_poolSize / 4 > s_capacity.load( std::memory_order_relaxed ) )
+	{
+		requestGrowth();
+	}
+
+	return buf;
 }
 
 
 
 void BufferManager::release( SampleFrame* buf )
 {
+	if( !buf ) { return; }
+
+	s_inUse.fetch_sub( 1, std::memory_order_relaxed );
+
+	const auto numPools = s_numPools.load( std::memory_order_acquire );
+	for( std::size_t i = 0; i < numPools; ++i )
+	{
+		LocklessAllocator* pool = s_pools[i].load( std::memory_order_acquire );
+		if( pool->owns( buf ) )
+		{
+			pool->free( buf );
+			return;
+		}
+	}
+
 	delete[] buf;
 }
 
+
+
+void BufferManager::reserve( std::size_t buffers )
+{
+	while( s_capacity.load() < buffers && addPool( s_framesPerPeriod ) ) {}
+}
+
+
+
+BufferManager::Statistics BufferManager::statistics()
+{
+	return {
+		s_hits.load( std::memory_order_relaxed ),
+		s_misses.load( std::memory_order_relaxed ),
+		s_inUse.load( std::memory_order_relaxed ),
+		s_highWater.load( std::memory_order_relaxed ),
+		s_capacity.load( std::memory_order_relaxed )
+	};
+}
+
 } // namespace lmms
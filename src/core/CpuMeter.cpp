@@ -0,0 +1,138 @@
+/*
+ * CpuMeter.cpp - CPU time accounting for instruments, effects and mixer channels
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "CpuMeter.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+
+namespace lmms
+{
+
+std::atomic_bool CpuMeter::s_enabled = false;
+
+namespace
+{
+
+// locked by the audio thread with try_lock only
+std::mutex s_metersMutex;
+std::vector<CpuMeter*> s_meters;
+// periods which could not be finished because a meter was being added or removed
+int s_pendingPeriods = 0;
+
+} // namespace
+
+
+
+
+CpuMeter::CpuMeter()
+{
+	const auto lock = std::lock_guard{s_metersMutex};
+	s_meters.push_back(this);
+}
+
+
+
+
+CpuMeter::~CpuMeter()
+{
+	const auto lock = std::lock_guard{s_metersMutex};
+	s_meters.erase(std::find(s_meters.begin(), s_meters.end(), this));
+}
+
+
+
+
+void CpuMeter::setEnabled(bool enabled)
+{
+	if (enabled && !isEnabled()) { resetAll(); }
+	s_enabled = enabled;
+}
+
+
+
+
+void CpuMeter::resetAll()
+{
+	const auto lock = std::lock_guard{s_metersMutex};
+	for (const auto meter : s_meters)
+	{
+		meter->reset();
+	}
+}
+
+
+
+
+void CpuMeter::finishPeriod(std::uint64_t periodLimitNanoseconds)
+{
+	if (!isEnabled()) { return; }
+
+	auto lock = std::unique_lock{s_metersMutex, std::try_to_lock};
+	if (!lock.owns_lock())
+	{
+		// the meters keep adding up, spread it over all periods next time
+		++s_pendingPeriods;
+		return;
+	}
+
+	const auto periods = s_pendingPeriods + 1;
+	s_pendingPeriods = 0;
+	for (const auto meter : s_meters)
+	{
+		meter->fold(periodLimitNanoseconds, periods);
+	}
+}
+
+
+
+
+void CpuMeter::reset()
+{
+	m_periodTime = 0;
+	m_totalTime = 0;
+	m_averageLoad = 0.f;
+	m_worstLoad = 0.f;
+}
+
+
+
+
+void CpuMeter::fold(std::uint64_t periodLimitNanoseconds, int periods)
+{
+	const auto time = m_periodTime.exchange(0, std::memory_order_relaxed);
+	m_totalTime.fetch_add(time, std::memory_order_relaxed);
+
+	const auto load = 100.f * time / (periodLimitNanoseconds * periods);
+	// same averaging as the detail loads of AudioEngineProfiler
+	m_averageLoad.store(load * 0.05f + averageLoad() * 0.95f, std::memory_order_relaxed);
+	if (load > worstLoad())
+	{
+		m_worstLoad.store(load, std::memory_order_relaxed);
+	}
+}
+
+} // namespace lmms
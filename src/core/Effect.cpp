@@ -51,6 +51,7 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_autoQuitEnabled(ConfigManager::inst()->value("ui", "disableautoquit", "1").toInt() == 0)
 {
 	m_wetDryModel.setCenterValue(0);
+	m_traceName = TraceRecorder::intern(Plugin::displayName());
 
 	// Call the virtual method onEnabledChanged so that effects can react to changes,
 	// e.g. by resetting state.
@@ -99,6 +100,8 @@ bool Effect::processAudioBuffer(SampleFrame* buf, const fpp_t frames)
 		return false;
 	}
 
+	const auto span = TraceRecorder::Span{m_traceName, TraceRecorder::Category::Effect};
+	const auto meterScope = CpuMeter::Scope{m_cpuMeter};
 	const auto status = processImpl(buf, frames);
 	switch (status)
 	{
@@ -24,6 +24,9 @@
 
 #include "EnvelopeAndLfoParameters.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <QDomElement>
 #include <QFileInfo>
 
@@ -54,7 +57,8 @@ void EnvelopeAndLfoParameters::LfoInstances::trigger()
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame += Engine::audioEngine()->framesPerPeriod();
-		lfo->m_bad_lfoShapeData = true;
+		lfo->updateLfoShapeData();
+		lfo->deleteRetiredSnapshots();
 	}
 }
 
@@ -67,7 +71,7 @@ void EnvelopeAndLfoParameters::LfoInstances::reset()
 	for (const auto& lfo : m_lfos)
 	{
 		lfo->m_lfoFrame = 0;
-		lfo->m_bad_lfoShapeData = true;
+		lfo->updateLfoShapeData();
 	}
 }
 
@@ -97,6 +101,12 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 							Model * _parent ) :
 	Model( _parent ),
 	m_used( false ),
+	m_snapshot( nullptr ),
+	m_pahdFrames( 0 ),
+	m_releaseFrames( 0 ),
+	m_lfoPredelayFrames( 0 ),
+	m_lfoAttackFrames( 0 ),
+	m_lfoOscillationFrames( 1 ),
 	m_predelayModel(0.f, 0.f, 2.f, 0.001f, this, tr("Env pre-delay")),
 	m_attackModel(0.f, 0.f, 2.f, 0.001f, this, tr("Env attack")),
 	m_holdModel(0.5f, 0.f, 2.f, 0.001f, this, tr("Env hold")),
@@ -105,12 +115,6 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_releaseModel(0.1f, 0.f, 2.f, 0.001f, this, tr("Env release")),
 	m_amountModel(0.f, -1.f, 1.f, 0.005f, this, tr("Env mod amount")),
 	m_valueForZeroAmount( _value_for_zero_amount ),
-	m_pahdFrames( 0 ),
-	m_rFrames( 0 ),
-	m_pahdEnv( nullptr ),
-	m_rEnv( nullptr ),
-	m_pahdBufSize( 0 ),
-	m_rBufSize( 0 ),
 	m_lfoPredelayModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO pre-delay")),
 	m_lfoAttackModel(0.f, 0.f, 1.f, 0.001f, this, tr("LFO attack")),
 	m_lfoSpeedModel(0.1f, 0.001f, 1.f, 0.0001f,
@@ -121,8 +125,8 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 	m_x100Model( false, this, tr( "LFO frequency x 100" ) ),
 	m_controlEnvAmountModel( false, this, tr( "Modulate env amount" ) ),
 	m_lfoFrame( 0 ),
-	m_lfoAmountIsZero( false ),
-	m_lfoShapeData(nullptr)
+	m_lfoShapeData(nullptr),
+	m_random( 0.0f )
 {
 	m_amountModel.setCenterValue( 0 );
 	m_lfoAmountModel.setCenterValue( 0 );
@@ -132,8 +136,6 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 		s_lfoInstances = new LfoInstances();
 	}
 
-	instances()->add( this );
-
 	connect( &m_predelayModel, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_attackModel, SIGNAL(dataChanged()),
@@ -161,15 +163,21 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 	connect( &m_x100Model, SIGNAL(dataChanged()),
 			this, SLOT(updateSampleVars()), Qt::DirectConnection );
+	connect( &m_controlEnvAmountModel, SIGNAL(dataChanged()),
+			this, SLOT(updateSampleVars()), Qt::DirectConnection );
 
 	connect( Engine::audioEngine(), SIGNAL(sampleRateChanged()),
 				this, SLOT(updateSampleVars()));
 
 
 	m_lfoShapeData =
-		new sample_t[Engine::audioEngine()->framesPerPeriod()];
+		new sample_t[Engine::audioEngine()->framesPerPeriod()]();
 
 	updateSampleVars();
+	updateLfoShapeData();
+
+	// from now on, the LFO shape is updated by the audio engine
+	instances()->add( this );
 }
 
 
@@ -177,6 +185,14 @@ EnvelopeAndLfoParameters::EnvelopeAndLfoParameters(
 
 EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 {
+	instances()->remove( this );
+
+	if( instances()->isEmpty() )
+	{
+		delete instances();
+		s_lfoInstances = nullptr;
+	}
+
 	m_predelayModel.disconnect( this );
 	m_attackModel.disconnect( this );
 	m_holdModel.disconnect( this );
@@ -190,56 +206,45 @@ EnvelopeAndLfoParameters::~EnvelopeAndLfoParameters()
 	m_lfoAmountModel.disconnect( this );
 	m_lfoWaveModel.disconnect( this );
 	m_x100Model.disconnect( this );
+	m_controlEnvAmountModel.disconnect( this );
 
-	delete[] m_pahdEnv;
-	delete[] m_rEnv;
 	delete[] m_lfoShapeData;
 
-	instances()->remove( this );
-
-	if( instances()->isEmpty() )
+	delete m_snapshot.load();
+	for (const auto snapshot : m_retiredSnapshots)
 	{
-		delete instances();
-		s_lfoInstances = nullptr;
+		delete snapshot;
 	}
 }
 
 
 
 
-inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
+inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( const Snapshot& snapshot, fpp_t _frame_offset )
 {
-	f_cnt_t frame = ( m_lfoFrame + _frame_offset ) % m_lfoOscillationFrames;
+	f_cnt_t frame = ( m_lfoFrame + _frame_offset ) % snapshot.lfoOscillationFrames;
 	const float phase = frame / static_cast<float>(
-						m_lfoOscillationFrames );
-	sample_t shape_sample;
-	switch( static_cast<LfoShape>(m_lfoWaveModel.value())  )
+						snapshot.lfoOscillationFrames );
+	switch( snapshot.lfoShape )
 	{
 		case LfoShape::TriangleWave:
-			shape_sample = Oscillator::triangleSample( phase );
-			break;
+			return Oscillator::triangleSample( phase );
 		case LfoShape::SquareWave:
-			shape_sample = Oscillator::squareSample( phase );
-			break;
+			return Oscillator::squareSample( phase );
 		case LfoShape::SawWave:
-			shape_sample = Oscillator::sawSample( phase );
-			break;
+			return Oscillator::sawSample( phase );
 		case LfoShape::UserDefinedWave:
-			shape_sample = Oscillator::userWaveSample(m_userWave.get(), phase);
-			break;
+			return Oscillator::userWaveSample(snapshot.userWave.get(), phase);
 		case LfoShape::RandomWave:
 			if( frame == 0 )
 			{
 				m_random = Oscillator::noiseSample( 0.0f );
 			}
-			shape_sample = m_random;
-			break;
+			return m_random;
 		case LfoShape::SineWave:
 		default:
-			shape_sample = Oscillator::sinSample( phase );
-			break;
+			return Oscillator::sinSample( phase );
 	}
-	return shape_sample * m_lfoAmount;
 }
 
 
@@ -247,46 +252,43 @@ inline sample_t EnvelopeAndLfoParameters::lfoShapeSample( fpp_t _frame_offset )
 
 void EnvelopeAndLfoParameters::updateLfoShapeData()
 {
+	const auto snapshot = m_snapshot.load(std::memory_order_acquire);
+	// a silent LFO isn't read by the voices, it catches up in the period after it is turned up
+	if( snapshot->lfoAmountIsZero ) { return; }
+
 	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
 	for( fpp_t offset = 0; offset < frames; ++offset )
 	{
-		m_lfoShapeData[offset] = lfoShapeSample( offset );
+		m_lfoShapeData[offset] = lfoShapeSample( *snapshot, offset );
 	}
-	m_bad_lfoShapeData = false;
 }
 
 
 
 
-inline void EnvelopeAndLfoParameters::fillLfoLevel( float * _buf,
+inline void EnvelopeAndLfoParameters::fillLfoLevel( const Snapshot& snapshot,
+							float * _buf,
 							f_cnt_t _frame,
 							const fpp_t _frames )
 {
-	if( m_lfoAmountIsZero || _frame <= m_lfoPredelayFrames )
+	if( snapshot.lfoAmountIsZero || _frame <= snapshot.lfoPredelayFrames )
 	{
-		for( fpp_t offset = 0; offset < _frames; ++offset )
-		{
-			*_buf++ = 0.0f;
-		}
+		std::fill_n(_buf, _frames, 0.0f);
 		return;
 	}
-	_frame -= m_lfoPredelayFrames;
-
-	if( m_bad_lfoShapeData )
-	{
-		updateLfoShapeData();
-	}
+	_frame -= snapshot.lfoPredelayFrames;
 
+	const float amount = snapshot.lfoAmount;
 	fpp_t offset = 0;
-	const float lafI = 1.0f / std::max(minimumFrames, m_lfoAttackFrames);
-	for( ; offset < _frames && _frame < m_lfoAttackFrames; ++offset,
+	const float lafI = 1.0f / std::max(minimumFrames, snapshot.lfoAttackFrames);
+	for( ; offset < _frames && _frame < snapshot.lfoAttackFrames; ++offset,
 								++_frame )
 	{
-		*_buf++ = m_lfoShapeData[offset] * _frame * lafI;
+		_buf[offset] = m_lfoShapeData[offset] * amount * _frame * lafI;
 	}
 	for( ; offset < _frames; ++offset )
 	{
-		*_buf++ = m_lfoShapeData[offset];
+		_buf[offset] = m_lfoShapeData[offset] * amount;
 	}
 }
 
@@ -297,40 +299,69 @@ void EnvelopeAndLfoParameters::fillLevel( float * _buf, f_cnt_t _frame,
 						const f_cnt_t _release_begin,
 						const fpp_t _frames )
 {
-	QMutexLocker m(&m_paramMutex);
+	const auto snapshot = m_snapshot.load(std::memory_order_acquire);
+
+	fillLfoLevel( *snapshot, _buf, _frame, _frames );
 
-	fillLfoLevel( _buf, _frame, _frames );
+	const auto pahdEnv = snapshot->pahdEnv.data();
+	const auto rEnv = snapshot->rEnv.data();
+	const auto pahdFrames = static_cast<f_cnt_t>(snapshot->pahdEnv.size());
+	const auto rFrames = static_cast<f_cnt_t>(snapshot->rEnv.size());
+	const float sustainLevel = snapshot->sustainLevel;
+	const float releaseLevel = _release_begin < pahdFrames ? pahdEnv[_release_begin] : sustainLevel;
+	const bool controlEnvAmount = snapshot->controlEnvAmount;
 
-	for( fpp_t offset = 0; offset < _frames; ++offset, ++_buf, ++_frame )
+	// Applies the envelope segment ending at `end` to the LFO level in _buf. Every segment is a plain loop over a
+	// table or a constant, so the compiler can vectorize it.
+	fpp_t offset = 0;
+	auto applySegment = [&](f_cnt_t end, auto envLevel)
 	{
-		float env_level;
-		if( _frame < _release_begin )
+		const fpp_t count = end > _frame ? std::min<f_cnt_t>(end - _frame, _frames - offset) : 0;
+		float* buf = _buf + offset;
+		if( controlEnvAmount )
 		{
-			if( _frame < m_pahdFrames )
-			{
-				env_level = m_pahdEnv[_frame];
-			}
-			else
+			for( fpp_t i = 0; i < count; ++i )
 			{
-				env_level = m_sustainLevel;
+				buf[i] = envLevel( _frame + i ) * ( 0.5f + buf[i] );
 			}
 		}
-		else if( ( _frame - _release_begin ) < m_rFrames )
-		{
-			env_level = m_rEnv[_frame - _release_begin] *
-				( ( _release_begin < m_pahdFrames ) ?
-				m_pahdEnv[_release_begin] : m_sustainLevel );
-		}
 		else
 		{
-			env_level = 0.0f;
+			for( fpp_t i = 0; i < count; ++i )
+			{
+				buf[i] += envLevel( _frame + i );
+			}
 		}
+		offset += count;
+		_frame += count;
+	};
+
+	applySegment( std::min(_release_begin, pahdFrames),
+		[pahdEnv](f_cnt_t frame) { return pahdEnv[frame]; } );
+	applySegment( _release_begin,
+		[sustainLevel](f_cnt_t) { return sustainLevel; } );
+	applySegment( _release_begin + rFrames,
+		[rEnv, releaseBegin = _release_begin, releaseLevel](f_cnt_t frame) { return rEnv[frame - releaseBegin] * releaseLevel; } );
+	applySegment( std::numeric_limits<f_cnt_t>::max(),
+		[](f_cnt_t) { return 0.0f; } );
+}
+
+
+
 
-		// at this point, *_buf is LFO level
-		*_buf = m_controlEnvAmountModel.value() ?
-			env_level * ( 0.5f + *_buf ) :
-			env_level + *_buf;
+void EnvelopeAndLfoParameters::deleteRetiredSnapshots()
+{
+	// the voices of the period are done, so they can't hold a retired snapshot anymore, and the next period loads the
+	// current one. The audio engine mustn't wait for a snapshot being built, the next period can delete them as well.
+	if (!m_paramMutex.tryLock()) { return; }
+
+	for (const auto snapshot : m_retiredSnapshots)
+	{
+		delete snapshot;
 	}
+	m_retiredSnapshots.clear();
+
+	m_paramMutex.unlock();
 }
 
 
@@ -389,7 +420,7 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 	{
 		if (QFileInfo(PathUtil::toAbsolute(userWaveFile)).exists())
 		{
-			m_userWave = gui::SampleLoader::createBufferFromFile(_this.attribute("userwavefile"));
+			setLfoUserWave(gui::SampleLoader::createBufferFromFile(_this.attribute("userwavefile")));
 		}
 		else { Engine::getSong()->collectError(QString("%1: %2").arg(tr("Sample not found"), userWaveFile)); }  
 	}
@@ -400,10 +431,24 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 
 
 
+void EnvelopeAndLfoParameters::setLfoUserWave(std::shared_ptr<const SampleBuffer> wave)
+{
+	{
+		QMutexLocker m(&m_paramMutex);
+		m_userWave = std::move(wave);
+	}
+	updateSampleVars();
+}
+
+
+
+
 void EnvelopeAndLfoParameters::updateSampleVars()
 {
 	QMutexLocker m(&m_paramMutex);
 
+	auto snapshot = new Snapshot;
+
 	const float frames_per_env_seg = SECS_PER_ENV_SEGMENT *
 				Engine::audioEngine()->outputSampleRate();
 
@@ -421,118 +466,101 @@ void EnvelopeAndLfoParameters::updateSampleVars()
 					expKnobVal(m_decayModel.value() *
 					(1 - m_sustainModel.value()))));
 
-	m_sustainLevel = m_sustainModel.value();
-	m_amount = m_amountModel.value();
-	if( m_amount >= 0 )
-	{
-		m_amountAdd = ( 1.0f - m_amount ) * m_valueForZeroAmount;
-	}
-	else
-	{
-		m_amountAdd = m_valueForZeroAmount;
-	}
+	const float sustainLevel = m_sustainModel.value();
+	const float amount = m_amountModel.value();
+	const float amountAdd = amount >= 0
+		? ( 1.0f - amount ) * m_valueForZeroAmount
+		: m_valueForZeroAmount;
 
-	m_pahdFrames = predelay_frames + attack_frames + hold_frames +
-								decay_frames;
-	m_rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
+	auto rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
 					expKnobVal( m_releaseModel.value() ) );
-	m_rFrames = std::max(minimumFrames, m_rFrames);
+	rFrames = std::max(minimumFrames, rFrames);
 
-	if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
+	if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		m_rFrames = minimumFrames;
+		rFrames = minimumFrames;
 	}
 
-	// if the buffers are too small, make bigger ones - so we only alloc new memory when necessary
-	if( m_pahdBufSize < m_pahdFrames )
-	{
-		sample_t * tmp = m_pahdEnv;
-		m_pahdEnv = new sample_t[m_pahdFrames];
-		delete[] tmp;
-		m_pahdBufSize = m_pahdFrames;
-	}
-	if( m_rBufSize < m_rFrames )
-	{
-		sample_t * tmp = m_rEnv;
-		m_rEnv = new sample_t[m_rFrames];
-		delete[] tmp;
-		m_rBufSize = m_rFrames;
-	}
+	auto& pahdEnv = snapshot->pahdEnv;
+	auto& rEnv = snapshot->rEnv;
+	pahdEnv.resize( predelay_frames + attack_frames + hold_frames + decay_frames );
+	rEnv.resize( rFrames );
 
-	const float aa = m_amountAdd;
+	const float aa = amountAdd;
 	for( f_cnt_t i = 0; i < predelay_frames; ++i )
 	{
-		m_pahdEnv[i] = aa;
+		pahdEnv[i] = aa;
 	}
 
 	f_cnt_t add = predelay_frames;
 
-	const float afI = ( 1.0f / attack_frames ) * m_amount;
+	const float afI = ( 1.0f / attack_frames ) * amount;
 	for( f_cnt_t i = 0; i < attack_frames; ++i )
 	{
-		m_pahdEnv[add+i] = i * afI + aa;
+		pahdEnv[add+i] = i * afI + aa;
 	}
 
 	add += attack_frames;
-	const float amsum = m_amount + m_amountAdd;
+	const float amsum = amount + amountAdd;
 	for( f_cnt_t i = 0; i < hold_frames; ++i )
 	{
-		m_pahdEnv[add + i] = amsum;
+		pahdEnv[add + i] = amsum;
 	}
 
 	add += hold_frames;
-	const float dfI = ( 1.0 / decay_frames ) * ( m_sustainLevel -1 ) * m_amount;
+	const float dfI = ( 1.0 / decay_frames ) * ( sustainLevel -1 ) * amount;
 	for( f_cnt_t i = 0; i < decay_frames; ++i )
 	{
-/*
-		m_pahdEnv[add + i] = ( m_sustainLevel + ( 1.0f -
-						(float)i / decay_frames ) *
-						( 1.0f - m_sustainLevel ) ) *
-							m_amount + m_amountAdd;
-*/
-		m_pahdEnv[add + i] = amsum + i*dfI;
+		pahdEnv[add + i] = amsum + i*dfI;
 	}
 
-	const float rfI = ( 1.0f / m_rFrames ) * m_amount;
-	for( f_cnt_t i = 0; i < m_rFrames; ++i )
+	const float rfI = ( 1.0f / rFrames ) * amount;
+	for( f_cnt_t i = 0; i < rFrames; ++i )
 	{
-		m_rEnv[i] = (float)( m_rFrames - i ) * rfI;
+		rEnv[i] = (float)( rFrames - i ) * rfI;
 	}
 
 	// save this calculation in real-time-part
-	m_sustainLevel = m_sustainLevel * m_amount + m_amountAdd;
+	snapshot->sustainLevel = sustainLevel * amount + amountAdd;
+	snapshot->controlEnvAmount = m_controlEnvAmountModel.value();
 
 
 	const float frames_per_lfo_oscillation = SECS_PER_LFO_OSCILLATION *
 				Engine::audioEngine()->outputSampleRate();
-	m_lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	snapshot->lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoPredelayModel.value() ) );
-	m_lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	snapshot->lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
 				expKnobVal( m_lfoAttackModel.value() ) );
-	m_lfoOscillationFrames = static_cast<f_cnt_t>(
+	snapshot->lfoOscillationFrames = static_cast<f_cnt_t>(
 						frames_per_lfo_oscillation *
 						m_lfoSpeedModel.value() );
 	if( m_x100Model.value() )
 	{
-		m_lfoOscillationFrames /= 100;
+		snapshot->lfoOscillationFrames /= 100;
 	}
-	m_lfoAmount = m_lfoAmountModel.value() * 0.5f;
-
-	m_used = true;
-	if( static_cast<int>( floorf( m_lfoAmount * 1000.0f ) ) == 0 )
+	snapshot->lfoOscillationFrames = std::max(minimumFrames, snapshot->lfoOscillationFrames);
+	snapshot->lfoAmount = m_lfoAmountModel.value() * 0.5f;
+	snapshot->lfoShape = static_cast<LfoShape>(m_lfoWaveModel.value());
+	snapshot->userWave = m_userWave;
+
+	bool used = true;
+	snapshot->lfoAmountIsZero = static_cast<int>( floorf( snapshot->lfoAmount * 1000.0f ) ) == 0;
+	if( snapshot->lfoAmountIsZero && static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		m_lfoAmountIsZero = true;
-		if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
-		{
-			m_used = false;
-		}
+		used = false;
 	}
-	else
+
+	m_pahdFrames.store(pahdEnv.size(), std::memory_order_relaxed);
+	m_releaseFrames.store(rEnv.size(), std::memory_order_relaxed);
+	m_lfoPredelayFrames.store(snapshot->lfoPredelayFrames, std::memory_order_relaxed);
+	m_lfoAttackFrames.store(snapshot->lfoAttackFrames, std::memory_order_relaxed);
+	m_lfoOscillationFrames.store(snapshot->lfoOscillationFrames, std::memory_order_relaxed);
+
+	if (const auto previous = m_snapshot.exchange(snapshot, std::memory_order_acq_rel))
 	{
-		m_lfoAmountIsZero = false;
+		m_retiredSnapshots.push_back(previous);
 	}
-
-	m_bad_lfoShapeData = true;
+	m_used.store(used, std::memory_order_relaxed);
 
 	emit dataChanged();
 
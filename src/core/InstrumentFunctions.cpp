@@ -29,6 +29,7 @@
 #include "Engine.h"
 #include "InstrumentTrack.h"
 #include "PresetPreviewPlayHandle.h"
+#include "RandomGenerator.h"
 
 #include <vector>
 #include <algorithm>
@@ -416,7 +417,7 @@ void InstrumentFunctionArpeggio::processNote( NotePlayHandle * _n )
 		// Skip notes randomly
 		if( m_arpSkipModel.value() )
 		{
-			if (100 * static_cast<float>(rand()) / (static_cast<float>(RAND_MAX) + 1.0f) < m_arpSkipModel.value())
+			if (100 * RandomGenerator::forThread().unipolar() < m_arpSkipModel.value())
 			{
 				// update counters
 				frames_processed += arp_frames;
@@ -432,7 +433,7 @@ void InstrumentFunctionArpeggio::processNote( NotePlayHandle * _n )
 
 		if( m_arpMissModel.value() )
 		{
-			if (100 * static_cast<float>(rand()) / (static_cast<float>(RAND_MAX) + 1.0f) < m_arpMissModel.value())
+			if (100 * RandomGenerator::forThread().unipolar() < m_arpMissModel.value())
 			{
 				dir = ArpDirection::Random;
 			}
@@ -461,7 +462,7 @@ void InstrumentFunctionArpeggio::processNote( NotePlayHandle * _n )
 		else if( dir == ArpDirection::Random )
 		{
 			// just pick a random chord-index
-			cur_arp_idx = static_cast<int>(range * static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+			cur_arp_idx = static_cast<int>(range * RandomGenerator::forThread().unipolar());
 		}
 
 		// Divide cur_arp_idx with wanted repeats. The repeat feature will not affect random notes.
@@ -62,7 +62,10 @@ void InstrumentPlayHandle::play(SampleFrame* working_buffer)
 	}
 	while (nphsLeft);
 
-	m_instrument->play(working_buffer);
+	{
+		const auto meterScope = CpuMeter::Scope{m_instrument->cpuMeter()};
+		m_instrument->play(working_buffer);
+	}
 
 	// Process the audio buffer that the instrument has just worked on...
 	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
@@ -22,6 +22,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QVarLengthArray>
 #include <QDomElement>
 
@@ -40,6 +42,8 @@ namespace lmms
 const float CUT_FREQ_MULTIPLIER = 6000.0f;
 const float RES_MULTIPLIER = 2.0f;
 const float RES_PRECISION = 1000.0f;
+// frames between two calculations of the biquad filter coefficients while the cutoff or resonance is modulated
+const fpp_t FILTER_CONTROL_FRAMES = 16;
 
 
 InstrumentSoundShaping::InstrumentSoundShaping(
@@ -118,12 +122,6 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		envReleaseBegin += frames;
 	}
 
-	// because of optimizations, there's special code for several cases:
-	// 	- cut- and res-lfo/envelope active
-	// 	- cut-lfo/envelope active
-	// 	- res-lfo/envelope active
-	//	- no lfo/envelope active but filter is used
-
 	// only use filter, if it is really needed
 
 	auto& cutoffParameters = getCutoffParameters();
@@ -137,18 +135,22 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		int old_filter_cut = 0;
 		int old_filter_res = 0;
 
-		if( n->m_filter == nullptr )
+		if( !n->m_filter )
 		{
-			n->m_filter = std::make_unique<BasicFilters<>>( Engine::audioEngine()->outputSampleRate() );
+			n->m_filter.emplace( Engine::audioEngine()->outputSampleRate() );
 		}
-		n->m_filter->setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
+		auto& filter = *n->m_filter;
+		filter.setFilterType( static_cast<BasicFilters<>::FilterType>(m_filterModel.value()) );
 
-		if (cutoffParameters.isUsed())
+		const bool cutoffUsed = cutoffParameters.isUsed();
+		const bool resonanceUsed = resonanceParameters.isUsed();
+
+		if (cutoffUsed)
 		{
 			cutoffParameters.fillLevel(cutBuffer.data(), envTotalFrames, envReleaseBegin, frames);
 		}
 
-		if (resonanceParameters.isUsed())
+		if (resonanceUsed)
 		{
 			resonanceParameters.fillLevel(resBuffer.data(), envTotalFrames, envReleaseBegin, frames);
 		}
@@ -156,68 +158,60 @@ void InstrumentSoundShaping::processAudioBuffer( SampleFrame* buffer,
 		const float fcv = m_filterCutModel.value();
 		const float frv = m_filterResModel.value();
 
-		if (cutoffParameters.isUsed() && resonanceParameters.isUsed())
-		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+		const auto cutAt = [&]( fpp_t frame ) {
+			return cutoffUsed ? EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) * CUT_FREQ_MULTIPLIER + fcv : fcv;
+		};
+		const auto resAt = [&]( fpp_t frame ) {
+			return resonanceUsed ? frv + RES_MULTIPLIER * resBuffer[frame] : frv;
+		};
+		const auto changed = [&]( float cut, float res ) {
+			if( static_cast<int>( cut ) == old_filter_cut && static_cast<int>( res*RES_PRECISION ) == old_filter_res )
 			{
-				const float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
-
-				const float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
-
-				if( static_cast<int>( new_cut_val ) != old_filter_cut ||
-					static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
-				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, new_res_val );
-					old_filter_cut = static_cast<int>( new_cut_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
-				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
+				return false;
 			}
-		}
-		else if (cutoffParameters.isUsed())
+			old_filter_cut = static_cast<int>( cut );
+			old_filter_res = static_cast<int>( res*RES_PRECISION );
+			return true;
+		};
+
+		if( filter.isBiQuad() )
 		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			// The coefficients need sin/cos, so while an envelope or LFO moves the cutoff or resonance, they are
+			// only calculated every FILTER_CONTROL_FRAMES frames and interpolated for the frames in between.
+			if( frames > 0 && changed( cutAt( 0 ), resAt( 0 ) ) )
 			{
-				float new_cut_val = EnvelopeAndLfoParameters::expKnobVal( cutBuffer[frame] ) *
-								CUT_FREQ_MULTIPLIER + fcv;
-
-				if( static_cast<int>( new_cut_val ) != old_filter_cut )
-				{
-					n->m_filter->calcFilterCoeffs( new_cut_val, frv );
-					old_filter_cut = static_cast<int>( new_cut_val );
-				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
+				filter.calcFilterCoeffs( cutAt( 0 ), resAt( 0 ) );
 			}
-		}
-		else if(resonanceParameters.isUsed() )
-		{
-			for( fpp_t frame = 0; frame < frames; ++frame )
+			for( fpp_t block = 0; block < frames; block += FILTER_CONTROL_FRAMES )
 			{
-				float new_res_val = frv + RES_MULTIPLIER * resBuffer[frame];
-
-				if( static_cast<int>( new_res_val*RES_PRECISION ) != old_filter_res )
+				const fpp_t blockFrames = std::min<fpp_t>( FILTER_CONTROL_FRAMES, frames - block );
+				// the coefficients are exact at the start of every block and on the last frame of the period
+				const fpp_t end = std::min<fpp_t>( block + FILTER_CONTROL_FRAMES, frames - 1 );
+				const float cut = cutAt( end );
+				const float res = resAt( end );
+				if( changed( cut, res ) )
 				{
-					n->m_filter->calcFilterCoeffs( fcv, new_res_val );
-					old_filter_res = static_cast<int>( new_res_val*RES_PRECISION );
+					filter.processInterpolated( buffer + block, buffer + block, blockFrames, end - block, cut, res );
+				}
+				else
+				{
+					filter.process( buffer + block, buffer + block, blockFrames );
 				}
-
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
 			}
 		}
 		else
 		{
-			n->m_filter->calcFilterCoeffs( fcv, frv );
-
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				buffer[frame][0] = n->m_filter->update( buffer[frame][0], 0 );
-				buffer[frame][1] = n->m_filter->update( buffer[frame][1], 1 );
+				const float cut = cutAt( frame );
+				const float res = resAt( frame );
+				if( changed( cut, res ) )
+				{
+					filter.calcFilterCoeffs( cut, res );
+				}
+
+				buffer[frame][0] = filter.update( buffer[frame][0], 0 );
+				buffer[frame][1] = filter.update( buffer[frame][1], 1 );
 			}
 		}
 	}
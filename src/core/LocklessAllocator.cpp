@@ -25,6 +25,7 @@
 #include "LocklessAllocator.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>
 
 #include "lmmsconfig.h"
@@ -52,11 +53,14 @@ static size_t align( size_t size, size_t alignment )
 
 
 
-LocklessAllocator::LocklessAllocator( size_t nmemb, size_t size )
+LocklessAllocator::LocklessAllocator( size_t nmemb, size_t size, size_t alignment )
 {
 	m_capacity = align( nmemb, SIZEOF_SET );
-	m_elementSize = align( size, sizeof( void * ) );
-	m_pool = new char[m_capacity * m_elementSize];
+	m_elementSize = align( size, alignment );
+	// over-allocate so the first element can be aligned as well
+	m_poolMemory = new char[m_capacity * m_elementSize + alignment];
+	m_pool = m_poolMemory + align( reinterpret_cast<uintptr_t>( m_poolMemory ), alignment )
+					- reinterpret_cast<uintptr_t>( m_poolMemory );
 
 	m_freeStateSets = m_capacity / SIZEOF_SET;
 	m_freeState = new std::atomic_int[m_freeStateSets];
@@ -77,7 +81,7 @@ LocklessAllocator::~LocklessAllocator()
 				"Destroying with elements still allocated\n" );
 	}
 
-	delete[] m_pool;
+	delete[] m_poolMemory;
 	delete[] m_freeState;
 }
 
@@ -105,6 +109,19 @@ static int ffs( int i )
 
 
 void * LocklessAllocator::alloc()
+{
+	void * ptr = tryAlloc();
+	if( !ptr )
+	{
+		fprintf( stderr, "LocklessAllocator: No free space\n" );
+	}
+	return ptr;
+}
+
+
+
+
+void * LocklessAllocator::tryAlloc()
 {
 	// Some of these CAS loops could probably use relaxed atomics, as discussed
 	// in http://en.cppreference.com/w/cpp/atomic/atomic/compare_exchange.
@@ -114,7 +131,6 @@ void * LocklessAllocator::alloc()
 	{
 		if( !available )
 		{
-			fprintf( stderr, "LocklessAllocator: No free space\n" );
 			return nullptr;
 		}
 	}
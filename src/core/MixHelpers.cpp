@@ -28,11 +28,18 @@
 #include <cstdio>
 #endif
 
-#include <cmath>
+#include <atomic>
 
+#include "lmmsconfig.h"
+#include "MixHelpersKernels.h"
 #include "ValueBuffer.h"
 #include "SampleFrame.h"
 
+#if defined(_MSC_VER) && (defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
 
 
 static bool s_NaNHandler;
@@ -41,6 +48,175 @@ static bool s_NaNHandler;
 namespace lmms::MixHelpers
 {
 
+static_assert(sizeof(SampleFrame) == 2 * sizeof(float), "kernels treat frame buffers as interleaved floats");
+
+
+namespace
+{
+
+// reference implementation, used if no vector instructions are available
+struct Scalar
+{
+	struct V { float l, r; };
+	static constexpr int Width = 2;
+
+	static V load(const float* p) { return { p[0], p[1] }; }
+	static void store(float* p, V v) { p[0] = v.l; p[1] = v.r; }
+	static V set1(float x) { return { x, x }; }
+	static V setStereo(float l, float r) { return { l, r }; }
+	static V frameCoeffs(const float* c) { return { c[0], c[0] }; }
+
+	static V add(V a, V b) { return { a.l + b.l, a.r + b.r }; }
+	static V mul(V a, V b) { return { a.l * b.l, a.r * b.r }; }
+	static V abs(V x) { return { x.l < 0 ? -x.l : x.l, x.r < 0 ? -x.r : x.r }; }
+	static V clamp(V x, V lo, V hi) { return { clamp(x.l, lo.l, hi.l), clamp(x.r, lo.r, hi.r) }; }
+	static V swapChannels(V x) { return { x.r, x.l }; }
+
+	static V keepFinite(V x, V y) { return { finite(x.l) ? y.l : 0.0f, finite(x.r) ? y.r : 0.0f }; }
+	static bool anyNonFinite(V x) { return !finite(x.l) || !finite(x.r); }
+	static bool anyGreaterEqual(V a, V b) { return a.l >= b.l || a.r >= b.r; }
+
+	static float clamp(float x, float lo, float hi) { return x < lo ? lo : (x > hi ? hi : x); }
+	static bool finite(float x) { return x - x == 0.0f; }
+};
+
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+bool cpuSupports(Isa isa)
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool sse2 = info[3] & (1 << 26);
+	const bool osxsave = info[2] & (1 << 27);
+	const bool avx = info[2] & (1 << 28);
+	// the OS must save the YMM (and ZMM) registers on context switches
+	const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+
+	int ebx7 = 0;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		ebx7 = info[1];
+	}
+
+	switch (isa)
+	{
+		case Isa::Sse2: return sse2;
+		case Isa::Avx2: return avx && (xcr0 & 0x06) == 0x06 && (ebx7 & (1 << 5));
+		case Isa::Avx512: return avx && (xcr0 & 0xe6) == 0xe6 && (ebx7 & (1 << 16));
+		default: return false;
+	}
+#else
+	// also checks whether the OS supports the registers
+	__builtin_cpu_init();
+	switch (isa)
+	{
+		case Isa::Sse2: return __builtin_cpu_supports("sse2");
+		case Isa::Avx2: return __builtin_cpu_supports("avx2");
+		case Isa::Avx512: return __builtin_cpu_supports("avx512f");
+		default: return false;
+	}
+#endif
+}
+#else
+bool cpuSupports(Isa isa)
+{
+	// NEON is mandatory on ARMv8
+	return isa == Isa::Neon;
+}
+#endif
+
+
+//! Returns nullptr if the kernels can't be used on this machine
+const KernelTable* kernelsFor(Isa isa)
+{
+	if (isa == Isa::Scalar) { return scalarKernels(); }
+	if (!cpuSupports(isa)) { return nullptr; }
+
+	switch (isa)
+	{
+		case Isa::Sse2: return sse2Kernels();
+		case Isa::Avx2: return avx2Kernels();
+		case Isa::Avx512: return avx512Kernels();
+		case Isa::Neon: return neonKernels();
+		default: return nullptr;
+	}
+}
+
+
+struct Dispatch
+{
+	Dispatch()
+	{
+		for (Isa candidate : { Isa::Avx512, Isa::Avx2, Isa::Sse2, Isa::Neon, Isa::Scalar })
+		{
+			if (const KernelTable* table = kernelsFor(candidate))
+			{
+				kernels = table;
+				isa = candidate;
+				break;
+			}
+		}
+	}
+
+	std::atomic<const KernelTable*> kernels;
+	std::atomic<Isa> isa;
+};
+
+Dispatch& dispatch()
+{
+	static Dispatch s_dispatch;
+	return s_dispatch;
+}
+
+inline const KernelTable& kernels()
+{
+	return *dispatch().kernels.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+
+const KernelTable* scalarKernels()
+{
+	return Kernels<Scalar>::table();
+}
+
+
+Isa isa()
+{
+	return dispatch().isa;
+}
+
+bool setIsa( Isa isa )
+{
+	const KernelTable* table = kernelsFor(isa);
+	if (!table) { return false; }
+
+	dispatch().kernels = table;
+	dispatch().isa = isa;
+	return true;
+}
+
+const char* isaName( Isa isa )
+{
+	switch (isa)
+	{
+		case Isa::Scalar: return "Scalar";
+		case Isa::Sse2: return "SSE2";
+		case Isa::Avx2: return "AVX2";
+		case Isa::Avx512: return "AVX-512";
+		case Isa::Neon: return "NEON";
+	}
+	return "";
+}
+
+
+
 /*! \brief Function for applying MIXOP on all sample frames */
 template<typename MIXOP>
 static inline void run( SampleFrame* dst, const SampleFrame* src, int frames, const MIXOP& OP )
@@ -66,17 +242,7 @@ static inline void run( SampleFrame* dst, const sample_t* srcLeft, const sample_
 
 bool isSilent( const SampleFrame* src, int frames )
 {
-	const float silenceThreshold = 0.0000001f;
-
-	for( int i = 0; i < frames; ++i )
-	{
-		if (std::abs(src[i][0]) >= silenceThreshold || std::abs(src[i][1]) >= silenceThreshold)
-		{
-			return false;
-		}
-	}
-
-	return true;
+	return kernels().isSilent(src->data(), frames);
 }
 
 bool useNaNHandler()
@@ -97,111 +263,56 @@ bool sanitize( SampleFrame* src, int frames )
 		return false;
 	}
 
-	for (int f = 0; f < frames; ++f)
+	// clears the whole buffer if a problem is found, clamps it otherwise
+	if (kernels().sanitize(src->data(), frames))
 	{
-		auto& currentFrame = src[f];
-
-		if (currentFrame.containsInf() || currentFrame.containsNaN())
-		{
-			#ifdef LMMS_DEBUG
-					// TODO don't use printf here
-					printf("Bad data, clearing buffer. frame: ");
-					printf("%d: value %f, %f\n", f, currentFrame.left(), currentFrame.right());
-			#endif
-
-			// Clear the whole buffer if a problem is found
-			zeroSampleFrames(src, frames);
-
-			return true;
-		}
-		else
-		{
-			currentFrame.clamp(sample_t(-1000.0), sample_t(1000.0));
-		}
-	};
+#ifdef LMMS_DEBUG
+		// TODO don't use printf here
+		printf("Bad data, clearing buffer.\n");
+#endif
+		return true;
+	}
 
 	return false;
 }
 
 
-struct AddOp
-{
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst += src;
-	}
-} ;
-
 void add( SampleFrame* dst, const SampleFrame* src, int frames )
 {
-	run<>( dst, src, frames, AddOp() );
+	kernels().add(dst->data(), src->data(), frames);
 }
 
 
-
-struct AddMultipliedOp
-{
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
-
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst += src * m_coeff;
-	}
-
-	const float m_coeff;
-} ;
-
-
 void addMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	kernels().addMultiplied(dst->data(), src->data(), coeffSrc, frames);
 }
 
 
-struct AddSwappedMultipliedOp
+void multiply(SampleFrame* dst, float coeff, int frames)
 {
-	AddSwappedMultipliedOp( float coeff ) : m_coeff( coeff ) { }
-
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst[0] += src[1] * m_coeff;
-		dst[1] += src[0] * m_coeff;
-	}
-
-	const float m_coeff;
-};
+	kernels().multiply(dst->data(), coeff, frames);
+}
 
-void multiply(SampleFrame* dst, float coeff, int frames)
+void multiplyStereo(SampleFrame* dst, float coeffLeft, float coeffRight, int frames)
 {
-	for (int i = 0; i < frames; ++i)
-	{
-		dst[i] *= coeff;
-	}
+	kernels().multiplyStereo(dst->data(), coeffLeft, coeffRight, frames);
 }
 
 void addSwappedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddSwappedMultipliedOp(coeffSrc) );
+	kernels().addSwappedMultiplied(dst->data(), src->data(), coeffSrc, frames);
 }
 
 
 void addMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
 {
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
-	}
+	kernels().addMultipliedByBuffer(dst->data(), src->data(), coeffSrc, coeffSrcBuf->values(), frames);
 }
 
 void addMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
 {
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-	}
-
+	kernels().addMultipliedByBuffers(dst->data(), src->data(), coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames);
 }
 
 void addSanitizedMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, float coeffSrc, ValueBuffer * coeffSrcBuf, int frames )
@@ -213,11 +324,7 @@ void addSanitizedMultipliedByBuffer( SampleFrame* dst, const SampleFrame* src, f
 		return;
 	}
 
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) ) ? 0.0f : src[f][0] * coeffSrc * coeffSrcBuf->values()[f];
-		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) ) ? 0.0f : src[f][1] * coeffSrc * coeffSrcBuf->values()[f];
-	}
+	kernels().addSanitizedMultipliedByBuffer(dst->data(), src->data(), coeffSrc, coeffSrcBuf->values(), frames);
 }
 
 void addSanitizedMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src, ValueBuffer * coeffSrcBuf1, ValueBuffer * coeffSrcBuf2, int frames )
@@ -229,32 +336,11 @@ void addSanitizedMultipliedByBuffers( SampleFrame* dst, const SampleFrame* src,
 		return;
 	}
 
-	for( int f = 0; f < frames; ++f )
-	{
-		dst[f][0] += ( std::isinf( src[f][0] ) || std::isnan( src[f][0] ) )
-			? 0.0f
-			: src[f][0] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-		dst[f][1] += ( std::isinf( src[f][1] ) || std::isnan( src[f][1] ) )
-			? 0.0f
-			: src[f][1] * coeffSrcBuf1->values()[f] * coeffSrcBuf2->values()[f];
-	}
-
+	kernels().addSanitizedMultipliedByBuffers(dst->data(), src->data(),
+		coeffSrcBuf1->values(), coeffSrcBuf2->values(), frames);
 }
 
 
-struct AddSanitizedMultipliedOp
-{
-	AddSanitizedMultipliedOp( float coeff ) : m_coeff( coeff ) { }
-
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst[0] += ( std::isinf( src[0] ) || std::isnan( src[0] ) ) ? 0.0f : src[0] * m_coeff;
-		dst[1] += ( std::isinf( src[1] ) || std::isnan( src[1] ) ) ? 0.0f : src[1] * m_coeff;
-	}
-
-	const float m_coeff;
-};
-
 void addSanitizedMultiplied( SampleFrame* dst, const SampleFrame* src, float coeffSrc, int frames )
 {
 	if ( !useNaNHandler() )
@@ -263,39 +349,18 @@ void addSanitizedMultiplied( SampleFrame* dst, const SampleFrame* src, float coe
 		return;
 	}
 
-	run<>( dst, src, frames, AddSanitizedMultipliedOp(coeffSrc) );
+	kernels().addSanitizedMultiplied(dst->data(), src->data(), coeffSrc, frames);
 }
 
 
-
-struct AddMultipliedStereoOp
-{
-	AddMultipliedStereoOp( float coeffLeft, float coeffRight )
-	{
-		m_coeffs[0] = coeffLeft;
-		m_coeffs[1] = coeffRight;
-	}
-
-	void operator()( SampleFrame& dst, const SampleFrame& src ) const
-	{
-		dst[0] += src[0] * m_coeffs[0];
-		dst[1] += src[1] * m_coeffs[1];
-	}
-
-	std::array<float, 2> m_coeffs;
-} ;
-
-
 void addMultipliedStereo( SampleFrame* dst, const SampleFrame* src, float coeffSrcLeft, float coeffSrcRight, int frames )
 {
-
-	run<>( dst, src, frames, AddMultipliedStereoOp(coeffSrcLeft, coeffSrcRight) );
+	kernels().addMultipliedStereo(dst->data(), src->data(), coeffSrcLeft, coeffSrcRight, frames);
 }
 
 
 
 
-
 struct MultiplyAndAddMultipliedOp
 {
 	MultiplyAndAddMultipliedOp( float coeffDst, float coeffSrc )
@@ -0,0 +1,88 @@
+/*
+ * MixHelpersAvx2.cpp - AVX2 kernels for MixHelpers
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#include <immintrin.h>
+#endif
+
+
+namespace lmms::MixHelpers
+{
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+
+namespace
+{
+
+struct Avx2
+{
+	using V = __m256;
+	static constexpr int Width = 8;
+
+	static V load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+	static V set1(float x) { return _mm256_set1_ps(x); }
+	static V setStereo(float l, float r) { return _mm256_setr_ps(l, r, l, r, l, r, l, r); }
+
+	static V frameCoeffs(const float* c)
+	{
+		const __m128 quad = _mm_loadu_ps(c);
+		const __m256 lo = _mm256_castps128_ps256(_mm_unpacklo_ps(quad, quad));
+		return _mm256_insertf128_ps(lo, _mm_unpackhi_ps(quad, quad), 1);
+	}
+
+	static V add(V a, V b) { return _mm256_add_ps(a, b); }
+	static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+	static V abs(V x) { return _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))); }
+	static V clamp(V x, V lo, V hi) { return _mm256_min_ps(_mm256_max_ps(x, lo), hi); }
+	static V swapChannels(V x) { return _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+	// x - x is 0 for finite values and NaN for infs and NaNs
+	static V finiteMask(V x) { return _mm256_cmp_ps(_mm256_sub_ps(x, x), _mm256_setzero_ps(), _CMP_EQ_OQ); }
+	static V keepFinite(V x, V y) { return _mm256_and_ps(finiteMask(x), y); }
+	static bool anyNonFinite(V x) { return _mm256_movemask_ps(finiteMask(x)) != 0xff; }
+	static bool anyGreaterEqual(V a, V b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)) != 0; }
+};
+
+} // namespace
+
+const KernelTable* avx2Kernels()
+{
+	return Kernels<Avx2>::table();
+}
+
+#else
+
+const KernelTable* avx2Kernels()
+{
+	return nullptr;
+}
+
+#endif
+
+} // namespace lmms::MixHelpers
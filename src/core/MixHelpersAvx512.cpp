@@ -0,0 +1,96 @@
+/*
+ * MixHelpersAvx512.cpp - AVX-512 kernels for MixHelpers
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 warns about _mm512_undefined_ps() used inside its own intrinsics (GCC bug 105593)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#endif
+
+
+namespace lmms::MixHelpers
+{
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+
+namespace
+{
+
+// only uses AVX-512F instructions
+struct Avx512
+{
+	using V = __m512;
+	static constexpr int Width = 16;
+
+	static V load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, V v) { _mm512_storeu_ps(p, v); }
+	static V set1(float x) { return _mm512_set1_ps(x); }
+	static V setStereo(float l, float r) { return _mm512_broadcast_f32x4(_mm_setr_ps(l, r, l, r)); }
+
+	static V frameCoeffs(const float* c)
+	{
+		const __m512i index = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+		return _mm512_permutexvar_ps(index, _mm512_castps256_ps512(_mm256_loadu_ps(c)));
+	}
+
+	static V add(V a, V b) { return _mm512_add_ps(a, b); }
+	static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+	static V abs(V x)
+	{
+		return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(x), _mm512_set1_epi32(0x7fffffff)));
+	}
+	static V clamp(V x, V lo, V hi) { return _mm512_min_ps(_mm512_max_ps(x, lo), hi); }
+	static V swapChannels(V x) { return _mm512_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+	// x - x is 0 for finite values and NaN for infs and NaNs
+	static __mmask16 finiteMask(V x) { return _mm512_cmp_ps_mask(_mm512_sub_ps(x, x), _mm512_setzero_ps(), _CMP_EQ_OQ); }
+	static V keepFinite(V x, V y) { return _mm512_maskz_mov_ps(finiteMask(x), y); }
+	static bool anyNonFinite(V x) { return finiteMask(x) != 0xffff; }
+	static bool anyGreaterEqual(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ) != 0; }
+};
+
+} // namespace
+
+const KernelTable* avx512Kernels()
+{
+	return Kernels<Avx512>::table();
+}
+
+#else
+
+const KernelTable* avx512Kernels()
+{
+	return nullptr;
+}
+
+#endif
+
+} // namespace lmms::MixHelpers
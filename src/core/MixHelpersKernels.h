@@ -0,0 +1,289 @@
+/*
+ * MixHelpersKernels.h - vectorized kernels behind MixHelpers
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_MIX_HELPERS_KERNELS_H
+#define LMMS_MIX_HELPERS_KERNELS_H
+
+#include <cstring>
+
+// Private header, only to be included by MixHelpers*.cpp.
+//
+// Every instruction set gets its own translation unit, compiled with the
+// matching compiler flags, which instantiates the kernels below with a traits
+// type describing its vector registers. The traits must live in an anonymous
+// namespace so that the instantiations can't be merged across translation
+// units by the linker. For the same reason the kernels must not call any
+// inline library functions.
+//
+// A traits type provides:
+//   V                    vector of Width floats, Width is a multiple of 2 (one frame)
+//   load(p), store(p, v) unaligned
+//   set1(x), setStereo(l, r), frameCoeffs(c) (c[0] c[0] c[1] c[1] ...)
+//   add(a, b), mul(a, b), abs(x), clamp(x, lo, hi), swapChannels(x)
+//   keepFinite(x, y)     y where x is finite, 0 elsewhere
+//   anyNonFinite(x), anyGreaterEqual(x, y)
+
+namespace lmms::MixHelpers
+{
+
+//! Kernels of one instruction set. Buffers are interleaved stereo frames.
+struct KernelTable
+{
+	void (*add)(float* dst, const float* src, int frames);
+	void (*multiply)(float* dst, float coeff, int frames);
+	void (*multiplyStereo)(float* dst, float coeffLeft, float coeffRight, int frames);
+	void (*addMultiplied)(float* dst, const float* src, float coeff, int frames);
+	void (*addSwappedMultiplied)(float* dst, const float* src, float coeff, int frames);
+	void (*addMultipliedStereo)(float* dst, const float* src, float coeffLeft, float coeffRight, int frames);
+	void (*addSanitizedMultiplied)(float* dst, const float* src, float coeff, int frames);
+	void (*addMultipliedByBuffer)(float* dst, const float* src, float coeff, const float* coeffs, int frames);
+	void (*addSanitizedMultipliedByBuffer)(float* dst, const float* src, float coeff, const float* coeffs, int frames);
+	void (*addMultipliedByBuffers)(float* dst, const float* src, const float* coeffs1, const float* coeffs2, int frames);
+	void (*addSanitizedMultipliedByBuffers)(float* dst, const float* src, const float* coeffs1, const float* coeffs2, int frames);
+	bool (*isSilent)(const float* src, int frames);
+	bool (*sanitize)(float* buf, int frames);
+};
+
+// these return nullptr if the instruction set is not available for the target
+const KernelTable* sse2Kernels();
+const KernelTable* avx2Kernels();
+const KernelTable* avx512Kernels();
+const KernelTable* neonKernels();
+
+const KernelTable* scalarKernels();
+
+
+template<class S>
+struct Kernels
+{
+	using V = typename S::V;
+	static constexpr int Width = S::Width;
+	static constexpr int FramesPerVector = Width / 2;
+
+	static void add(float* dst, const float* src, int frames)
+	{
+		const int samples = frames * 2;
+		int i = 0;
+		for (; i + Width <= samples; i += Width)
+		{
+			S::store(dst + i, S::add(S::load(dst + i), S::load(src + i)));
+		}
+		for (; i < samples; ++i) { dst[i] += src[i]; }
+	}
+
+	static void multiply(float* dst, float coeff, int frames)
+	{
+		multiplyStereo(dst, coeff, coeff, frames);
+	}
+
+	static void multiplyStereo(float* dst, float coeffLeft, float coeffRight, int frames)
+	{
+		const V c = S::setStereo(coeffLeft, coeffRight);
+		int f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			S::store(dst + f * 2, S::mul(S::load(dst + f * 2), c));
+		}
+		for (; f < frames; ++f)
+		{
+			dst[f * 2] *= coeffLeft;
+			dst[f * 2 + 1] *= coeffRight;
+		}
+	}
+
+	static void addMultiplied(float* dst, const float* src, float coeff, int frames)
+	{
+		addMultipliedStereo(dst, src, coeff, coeff, frames);
+	}
+
+	static void addSwappedMultiplied(float* dst, const float* src, float coeff, int frames)
+	{
+		const V c = S::set1(coeff);
+		int f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			const V s = S::swapChannels(S::load(src + f * 2));
+			S::store(dst + f * 2, S::add(S::load(dst + f * 2), S::mul(s, c)));
+		}
+		for (; f < frames; ++f)
+		{
+			dst[f * 2] += src[f * 2 + 1] * coeff;
+			dst[f * 2 + 1] += src[f * 2] * coeff;
+		}
+	}
+
+	static void addMultipliedStereo(float* dst, const float* src, float coeffLeft, float coeffRight, int frames)
+	{
+		const V c = S::setStereo(coeffLeft, coeffRight);
+		int f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			S::store(dst + f * 2, S::add(S::load(dst + f * 2), S::mul(S::load(src + f * 2), c)));
+		}
+		for (; f < frames; ++f)
+		{
+			dst[f * 2] += src[f * 2] * coeffLeft;
+			dst[f * 2 + 1] += src[f * 2 + 1] * coeffRight;
+		}
+	}
+
+	static void addSanitizedMultiplied(float* dst, const float* src, float coeff, int frames)
+	{
+		const V c = S::set1(coeff);
+		const int samples = frames * 2;
+		int i = 0;
+		for (; i + Width <= samples; i += Width)
+		{
+			const V s = S::load(src + i);
+			S::store(dst + i, S::add(S::load(dst + i), S::keepFinite(s, S::mul(s, c))));
+		}
+		for (; i < samples; ++i)
+		{
+			dst[i] += isFinite(src[i]) ? src[i] * coeff : 0.0f;
+		}
+	}
+
+	template<bool Sanitize>
+	static void addMultipliedByBuffer(float* dst, const float* src, float coeff, const float* coeffs, int frames)
+	{
+		const V c = S::set1(coeff);
+		int f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			const V s = S::load(src + f * 2);
+			V r = S::mul(S::mul(s, c), S::frameCoeffs(coeffs + f));
+			if constexpr (Sanitize) { r = S::keepFinite(s, r); }
+			S::store(dst + f * 2, S::add(S::load(dst + f * 2), r));
+		}
+		for (; f < frames; ++f)
+		{
+			for (int ch = 0; ch < 2; ++ch)
+			{
+				const float s = src[f * 2 + ch];
+				if (!Sanitize || isFinite(s)) { dst[f * 2 + ch] += s * coeff * coeffs[f]; }
+			}
+		}
+	}
+
+	template<bool Sanitize>
+	static void addMultipliedByBuffers(float* dst, const float* src, const float* coeffs1, const float* coeffs2, int frames)
+	{
+		int f = 0;
+		for (; f + FramesPerVector <= frames; f += FramesPerVector)
+		{
+			const V s = S::load(src + f * 2);
+			V r = S::mul(S::mul(s, S::frameCoeffs(coeffs1 + f)), S::frameCoeffs(coeffs2 + f));
+			if constexpr (Sanitize) { r = S::keepFinite(s, r); }
+			S::store(dst + f * 2, S::add(S::load(dst + f * 2), r));
+		}
+		for (; f < frames; ++f)
+		{
+			for (int ch = 0; ch < 2; ++ch)
+			{
+				const float s = src[f * 2 + ch];
+				if (!Sanitize || isFinite(s)) { dst[f * 2 + ch] += s * coeffs1[f] * coeffs2[f]; }
+			}
+		}
+	}
+
+	static bool isSilent(const float* src, int frames)
+	{
+		constexpr float silenceThreshold = 0.0000001f;
+
+		const V threshold = S::set1(silenceThreshold);
+		const int samples = frames * 2;
+		int i = 0;
+		for (; i + Width <= samples; i += Width)
+		{
+			if (S::anyGreaterEqual(S::abs(S::load(src + i)), threshold)) { return false; }
+		}
+		for (; i < samples; ++i)
+		{
+			if (src[i] >= silenceThreshold || -src[i] >= silenceThreshold) { return false; }
+		}
+		return true;
+	}
+
+	//! Clamps the buffer, or clears it and returns true if it contains infs/nans
+	static bool sanitize(float* buf, int frames)
+	{
+		constexpr float limit = 1000.0f;
+
+		const V lo = S::set1(-limit);
+		const V hi = S::set1(limit);
+		const int samples = frames * 2;
+		int i = 0;
+		for (; i + Width <= samples; i += Width)
+		{
+			const V x = S::load(buf + i);
+			if (S::anyNonFinite(x)) { return clear(buf, samples); }
+			S::store(buf + i, S::clamp(x, lo, hi));
+		}
+		for (; i < samples; ++i)
+		{
+			if (!isFinite(buf[i])) { return clear(buf, samples); }
+			buf[i] = buf[i] < -limit ? -limit : (buf[i] > limit ? limit : buf[i]);
+		}
+		return false;
+	}
+
+	static const KernelTable* table()
+	{
+		static const KernelTable kernels = {
+			&add,
+			&multiply,
+			&multiplyStereo,
+			&addMultiplied,
+			&addSwappedMultiplied,
+			&addMultipliedStereo,
+			&addSanitizedMultiplied,
+			&addMultipliedByBuffer<false>,
+			&addMultipliedByBuffer<true>,
+			&addMultipliedByBuffers<false>,
+			&addMultipliedByBuffers<true>,
+			&isSilent,
+			&sanitize
+		};
+		return &kernels;
+	}
+
+private:
+	static bool isFinite(float x)
+	{
+		unsigned int bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		return (bits & 0x7f800000u) != 0x7f800000u;
+	}
+
+	static bool clear(float* buf, int samples)
+	{
+		std::memset(buf, 0, samples * sizeof(float));
+		return true;
+	}
+};
+
+
+} // namespace lmms::MixHelpers
+
+#endif // LMMS_MIX_HELPERS_KERNELS_H
@@ -0,0 +1,96 @@
+/*
+ * MixHelpersNeon.cpp - NEON kernels for MixHelpers
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#include "lmmsconfig.h"
+
+#ifdef LMMS_HOST_ARM64
+#include <arm_neon.h>
+#endif
+
+
+namespace lmms::MixHelpers
+{
+
+#ifdef LMMS_HOST_ARM64
+
+namespace
+{
+
+// NEON is part of every ARMv8 CPU, so no runtime check is needed
+struct Neon
+{
+	using V = float32x4_t;
+	static constexpr int Width = 4;
+
+	static V load(const float* p) { return vld1q_f32(p); }
+	static void store(float* p, V v) { vst1q_f32(p, v); }
+	static V set1(float x) { return vdupq_n_f32(x); }
+	static V setStereo(float l, float r)
+	{
+		const float pair[2] = { l, r };
+		const float32x2_t v = vld1_f32(pair);
+		return vcombine_f32(v, v);
+	}
+
+	static V frameCoeffs(const float* c)
+	{
+		const float32x2_t pair = vld1_f32(c);
+		return vcombine_f32(vdup_lane_f32(pair, 0), vdup_lane_f32(pair, 1));
+	}
+
+	static V add(V a, V b) { return vaddq_f32(a, b); }
+	static V mul(V a, V b) { return vmulq_f32(a, b); }
+	static V abs(V x) { return vabsq_f32(x); }
+	static V clamp(V x, V lo, V hi) { return vminq_f32(vmaxq_f32(x, lo), hi); }
+	static V swapChannels(V x) { return vrev64q_f32(x); }
+
+	// x - x is 0 for finite values and NaN for infs and NaNs
+	static uint32x4_t finiteMask(V x) { return vceqq_f32(vsubq_f32(x, x), vdupq_n_f32(0.0f)); }
+	static V keepFinite(V x, V y)
+	{
+		return vreinterpretq_f32_u32(vandq_u32(finiteMask(x), vreinterpretq_u32_f32(y)));
+	}
+	static bool anyNonFinite(V x) { return vminvq_u32(finiteMask(x)) == 0; }
+	static bool anyGreaterEqual(V a, V b) { return vmaxvq_u32(vcgeq_f32(a, b)) != 0; }
+};
+
+} // namespace
+
+const KernelTable* neonKernels()
+{
+	return Kernels<Neon>::table();
+}
+
+#else
+
+const KernelTable* neonKernels()
+{
+	return nullptr;
+}
+
+#endif
+
+} // namespace lmms::MixHelpers
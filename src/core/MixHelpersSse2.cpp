@@ -0,0 +1,88 @@
+/*
+ * MixHelpersSse2.cpp - SSE2 kernels for MixHelpers
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#include <emmintrin.h>
+#endif
+
+
+namespace lmms::MixHelpers
+{
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+
+namespace
+{
+
+struct Sse2
+{
+	using V = __m128;
+	static constexpr int Width = 4;
+
+	static V load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+	static V set1(float x) { return _mm_set1_ps(x); }
+	static V setStereo(float l, float r) { return _mm_setr_ps(l, r, l, r); }
+
+	static V frameCoeffs(const float* c)
+	{
+		// through __m64, which may alias floats unlike double
+		const V pair = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(c));
+		return _mm_unpacklo_ps(pair, pair);
+	}
+
+	static V add(V a, V b) { return _mm_add_ps(a, b); }
+	static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+	static V abs(V x) { return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))); }
+	static V clamp(V x, V lo, V hi) { return _mm_min_ps(_mm_max_ps(x, lo), hi); }
+	static V swapChannels(V x) { return _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+	// x - x is 0 for finite values and NaN for infs and NaNs
+	static V finiteMask(V x) { return _mm_cmpeq_ps(_mm_sub_ps(x, x), _mm_setzero_ps()); }
+	static V keepFinite(V x, V y) { return _mm_and_ps(finiteMask(x), y); }
+	static bool anyNonFinite(V x) { return _mm_movemask_ps(finiteMask(x)) != 0xf; }
+	static bool anyGreaterEqual(V a, V b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)) != 0; }
+};
+
+} // namespace
+
+const KernelTable* sse2Kernels()
+{
+	return Kernels<Sse2>::table();
+}
+
+#else
+
+const KernelTable* sse2Kernels()
+{
+	return nullptr;
+}
+
+#endif
+
+} // namespace lmms::MixHelpers
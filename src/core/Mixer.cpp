@@ -26,6 +26,7 @@
 
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
+#include "AudioTap.h"
 #include "Mixer.h"
 #include "MixHelpers.h"
 #include "Song.h"
@@ -58,6 +59,7 @@ void MixerRoute::updateName()
 
 
 MixerChannel::MixerChannel( int idx, Model * _parent ) :
+	ThreadableJob(TraceRecorder::Category::MixerChannel),
 	m_fxChain( nullptr ),
 	m_hasInput( false ),
 	m_stillRunning( false ),
@@ -70,7 +72,9 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_name(),
 	m_lock(),
 	m_queued( false ),
+	m_tap( nullptr ),
 	m_dependenciesMet(0),
+	m_busHandleInputs(0),
 	m_channelIndex(idx)
 {
 	zeroSampleFrames(m_buffer, Engine::audioEngine()->framesPerPeriod());
@@ -98,8 +102,11 @@ inline void MixerChannel::processed()
 
 void MixerChannel::incrementDeps()
 {
+	// muted channels are processed instantly, see Mixer::scheduleChannels()
+	if( m_muted ) { return; }
+
 	const auto i = m_dependenciesMet++ + 1;
-	if( i >= m_receives.size() && ! m_queued )
+	if( i >= m_receives.size() + m_busHandleInputs && ! m_queued )
 	{
 		m_queued = true;
 		AudioEngineWorkerThread::addJob( this );
@@ -163,6 +170,7 @@ void MixerChannel::unmuteReceiverForSolo()
 
 void MixerChannel::doProcessing()
 {
+	const auto meterScope = CpuMeter::Scope{m_cpuMeter};
 	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
 
 	if( m_muted == false )
@@ -220,6 +228,11 @@ void MixerChannel::doProcessing()
 		SampleFrame peakSamples = getAbsPeakValues(m_buffer, fpp);
 		m_peakLeft = std::max(m_peakLeft, peakSamples[0] * v);
 		m_peakRight = std::max(m_peakRight, peakSamples[1] * v);
+
+		if( m_tap )
+		{
+			m_tap->write( m_buffer, v, v, fpp );
+		}
 	}
 	else
 	{
@@ -642,12 +655,20 @@ FloatModel * Mixer::channelSendModel( mix_ch_t fromChannel, mix_ch_t toChannel )
 
 
 
-void Mixer::mixToChannel( const SampleFrame* _buf, mix_ch_t _ch )
+void Mixer::mixToChannel( const SampleFrame* _buf, mix_ch_t _ch, float gainLeft, float gainRight )
 {
 	if( m_mixerChannels[_ch]->m_muteModel.value() == false )
 	{
+		const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
 		m_mixerChannels[_ch]->m_lock.lock();
-		MixHelpers::add( m_mixerChannels[_ch]->m_buffer, _buf, Engine::audioEngine()->framesPerPeriod() );
+		if( gainLeft == 1.0f && gainRight == 1.0f )
+		{
+			MixHelpers::add( m_mixerChannels[_ch]->m_buffer, _buf, fpp );
+		}
+		else
+		{
+			MixHelpers::addMultipliedStereo( m_mixerChannels[_ch]->m_buffer, _buf, gainLeft, gainRight, fpp );
+		}
 		m_mixerChannels[_ch]->m_hasInput = true;
 		m_mixerChannels[_ch]->m_lock.unlock();
 	}
@@ -656,6 +677,28 @@ void Mixer::mixToChannel( const SampleFrame* _buf, mix_ch_t _ch )
 
 
 
+void Mixer::addChannelInput( mix_ch_t _ch )
+{
+	if( _ch < m_mixerChannels.size() )
+	{
+		++m_mixerChannels[_ch]->m_busHandleInputs;
+	}
+}
+
+
+
+
+void Mixer::channelInputProcessed( mix_ch_t _ch )
+{
+	if( _ch < m_mixerChannels.size() )
+	{
+		m_mixerChannels[_ch]->incrementDeps();
+	}
+}
+
+
+
+
 void Mixer::prepareMasterMix()
 {
 	zeroSampleFrames(m_mixerChannels[0]->m_buffer, Engine::audioEngine()->framesPerPeriod());
@@ -663,68 +706,58 @@ void Mixer::prepareMasterMix()
 
 
 
-void Mixer::masterMix( SampleFrame* _buf )
+void Mixer::scheduleChannels()
 {
-	const int fpp = Engine::audioEngine()->framesPerPeriod();
+	// snapshot the mute state first, muted channels are skipped when
+	// incrementing the dependencies of their receivers
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		ch->m_muted = ch->m_muteModel.value();
+	}
 
 	// add the channels that have no dependencies (no incoming senders, ie.
-	// no receives) to the jobqueue. The channels that have receives get
-	// added when their senders get processed, which is detected by
-	// dependency counting.
+	// no receives, and no audio bus handles feeding them) to the jobqueue.
+	// The other channels get added when their last sender or audio bus handle
+	// got processed, which is detected by dependency counting.
 	// also instantly add all muted channels as they don't need to care
 	// about their senders, and can just increment the deps of their
 	// recipients right away.
-	AudioEngineWorkerThread::resetJobQueue( AudioEngineWorkerThread::JobQueue::OperationMode::Dynamic );
 	for( MixerChannel * ch : m_mixerChannels )
 	{
-		ch->m_muted = ch->m_muteModel.value();
 		if( ch->m_muted ) // instantly "process" muted channels
 		{
 			ch->processed();
 			ch->done();
 		}
-		else if( ch->m_receives.size() == 0 )
+		else if( ch->m_receives.empty() && ch->m_busHandleInputs == 0 )
 		{
 			ch->m_queued = true;
 			AudioEngineWorkerThread::addJob( ch );
 		}
 	}
-	while (m_mixerChannels[0]->state() != ThreadableJob::ProcessingState::Done)
-	{
-		bool found = false;
-		for( MixerChannel * ch : m_mixerChannels )
-		{
-			const auto s = ch->state();
-			if (s == ThreadableJob::ProcessingState::Queued
-				|| s == ThreadableJob::ProcessingState::InProgress)
-			{
-				found = true;
-				break;
-			}
-		}
-		if( !found )
-		{
-			break;
-		}
-		AudioEngineWorkerThread::startAndWaitForJobs();
-	}
+}
+
+
+
+void Mixer::masterMix( SampleFrame* _buf, float gain )
+{
+	const int fpp = Engine::audioEngine()->framesPerPeriod();
+
+	// all channels have been processed as part of the processing graph,
+	// see AudioEngine::renderStageProcessing()
 
-	// handle sample-exact data in master volume fader
+	// apply master volume (sample-exact if available) and gain while mixing
 	ValueBuffer * volBuf = m_mixerChannels[0]->m_volumeModel.valueBuffer();
 
 	if( volBuf )
 	{
-		for( int f = 0; f < fpp; f++ )
-		{
-			m_mixerChannels[0]->m_buffer[f][0] *= volBuf->values()[f];
-			m_mixerChannels[0]->m_buffer[f][1] *= volBuf->values()[f];
-		}
+		MixHelpers::addSanitizedMultipliedByBuffer( _buf, m_mixerChannels[0]->m_buffer, gain, volBuf, fpp );
+	}
+	else
+	{
+		const float v = m_mixerChannels[0]->m_volumeModel.value() * gain;
+		MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer, v, fpp );
 	}
-
-	const float v = volBuf
-		? 1.0f
-		: m_mixerChannels[0]->m_volumeModel.value();
-	MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer, v, fpp );
 
 	// clear all channel buffers and
 	// reset channel process state
@@ -736,6 +769,7 @@ void Mixer::masterMix( SampleFrame* _buf )
 		// also reset hasInput
 		m_mixerChannels[i]->m_hasInput = false;
 		m_mixerChannels[i]->m_dependenciesMet = 0;
+		m_mixerChannels[i]->m_busHandleInputs = 0;
 	}
 }
 
@@ -762,6 +796,7 @@ void Mixer::clearChannel(mix_ch_t index)
 	ch->m_muteModel.setValue( false );
 	ch->m_soloModel.setValue( false );
 	ch->m_name = ( index == 0 ) ? tr( "Master" ) : tr( "Channel %1" ).arg( index );
+	ch->setTraceName(ch->m_name);
 	ch->m_volumeModel.setDisplayName( ch->m_name + ">" + tr( "Volume" ) );
 	ch->m_muteModel.setDisplayName( ch->m_name + ">" + tr( "Mute" ) );
 	ch->m_soloModel.setDisplayName( ch->m_name + ">" + tr( "Solo" ) );
@@ -850,6 +885,7 @@ void Mixer::loadSettings( const QDomElement & _this )
 		m_mixerChannels[num]->m_muteModel.loadSettings( mixch, "muted" );
 		m_mixerChannels[num]->m_soloModel.loadSettings( mixch, "soloed" );
 		m_mixerChannels[num]->m_name = mixch.attribute( "name" );
+		m_mixerChannels[num]->setTraceName(m_mixerChannels[num]->m_name);
 		if (mixch.hasAttribute("color"))
 		{
 			m_mixerChannels[num]->setColor(QColor{mixch.attribute("color")});
@@ -886,6 +922,7 @@ void Mixer::validateChannelName( int index, int oldIndex )
 	if( m_mixerChannels[index]->m_name == tr( "Channel %1" ).arg( oldIndex ) )
 	{
 		m_mixerChannels[index]->m_name = tr( "Channel %1" ).arg( index );
+		m_mixerChannels[index]->setTraceName(m_mixerChannels[index]->m_name);
 	}
 }
 
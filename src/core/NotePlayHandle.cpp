@@ -25,6 +25,13 @@
 
 #include "NotePlayHandle.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
 #include "AudioEngine.h"
 #include "DetuningHelper.h"
 #include "InstrumentSoundShaping.h"
@@ -62,6 +69,7 @@ NotePlayHandle::NotePlayHandle( InstrumentTrack* instrumentTrack,
 	m_framesBeforeRelease( 0 ),
 	m_releaseFramesToDo( 0 ),
 	m_releaseFramesDone( 0 ),
+	m_fadeOutLength( 0 ),
 	m_subNotes(),
 	m_released( false ),
 	m_releaseStarted( false ),
@@ -78,8 +86,7 @@ NotePlayHandle::NotePlayHandle( InstrumentTrack* instrumentTrack,
 	m_baseDetuning( nullptr ),
 	m_songGlobalParentOffset( 0 ),
 	m_midiChannel( midiEventChannel >= 0 ? midiEventChannel : instrumentTrack->midiPort()->realOutputChannel() ),
-	m_origin( origin ),
-	m_frequencyNeedsUpdate( false )
+	m_origin( origin )
 {
 	lock();
 	if( hasParent() == false )
@@ -234,11 +241,6 @@ void NotePlayHandle::play( SampleFrame* _working_buffer )
 			offset() );
 	}
 
-	if( m_frequencyNeedsUpdate )
-	{
-		updateFrequency();
-	}
-
 	// number of frames that can be played this period
 	f_cnt_t framesThisPeriod = m_totalFramesPlayed == 0
 		? Engine::audioEngine()->framesPerPeriod() - offset()
@@ -411,6 +413,36 @@ void NotePlayHandle::noteOff( const f_cnt_t _s )
 
 
 
+void NotePlayHandle::fadeOut( const f_cnt_t frames )
+{
+	noteOff( 0 );
+	// don't wait for the sustain pedal
+	m_releaseStarted = true;
+
+	for( NotePlayHandle * n : m_subNotes )
+	{
+		n->lock();
+		n->fadeOut( frames );
+		n->unlock();
+	}
+
+	if( actualReleaseFramesToDo() == 0 )
+	{
+		// without release frames the note would end right away and click,
+		// keep playing it while fading out instead
+		m_framesBeforeRelease = m_framesBeforeRelease > 0 ? std::min( m_framesBeforeRelease, frames ) : frames;
+	}
+	else
+	{
+		m_framesBeforeRelease = 0;
+		m_releaseFramesToDo = std::min( m_releaseFramesToDo, m_releaseFramesDone + frames );
+	}
+	m_fadeOutLength = std::max<f_cnt_t>( 1, m_framesBeforeRelease + m_releaseFramesToDo - m_releaseFramesDone );
+}
+
+
+
+
 f_cnt_t NotePlayHandle::actualReleaseFramesToDo() const
 {
 	return m_instrumentTrack->m_soundShaping.releaseFrames();
@@ -602,25 +634,183 @@ void NotePlayHandle::resize( const bpm_t _new_tempo )
 }
 
 
-NotePlayHandle ** NotePlayHandleManager::s_available;
-QReadWriteLock NotePlayHandleManager::s_mutex;
-std::atomic_int NotePlayHandleManager::s_availableIndex;
-int NotePlayHandleManager::s_size;
+namespace
+{
+
+// upper limit for the number of magazines
+constexpr std::uint32_t MaxMagazines = NotePlayHandleManager::MaxHandles / NPH_CACHE_INCREMENT;
 
+struct Magazine
+{
+	std::array<NotePlayHandle*, NPH_CACHE_INCREMENT> handles;
+	int count;
+	std::atomic<std::uint32_t> next;
+};
 
-void NotePlayHandleManager::init()
+Magazine s_magazines[MaxMagazines];
+std::atomic<std::uint32_t> s_magazinesUsed = 0;
+
+std::atomic_int s_handlesInUse = 0;
+std::atomic_int s_handlesAllocated = 0;
+
+// memory of all handles, only touched when growing
+std::mutex s_chunksMutex;
+std::vector<void*> s_chunks;
+
+
+/**
+	Lock-free stack of magazines (Treiber stack). The head stores the magazine
+	index + 1 in the lower and a tag in the upper 32 bits to avoid ABA problems.
+*/
+class MagazineStack
+{
+public:
+	void push( Magazine* magazine )
+	{
+		const auto index = static_cast<std::uint64_t>( magazine - s_magazines ) + 1;
+		auto head = m_head.load( std::memory_order_relaxed );
+		do
+		{
+			magazine->next.store( static_cast<std::uint32_t>( head ), std::memory_order_relaxed );
+		}
+		while( !m_head.compare_exchange_weak( head, nextTag( head ) | index,
+					std::memory_order_release, std::memory_order_relaxed ) );
+	}
+
+	Magazine* pop()
+	{
+		auto head = m_head.load( std::memory_order_acquire );
+		while( static_cast<std::uint32_t>( head ) != 0 )
+		{
+			Magazine* magazine = &s_magazines[static_cast<std::uint32_t>( head ) - 1];
+			const std::uint64_t next = magazine->next.load( std::memory_order_relaxed );
+			if( m_head.compare_exchange_weak( head, nextTag( head ) | next,
+					std::memory_order_acquire, std::memory_order_acquire ) )
+			{
+				return magazine;
+			}
+		}
+		return nullptr;
+	}
+
+private:
+	static std::uint64_t nextTag( std::uint64_t head )
+	{
+		return ( ( head >> 32 ) + 1 ) << 32;
+	}
+
+	std::atomic<std::uint64_t> m_head = 0;
+};
+
+MagazineStack s_fullMagazines;
+MagazineStack s_emptyMagazines;
+
+
+Magazine* emptyMagazine()
+{
+	if( Magazine* magazine = s_emptyMagazines.pop() ) { return magazine; }
+
+	const auto index = s_magazinesUsed.fetch_add( 1, std::memory_order_relaxed );
+	if( index >= MaxMagazines )
+	{
+		qFatal( "NotePlayHandleManager: too many note play handles" );
+	}
+	s_magazines[index].count = 0;
+	return &s_magazines[index];
+}
+
+
+//! Fills an empty magazine with newly allocated handles
+void fillMagazine( Magazine* magazine )
 {
-	s_available = new NotePlayHandle*[INITIAL_NPH_CACHE];
+	auto n = static_cast<NotePlayHandle*>( std::malloc( sizeof( NotePlayHandle ) * NPH_CACHE_INCREMENT ) );
+	{
+		const auto lock = std::lock_guard{s_chunksMutex};
+		s_chunks.push_back( n );
+	}
+
+	for( auto& handle : magazine->handles )
+	{
+		handle = n++;
+	}
+	magazine->count = NPH_CACHE_INCREMENT;
+	s_handlesAllocated += NPH_CACHE_INCREMENT;
+}
 
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * INITIAL_NPH_CACHE));
 
-	for( int i=0; i < INITIAL_NPH_CACHE; ++i )
+//! The two magazines cached by each thread
+class MagazineCache
+{
+public:
+	~MagazineCache()
 	{
-		s_available[ i ] = n;
-		++n;
+		// hand our handles back to the other threads
+		for( Magazine* magazine : { m_loaded, m_previous } )
+		{
+			if( magazine == nullptr ) { continue; }
+			if( magazine->count > 0 ) { s_fullMagazines.push( magazine ); }
+			else { s_emptyMagazines.push( magazine ); }
+		}
+	}
+
+	NotePlayHandle* pop()
+	{
+		if( m_loaded == nullptr ) { m_loaded = emptyMagazine(); }
+
+		if( m_loaded->count == 0 )
+		{
+			if( m_previous && m_previous->count > 0 )
+			{
+				std::swap( m_loaded, m_previous );
+			}
+			else if( Magazine* full = s_fullMagazines.pop() )
+			{
+				s_emptyMagazines.push( m_loaded );
+				m_loaded = full;
+			}
+			else
+			{
+				fillMagazine( m_loaded );
+			}
+		}
+
+		return m_loaded->handles[--m_loaded->count];
 	}
-	s_availableIndex = INITIAL_NPH_CACHE - 1;
-	s_size = INITIAL_NPH_CACHE;
+
+	void push( NotePlayHandle* handle )
+	{
+		if( m_loaded == nullptr ) { m_loaded = emptyMagazine(); }
+
+		if( m_loaded->count == NPH_CACHE_INCREMENT )
+		{
+			if( m_previous == nullptr )
+			{
+				m_previous = emptyMagazine();
+			}
+			else if( m_previous->count == NPH_CACHE_INCREMENT )
+			{
+				s_fullMagazines.push( m_previous );
+				m_previous = emptyMagazine();
+			}
+			std::swap( m_loaded, m_previous );
+		}
+
+		m_loaded->handles[m_loaded->count++] = handle;
+	}
+
+private:
+	Magazine* m_loaded = nullptr;
+	Magazine* m_previous = nullptr;
+};
+
+thread_local MagazineCache s_cache;
+
+} // namespace
+
+
+void NotePlayHandleManager::init()
+{
+	extend( INITIAL_NPH_CACHE );
 }
 
 
@@ -632,11 +822,8 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 				int midiEventChannel,
 				NotePlayHandle::Origin origin )
 {
-	// TODO: use some lockless data structures
-	s_mutex.lockForWrite();
-	if (s_availableIndex < 0) { extend(NPH_CACHE_INCREMENT); }
-	NotePlayHandle * nph = s_available[s_availableIndex--];
-	s_mutex.unlock();
+	NotePlayHandle * nph = s_cache.pop();
+	++s_handlesInUse;
 
 	new( (void*)nph ) NotePlayHandle( instrumentTrack, offset, frames, noteToPlay, parent, midiEventChannel, origin );
 	return nph;
@@ -646,31 +833,35 @@ NotePlayHandle * NotePlayHandleManager::acquire( InstrumentTrack* instrumentTrac
 void NotePlayHandleManager::release( NotePlayHandle * nph )
 {
 	nph->NotePlayHandle::~NotePlayHandle();
-	s_mutex.lockForRead();
-	s_available[++s_availableIndex] = nph;
-	s_mutex.unlock();
+	s_cache.push( nph );
+	--s_handlesInUse;
 }
 
 
 void NotePlayHandleManager::extend( int c )
 {
-	s_size += c;
-	auto tmp = new NotePlayHandle*[s_size];
-	delete[] s_available;
-	s_available = tmp;
-
-	auto n = static_cast<NotePlayHandle *>(std::malloc(sizeof(NotePlayHandle) * c));
-
-	for( int i=0; i < c; ++i )
+	for( int i = 0; i < c; i += NPH_CACHE_INCREMENT )
 	{
-		s_available[++s_availableIndex] = n;
-		++n;
+		Magazine* magazine = emptyMagazine();
+		fillMagazine( magazine );
+		s_fullMagazines.push( magazine );
 	}
 }
 
 void NotePlayHandleManager::free()
 {
-	delete[] s_available;
+	const auto lock = std::lock_guard{s_chunksMutex};
+	for( void* chunk : s_chunks )
+	{
+		std::free( chunk );
+	}
+	s_chunks.clear();
+}
+
+
+NotePlayHandleManager::Statistics NotePlayHandleManager::statistics()
+{
+	return { s_handlesInUse.load( std::memory_order_relaxed ), s_handlesAllocated.load( std::memory_order_relaxed ) };
 }
 
 
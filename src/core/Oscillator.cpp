@@ -578,6 +578,74 @@ float Oscillator::syncInit( SampleFrame* _ab, const fpp_t _frames,
 
 
 
+// Calls fn with a callable which returns the sample of wave shape W at a given phase. Whether band-limited
+// tables are used and which band fits the frequency doesn't change within a period, so it is decided here once
+// instead of for every sample, and the loops in fn don't branch on it.
+template<Oscillator::WaveShape W, typename Fn>
+inline void Oscillator::withSampler(Fn&& fn) const
+{
+	const float freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
+	const bool useWaveTable = m_useWaveTable && !m_isModulator;
+
+	if constexpr (W == WaveShape::Sine)
+	{
+		if (m_useWaveTable && freq >= OscillatorConstants::MAX_FREQ)
+		{
+			fn([](const float) { return sample_t{0}; });
+		}
+		else
+		{
+			fn([](const float sample) { return sinSample(sample); });
+		}
+	}
+	else if constexpr (W == WaveShape::WhiteNoise)
+	{
+		// looked up once per period instead of once per frame
+		fn([&rng = RandomGenerator::forThread()](const float) { return rng.bipolar(); });
+	}
+	else if constexpr (W == WaveShape::UserDefined)
+	{
+		if (useWaveTable && m_userAntiAliasWaveTable)
+		{
+			fn(tableSampler((*m_userAntiAliasWaveTable)[waveTableBandFromFreq(freq)].data()));
+		}
+		else
+		{
+			fn([buffer = m_userWave.get()](const float sample) { return userWaveSample(buffer, sample); });
+		}
+	}
+	else
+	{
+		if (useWaveTable)
+		{
+			fn(tableSampler(s_waveTables[static_cast<std::size_t>(W) - FirstWaveShapeTable][waveTableBandFromFreq(freq)]));
+		}
+		else if constexpr (W == WaveShape::Triangle)
+		{
+			fn([](const float sample) { return triangleSample(sample); });
+		}
+		else if constexpr (W == WaveShape::Saw)
+		{
+			fn([](const float sample) { return sawSample(sample); });
+		}
+		else if constexpr (W == WaveShape::Square)
+		{
+			fn([](const float sample) { return squareSample(sample); });
+		}
+		else if constexpr (W == WaveShape::MoogSaw)
+		{
+			fn([](const float sample) { return moogSawSample(sample); });
+		}
+		else if constexpr (W == WaveShape::Exponential)
+		{
+			fn([](const float sample) { return expSample(sample); });
+		}
+	}
+}
+
+
+
+
 // if we have no sub-osc, we can't do any modulation... just get our samples
 template<Oscillator::WaveShape W>
 void Oscillator::updateNoSub( SampleFrame* _ab, const fpp_t _frames,
@@ -585,12 +653,17 @@ void Oscillator::updateNoSub( SampleFrame* _ab, const fpp_t _frames,
 {
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	withSampler<W>([&](auto getSample) {
+		auto phase = m_phase;
+		for( fpp_t frame = 0; frame < _frames; ++frame )
+		{
+			_ab[frame][_chnl] = getSample( phase ) * volume;
+			phase += osc_coeff;
+		}
+		m_phase = phase;
+	});
 }
 
 
@@ -604,14 +677,17 @@ void Oscillator::updatePM( SampleFrame* _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, true );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] = getSample<W>( m_phase +
-					_ab[frame][_chnl] )
-							* m_volume;
-		m_phase += osc_coeff;
-	}
+	withSampler<W>([&](auto getSample) {
+		auto phase = m_phase;
+		for( fpp_t frame = 0; frame < _frames; ++frame )
+		{
+			_ab[frame][_chnl] = getSample( phase + _ab[frame][_chnl] ) * volume;
+			phase += osc_coeff;
+		}
+		m_phase = phase;
+	});
 }
 
 
@@ -625,12 +701,17 @@ void Oscillator::updateAM( SampleFrame* _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] *= getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	withSampler<W>([&](auto getSample) {
+		auto phase = m_phase;
+		for( fpp_t frame = 0; frame < _frames; ++frame )
+		{
+			_ab[frame][_chnl] *= getSample( phase ) * volume;
+			phase += osc_coeff;
+		}
+		m_phase = phase;
+	});
 }
 
 
@@ -644,12 +725,17 @@ void Oscillator::updateMix( SampleFrame* _ab, const fpp_t _frames,
 	m_subOsc->update( _ab, _frames, _chnl, false );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		_ab[frame][_chnl] += getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	withSampler<W>([&](auto getSample) {
+		auto phase = m_phase;
+		for( fpp_t frame = 0; frame < _frames; ++frame )
+		{
+			_ab[frame][_chnl] += getSample( phase ) * volume;
+			phase += osc_coeff;
+		}
+		m_phase = phase;
+	});
 }
 
 
@@ -664,16 +750,19 @@ void Oscillator::updateSync( SampleFrame* _ab, const fpp_t _frames,
 	const float sub_osc_coeff = m_subOsc->syncInit( _ab, _frames, _chnl );
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames ; ++frame )
-	{
-		if( m_subOsc->syncOk( sub_osc_coeff ) )
+	withSampler<W>([&](auto getSample) {
+		for( fpp_t frame = 0; frame < _frames ; ++frame )
 		{
-			m_phase = m_phaseOffset;
+			if( m_subOsc->syncOk( sub_osc_coeff ) )
+			{
+				m_phase = m_phaseOffset;
+			}
+			_ab[frame][_chnl] = getSample( m_phase ) * volume;
+			m_phase += osc_coeff;
 		}
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
+	});
 }
 
 
@@ -688,143 +777,18 @@ void Oscillator::updateFM( SampleFrame* _ab, const fpp_t _frames,
 	recalcPhase();
 	const float osc_coeff = m_freq * m_detuning_div_samplerate;
 	const float sampleRateCorrection = 44100.0f / Engine::audioEngine()->outputSampleRate();
+	const float volume = m_volume;
 
-	for( fpp_t frame = 0; frame < _frames; ++frame )
-	{
-		m_phase += _ab[frame][_chnl] * sampleRateCorrection;
-		_ab[frame][_chnl] = getSample<W>( m_phase ) * m_volume;
-		m_phase += osc_coeff;
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Sine>(const float sample)
-{
-	const float current_freq = m_freq * m_detuning_div_samplerate * Engine::audioEngine()->outputSampleRate();
-
-	if (!m_useWaveTable || current_freq < OscillatorConstants::MAX_FREQ)
-	{
-		return sinSample(sample);
-	}
-	else
-	{
-		return 0;
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Triangle>(
-		const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Triangle) - FirstWaveShapeTable],_sample);
-	}
-	else
-	{
-		return triangleSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Saw>(
-		const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Saw) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return sawSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Square>(
-		const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Square) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return squareSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::MoogSaw>(
-							const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::MoogSaw) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return moogSawSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::Exponential>(
-							const float _sample )
-{
-	if (m_useWaveTable && !m_isModulator)
-	{
-		return wtSample(s_waveTables[static_cast<std::size_t>(WaveShape::Exponential) - FirstWaveShapeTable], _sample);
-	}
-	else
-	{
-		return expSample(_sample);
-	}
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::WhiteNoise>(
-							const float _sample )
-{
-	return( noiseSample( _sample ) );
-}
-
-
-
-
-template<>
-inline sample_t Oscillator::getSample<Oscillator::WaveShape::UserDefined>(
-							const float _sample )
-{
-	if (m_useWaveTable && m_userAntiAliasWaveTable && !m_isModulator)
-	{
-		return wtSample(m_userAntiAliasWaveTable.get(), _sample);
-	}
-	else
-	{
-		return userWaveSample(m_userWave.get(), _sample);
-	}
+	withSampler<W>([&](auto getSample) {
+		auto phase = m_phase;
+		for( fpp_t frame = 0; frame < _frames; ++frame )
+		{
+			phase += _ab[frame][_chnl] * sampleRateCorrection;
+			_ab[frame][_chnl] = getSample( phase ) * volume;
+			phase += osc_coeff;
+		}
+		m_phase = phase;
+	});
 }
 
 
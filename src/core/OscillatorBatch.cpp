@@ -0,0 +1,620 @@
+/*
+ * OscillatorBatch.cpp - renders the oscillators of several voices at once
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "OscillatorBatch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "lmms_math.h"
+#include "RandomGenerator.h"
+
+
+namespace lmms
+{
+
+namespace
+{
+
+using Stage = OscillatorBatch::Stage;
+using WaveShape = Oscillator::WaveShape;
+using ModulationAlgo = Oscillator::ModulationAlgo;
+using OscillatorConstants::WAVETABLE_LENGTH;
+constexpr int Lanes = OscillatorBatch::Lanes;
+
+
+// The stage loops below are written once for two lane types: Vec holds one frame of all lanes, float the frame
+// of a single voice. Comparisons of Vecs return masks for select().
+
+#ifdef __SSE2__
+struct Vec
+{
+	Vec() = default;
+	explicit Vec(float x) : lo(_mm_set1_ps(x)), hi(lo) {}
+	Vec(__m128 l, __m128 h) : lo(l), hi(h) {}
+
+	__m128 lo;
+	__m128 hi;
+};
+
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)}; }
+inline Vec operator<(Vec a, Vec b) { return {_mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi)}; }
+inline Vec operator<=(Vec a, Vec b) { return {_mm_cmple_ps(a.lo, b.lo), _mm_cmple_ps(a.hi, b.hi)}; }
+inline Vec operator>(Vec a, Vec b) { return {_mm_cmpgt_ps(a.lo, b.lo), _mm_cmpgt_ps(a.hi, b.hi)}; }
+
+inline Vec select(Vec mask, Vec a, Vec b)
+{
+	return {_mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+		_mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi))};
+}
+
+inline __m128 floor4(__m128 x)
+{
+	// SSE2 can only truncate, so negative values which are not integers are corrected by one. Values of 2^23 and
+	// more are integers already and would overflow the conversion.
+	const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	const __m128 f = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+	const __m128 big = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), _mm_set1_ps(8388608.0f));
+	return _mm_or_ps(_mm_and_ps(big, x), _mm_andnot_ps(big, f));
+}
+
+inline Vec floorLanes(Vec x) { return {floor4(x.lo), floor4(x.hi)}; }
+
+template<typename V> V loadLanes(const float* p);
+template<> inline Vec loadLanes<Vec>(const float* p) { return {_mm_loadu_ps(p), _mm_loadu_ps(p + 4)}; }
+
+inline void storeLanes(float* p, Vec v)
+{
+	_mm_storeu_ps(p, v.lo);
+	_mm_storeu_ps(p + 4, v.hi);
+}
+
+//! Writes the lanes rounded toward zero to `out` and returns them as floats
+inline Vec truncLanes(Vec x, std::int32_t* out)
+{
+	const __m128i lo = _mm_cvttps_epi32(x.lo);
+	const __m128i hi = _mm_cvttps_epi32(x.hi);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), hi);
+	return {_mm_cvtepi32_ps(lo), _mm_cvtepi32_ps(hi)};
+}
+
+//! Rounds like std::lerp() for 0 <= t < 1, so that the lanes get the same samples as Oscillator
+inline __m128 lerp4(__m128 a, __m128 b, __m128 t)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 opposite = _mm_or_ps(_mm_and_ps(_mm_cmple_ps(a, zero), _mm_cmpge_ps(b, zero)),
+		_mm_and_ps(_mm_cmpge_ps(a, zero), _mm_cmple_ps(b, zero)));
+	const __m128 exact = _mm_add_ps(_mm_mul_ps(t, b), _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), t), a));
+	const __m128 x = _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+	const __m128 rising = _mm_cmpgt_ps(b, a);
+	const __m128 bounded = _mm_or_ps(_mm_and_ps(rising, _mm_min_ps(x, b)), _mm_andnot_ps(rising, _mm_max_ps(x, b)));
+	return _mm_or_ps(_mm_and_ps(opposite, exact), _mm_andnot_ps(opposite, bounded));
+}
+
+inline Vec lerpLanes(Vec a, Vec b, Vec t) { return {lerp4(a.lo, b.lo, t.lo), lerp4(a.hi, b.hi, t.hi)}; }
+#else
+struct Vec
+{
+	Vec() = default;
+	explicit Vec(float x) { v.fill(x); }
+
+	std::array<float, Lanes> v;
+};
+
+template<typename Fn>
+inline Vec zipLanes(Vec a, Vec b, Fn fn)
+{
+	auto r = Vec{};
+	for (int l = 0; l < Lanes; ++l) { r.v[l] = fn(a.v[l], b.v[l]); }
+	return r;
+}
+
+inline Vec operator+(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x + y; }); }
+inline Vec operator-(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x - y; }); }
+inline Vec operator*(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x * y; }); }
+inline Vec operator<(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x < y ? 1.0f : 0.0f; }); }
+inline Vec operator<=(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x <= y ? 1.0f : 0.0f; }); }
+inline Vec operator>(Vec a, Vec b) { return zipLanes(a, b, [](float x, float y) { return x > y ? 1.0f : 0.0f; }); }
+
+inline Vec select(Vec mask, Vec a, Vec b)
+{
+	auto r = Vec{};
+	for (int l = 0; l < Lanes; ++l) { r.v[l] = mask.v[l] != 0.0f ? a.v[l] : b.v[l]; }
+	return r;
+}
+
+inline Vec floorLanes(Vec x) { return zipLanes(x, x, [](float y, float) { return std::floor(y); }); }
+
+template<typename V> V loadLanes(const float* p);
+template<> inline Vec loadLanes<Vec>(const float* p)
+{
+	auto r = Vec{};
+	std::copy(p, p + Lanes, r.v.begin());
+	return r;
+}
+
+inline void storeLanes(float* p, Vec v) { std::copy(v.v.begin(), v.v.end(), p); }
+
+inline Vec truncLanes(Vec x, std::int32_t* out)
+{
+	for (int l = 0; l < Lanes; ++l) { out[l] = static_cast<std::int32_t>(x.v[l]); }
+	return zipLanes(x, x, [](float y, float) { return std::trunc(y); });
+}
+
+inline Vec lerpLanes(Vec a, Vec b, Vec t)
+{
+	auto r = Vec{};
+	for (int l = 0; l < Lanes; ++l) { r.v[l] = std::lerp(a.v[l], b.v[l], t.v[l]); }
+	return r;
+}
+#endif
+
+inline float select(bool mask, float a, float b) { return mask ? a : b; }
+inline float floorLanes(float x) { return std::floor(x); }
+template<> inline float loadLanes<float>(const float* p) { return *p; }
+inline void storeLanes(float* p, float v) { *p = v; }
+
+//! Applies fn to every lane on its own, for samples which can't be computed with SIMD instructions
+template<typename Fn>
+inline Vec mapLanes(Vec x, Fn fn)
+{
+	alignas(16) std::array<float, Lanes> v;
+	storeLanes(v.data(), x);
+	for (auto& s : v) { s = fn(s); }
+	return loadLanes<Vec>(v.data());
+}
+
+template<typename Fn>
+inline float mapLanes(float x, Fn fn) { return fn(x); }
+
+
+//! The same as absFraction()
+template<typename V>
+inline V phaseFraction(V x)
+{
+	return x - floorLanes(x);
+}
+
+
+// The wave shapes, computed like Oscillator::triangleSample() and the others
+template<typename V>
+inline V triangleWave(V sample)
+{
+	const V ph = phaseFraction(sample);
+	return select(ph <= V{0.25f}, ph * V{4.0f}, select(ph <= V{0.75f}, V{2.0f} - ph * V{4.0f}, ph * V{4.0f} - V{4.0f}));
+}
+
+template<typename V>
+inline V sawWave(V sample)
+{
+	return V{-1.0f} + phaseFraction(sample) * V{2.0f};
+}
+
+template<typename V>
+inline V squareWave(V sample)
+{
+	return select(phaseFraction(sample) > V{0.5f}, V{-1.0f}, V{1.0f});
+}
+
+template<typename V>
+inline V moogSawWave(V sample)
+{
+	const V ph = phaseFraction(sample);
+	return select(ph < V{0.5f}, V{-1.0f} + ph * V{4.0f}, V{1.0f} - V{2.0f} * ph);
+}
+
+template<typename V>
+inline V expWave(V sample)
+{
+	V ph = phaseFraction(sample);
+	ph = select(ph > V{0.5f}, V{1.0f} - ph, ph);
+	return V{-1.0f} + V{8.0f} * ph * ph;
+}
+
+
+// Linear interpolation in a band-limited table, `bands` holds the offset of the band each lane reads
+inline float tableSample(const sample_t* table, const int* bands, float sample)
+{
+	const float frame = absFraction(sample) * WAVETABLE_LENGTH;
+	const auto f1 = static_cast<f_cnt_t>(frame);
+	const auto f2 = f1 < WAVETABLE_LENGTH - 1 ? f1 + 1 : 0;
+	return std::lerp(table[bands[0] + f1], table[bands[0] + f2], fraction(frame));
+}
+
+inline Vec tableSample(const sample_t* table, const int* bands, Vec sample)
+{
+	const Vec frame = phaseFraction(sample) * Vec{static_cast<float>(WAVETABLE_LENGTH)};
+	alignas(16) std::array<std::int32_t, Lanes> f1;
+	const Vec weight = frame - truncLanes(frame, f1.data());
+
+	alignas(16) std::array<float, Lanes> a;
+	alignas(16) std::array<float, Lanes> b;
+	for (int l = 0; l < Lanes; ++l)
+	{
+		// a fraction of exactly 1 wraps around to the start of the table
+		const auto i1 = f1[l] < WAVETABLE_LENGTH ? f1[l] : 0;
+		const auto i2 = i1 < WAVETABLE_LENGTH - 1 ? i1 + 1 : 0;
+		a[l] = table[bands[l] + i1];
+		b[l] = table[bands[l] + i2];
+	}
+	return lerpLanes(loadLanes<Vec>(a.data()), loadLanes<Vec>(b.data()), weight);
+}
+
+
+// Calls fn with a callable which returns the samples of wave shape W for the phases of all lanes. Like
+// Oscillator::withSampler(), it decides once per period whether band-limited tables are used, and which band
+// each lane reads from them.
+template<typename V, WaveShape W, typename Fn>
+void withSampler(const Stage& stage, const float* freqs, bool isModulator, Fn&& fn)
+{
+	constexpr int N = std::is_same_v<V, float> ? 1 : Lanes;
+	const float sampleRate = Engine::audioEngine()->outputSampleRate();
+	const bool useWaveTable = stage.useWaveTable && !isModulator;
+
+	auto bands = std::array<int, N>{};
+	auto gains = std::array<float, N>{};
+	for (int l = 0; l < N; ++l)
+	{
+		const float freq = freqs[l] * stage.detuning * sampleRate;
+		bands[l] = Oscillator::waveTableBandFromFreq(freq) * WAVETABLE_LENGTH;
+		gains[l] = freq >= OscillatorConstants::MAX_FREQ ? 0.0f : 1.0f;
+	}
+
+	if constexpr (W == WaveShape::Sine)
+	{
+		if (stage.useWaveTable)
+		{
+			// lanes above the highest table frequency are silent
+			fn([gain = loadLanes<V>(gains.data())](V sample) {
+				return mapLanes(sample, Oscillator::sinSample) * gain;
+			});
+		}
+		else
+		{
+			fn([](V sample) { return mapLanes(sample, Oscillator::sinSample); });
+		}
+	}
+	else if constexpr (W == WaveShape::WhiteNoise)
+	{
+		fn([&rng = RandomGenerator::forThread()](V sample) {
+			return mapLanes(sample, [&rng](float) { return rng.bipolar(); });
+		});
+	}
+	else if constexpr (W == WaveShape::UserDefined)
+	{
+		if (useWaveTable && stage.userAntiAliasWaveTable)
+		{
+			fn([table = (*stage.userAntiAliasWaveTable)[0].data(), &bands](V sample) {
+				return tableSample(table, bands.data(), sample);
+			});
+		}
+		else
+		{
+			fn([buffer = stage.userWave](V sample) {
+				return mapLanes(sample, [buffer](float s) { return Oscillator::userWaveSample(buffer, s); });
+			});
+		}
+	}
+	else
+	{
+		if (useWaveTable)
+		{
+			fn([table = Oscillator::waveTable(W), &bands](V sample) {
+				return tableSample(table, bands.data(), sample);
+			});
+		}
+		else if constexpr (W == WaveShape::Triangle) { fn([](V sample) { return triangleWave(sample); }); }
+		else if constexpr (W == WaveShape::Saw) { fn([](V sample) { return sawWave(sample); }); }
+		else if constexpr (W == WaveShape::Square) { fn([](V sample) { return squareWave(sample); }); }
+		else if constexpr (W == WaveShape::MoogSaw) { fn([](V sample) { return moogSawWave(sample); }); }
+		else if constexpr (W == WaveShape::Exponential) { fn([](V sample) { return expWave(sample); }); }
+	}
+}
+
+
+template<typename V, typename Fn>
+void withSampler(const Stage& stage, const float* freqs, bool isModulator, Fn&& fn)
+{
+	switch (stage.waveShape)
+	{
+		case WaveShape::Sine:
+		default:
+			withSampler<V, WaveShape::Sine>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::Triangle:
+			withSampler<V, WaveShape::Triangle>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::Saw:
+			withSampler<V, WaveShape::Saw>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::Square:
+			withSampler<V, WaveShape::Square>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::MoogSaw:
+			withSampler<V, WaveShape::MoogSaw>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::Exponential:
+			withSampler<V, WaveShape::Exponential>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::WhiteNoise:
+			withSampler<V, WaveShape::WhiteNoise>(stage, freqs, isModulator, fn);
+			break;
+		case WaveShape::UserDefined:
+			withSampler<V, WaveShape::UserDefined>(stage, freqs, isModulator, fn);
+			break;
+	}
+}
+
+
+//! Frame f of lane l is at data[f * Lanes + l]
+struct LaneBuffer
+{
+	float* data;
+
+	Vec get(fpp_t frame) const { return loadLanes<Vec>(data + frame * Lanes); }
+	void set(fpp_t frame, Vec v) const { storeLanes(data + frame * Lanes, v); }
+};
+
+//! One channel of the buffer of a single voice
+struct ChannelBuffer
+{
+	SampleFrame* ab;
+	ch_cnt_t chnl;
+
+	float get(fpp_t frame) const { return ab[frame][chnl]; }
+	void set(fpp_t frame, float v) const { ab[frame][chnl] = v; }
+};
+
+
+// The same as Oscillator::recalcPhase() for each lane
+void recalcPhases(float* phases, float* phaseOffsets, float phaseOffset, int lanes)
+{
+	for (int l = 0; l < lanes; ++l)
+	{
+		if (!approximatelyEqual(phaseOffsets[l], phaseOffset))
+		{
+			phases[l] -= phaseOffsets[l];
+			phaseOffsets[l] = phaseOffset;
+			phases[l] += phaseOffsets[l];
+		}
+		phases[l] = absFraction(phases[l]);
+	}
+}
+
+
+// Renders a chain in the same order as Oscillator::update() renders an oscillator and its sub-oscillators: the
+// last oscillator first, then each one on top of the output of the next.
+template<typename V, typename Buffer>
+void renderChain(OscillatorBatch::Chain chain, float* const* phases, float* const* phaseOffsets,
+	const float* freqs, Buffer buf, fpp_t frames)
+{
+	constexpr int N = std::is_same_v<V, float> ? 1 : Lanes;
+	const V freq = loadLanes<V>(freqs);
+	const V sampleRateCorrection{44100.0f / Engine::audioEngine()->outputSampleRate()};
+	const int last = static_cast<int>(chain.size()) - 1;
+
+	// An oscillator synchronized by the next one only advances the phase of the next one, whose output is not
+	// rendered. The one after is rendered though, like Oscillator::syncInit() does.
+	auto rendered = std::array<bool, OscillatorBatch::MaxOscillators>{};
+	for (int i = 0; i <= last; ++i)
+	{
+		rendered[i] = i == 0 || !rendered[i - 1] || chain[i - 1].modulationAlgo != ModulationAlgo::SynchronizedBySubOsc;
+	}
+
+	for (int i = last; i >= 0; --i)
+	{
+		if (!rendered[i]) { continue; }
+
+		const Stage& stage = chain[i];
+		const auto algo = stage.modulationAlgo;
+		// oscillators used for phase or frequency modulation don't use band-limited tables
+		const bool isModulator = i > 0 && rendered[i - 1]
+			&& (chain[i - 1].modulationAlgo == ModulationAlgo::PhaseModulation
+				|| chain[i - 1].modulationAlgo == ModulationAlgo::FrequencyModulation);
+
+		if (i < last && algo == ModulationAlgo::SynchronizedBySubOsc)
+		{
+			recalcPhases(phases[i + 1], phaseOffsets[i + 1], chain[i + 1].phaseOffset, N);
+		}
+		recalcPhases(phases[i], phaseOffsets[i], stage.phaseOffset, N);
+		const V coeff = freq * V{stage.detuning};
+		const V volume{stage.volume};
+
+		withSampler<V>(stage, freqs, isModulator, [&](auto getSample) {
+			V phase = loadLanes<V>(phases[i]);
+			if (i == last)
+			{
+				for (fpp_t frame = 0; frame < frames; ++frame)
+				{
+					buf.set(frame, getSample(phase) * volume);
+					phase = phase + coeff;
+				}
+			}
+			else
+			{
+				switch (algo)
+				{
+					case ModulationAlgo::PhaseModulation:
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							buf.set(frame, getSample(phase + buf.get(frame)) * volume);
+							phase = phase + coeff;
+						}
+						break;
+					case ModulationAlgo::AmplitudeModulation:
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							buf.set(frame, buf.get(frame) * (getSample(phase) * volume));
+							phase = phase + coeff;
+						}
+						break;
+					case ModulationAlgo::SignalMix:
+					default:
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							buf.set(frame, buf.get(frame) + getSample(phase) * volume);
+							phase = phase + coeff;
+						}
+						break;
+					case ModulationAlgo::SynchronizedBySubOsc:
+					{
+						// restart wherever the next oscillator starts a new period
+						const V subCoeff = freq * V{chain[i + 1].detuning};
+						const V phaseOffset = loadLanes<V>(phaseOffsets[i]);
+						V subPhase = loadLanes<V>(phases[i + 1]);
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							const V nextSubPhase = subPhase + subCoeff;
+							phase = select(floorLanes(nextSubPhase) > floorLanes(subPhase), phaseOffset, phase);
+							subPhase = nextSubPhase;
+							buf.set(frame, getSample(phase) * volume);
+							phase = phase + coeff;
+						}
+						storeLanes(phases[i + 1], subPhase);
+						break;
+					}
+					case ModulationAlgo::FrequencyModulation:
+						for (fpp_t frame = 0; frame < frames; ++frame)
+						{
+							phase = phase + buf.get(frame) * sampleRateCorrection;
+							buf.set(frame, getSample(phase) * volume);
+							phase = phase + coeff;
+						}
+						break;
+				}
+			}
+			storeLanes(phases[i], phase);
+		});
+	}
+}
+
+
+} // namespace
+
+
+
+
+void OscillatorBatch::startVoice(int lane, Chain chain)
+{
+	assert(chain.size() <= MaxOscillators);
+	for (std::size_t i = 0; i < chain.size(); ++i)
+	{
+		m_phases[i][lane] = chain[i].phaseOffset;
+		m_phaseOffsets[i][lane] = chain[i].phaseOffset;
+	}
+}
+
+
+
+
+void OscillatorBatch::render(Chain chain, const std::array<float, Lanes>& freqs, unsigned lanes, float* out,
+	fpp_t frames)
+{
+	assert(chain.size() <= MaxOscillators);
+
+	// Like Oscillator::update(), voices at or above the Nyquist frequency are silent and keep their phases. All
+	// lanes are computed, the ones left out with a frequency the wave table lookup can handle.
+	auto laneFreqs = freqs;
+	for (int l = 0; l < Lanes; ++l)
+	{
+		if (!(lanes & (1u << l)) || freqs[l] >= Engine::audioEngine()->outputSampleRate() / 2)
+		{
+			lanes &= ~(1u << l);
+			laneFreqs[l] = 440.0f;
+		}
+	}
+	if (lanes == 0)
+	{
+		std::fill(out, out + frames * Lanes, 0.0f);
+		return;
+	}
+
+	const auto phases = m_phases;
+	const auto phaseOffsets = m_phaseOffsets;
+	auto phasePtrs = std::array<float*, MaxOscillators>{};
+	auto phaseOffsetPtrs = std::array<float*, MaxOscillators>{};
+	for (std::size_t i = 0; i < chain.size(); ++i)
+	{
+		phasePtrs[i] = m_phases[i].data();
+		phaseOffsetPtrs[i] = m_phaseOffsets[i].data();
+	}
+
+	renderChain<Vec>(chain, phasePtrs.data(), phaseOffsetPtrs.data(), laneFreqs.data(), LaneBuffer{out}, frames);
+
+	for (int l = 0; l < Lanes; ++l)
+	{
+		if (lanes & (1u << l)) { continue; }
+		for (std::size_t i = 0; i < chain.size(); ++i)
+		{
+			m_phases[i][l] = phases[i][l];
+			m_phaseOffsets[i][l] = phaseOffsets[i][l];
+		}
+		for (fpp_t frame = 0; frame < frames; ++frame)
+		{
+			out[frame * Lanes + l] = 0.0f;
+		}
+	}
+}
+
+
+
+
+void OscillatorBatch::renderVoice(int lane, Chain chain, float freq, SampleFrame* buf, fpp_t frames, ch_cnt_t chnl)
+{
+	assert(chain.size() <= MaxOscillators);
+
+	if (freq >= Engine::audioEngine()->outputSampleRate() / 2)
+	{
+		for (fpp_t frame = 0; frame < frames; ++frame)
+		{
+			buf[frame][chnl] = 0.0f;
+		}
+		return;
+	}
+
+	auto phasePtrs = std::array<float*, MaxOscillators>{};
+	auto phaseOffsetPtrs = std::array<float*, MaxOscillators>{};
+	for (std::size_t i = 0; i < chain.size(); ++i)
+	{
+		phasePtrs[i] = &m_phases[i][lane];
+		phaseOffsetPtrs[i] = &m_phaseOffsets[i][lane];
+	}
+
+	renderChain<float>(chain, phasePtrs.data(), phaseOffsetPtrs.data(), &freq, ChannelBuffer{buf, chnl}, frames);
+}
+
+
+} // namespace lmms
@@ -25,6 +25,8 @@
 
 #include "PatternStore.h"
 
+#include <algorithm>
+
 #include "Clip.h"
 #include "Engine.h"
 #include "PatternTrack.h"
@@ -216,7 +218,7 @@ void PatternStore::createClipsForPattern(int pattern)
 	}
 }
 
-AutomatedValueMap PatternStore::automatedValuesAt(TimePos time, int clipNum) const
+AutomationSourceMap PatternStore::automationSourcesAt(TimePos time, int clipNum, TimePos* validUntil) const
 {
 	Q_ASSERT(clipNum >= 0);
 	Q_ASSERT(time.getTicks() >= 0);
@@ -228,7 +230,15 @@ AutomatedValueMap PatternStore::automatedValuesAt(TimePos time, int clipNum) con
 		time = lengthTicks;
 	}
 
-	return TrackContainer::automatedValuesAt(time + (TimePos::ticksPerBar() * clipNum), clipNum);
+	const tick_t patternOffset = TimePos::ticksPerBar() * clipNum;
+	auto sources = TrackContainer::automationSourcesAt(time + patternOffset, clipNum, validUntil);
+	for (auto& source : sources)
+	{
+		// map back to the pattern's time, which stops at the end of the pattern
+		source.shift -= patternOffset;
+		source.limit = std::min(source.limit, lengthTicks - source.shift);
+	}
+	return sources;
 }
 
 
@@ -23,6 +23,7 @@
  */
  
 #include "PlayHandle.h"
+#include "AudioBusHandle.h"
 #include "AudioEngine.h"
 #include "BufferManager.h"
 #include "Engine.h"
@@ -34,6 +35,7 @@ namespace lmms
 {
 
 PlayHandle::PlayHandle(const Type type, f_cnt_t offset) :
+		ThreadableJob(TraceRecorder::Category::PlayHandle),
 		m_type(type),
 		m_offset(offset),
 		m_affinity(QThread::currentThread()),
@@ -62,6 +64,16 @@ void PlayHandle::doProcessing()
 	{
 		play( nullptr );
 	}
+
+	// let the bus handle start as soon as all of its play handles are done
+	m_audioBusHandle->incrementDeps();
+}
+
+
+void PlayHandle::setAudioBusHandle(AudioBusHandle* busHandle)
+{
+	m_audioBusHandle = busHandle;
+	if (busHandle) { setTraceName(busHandle->traceName()); }
 }
 
 
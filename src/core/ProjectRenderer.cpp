@@ -28,6 +28,8 @@
 #include "ProjectRenderer.h"
 #include "Song.h"
 #include "PerfLog.h"
+#include "StemExporter.h"
+#include "TraceRecorder.h"
 
 #include "AudioFileWave.h"
 #include "AudioFileOgg.h"
@@ -79,6 +81,7 @@ ProjectRenderer::ProjectRenderer(
 	const OutputSettings& outputSettings, ExportFileFormat exportFileFormat, const QString& outputFilename)
 	: QThread(Engine::audioEngine())
 	, m_fileDev(nullptr)
+	, m_stems(nullptr)
 	, m_progress(0)
 	, m_abort(false)
 {
@@ -154,10 +157,12 @@ void ProjectRenderer::startProcessing()
 void ProjectRenderer::run()
 {
 	PerfLogTimer perfLog("Project Render");
+	TraceRecorder::setThreadName("Project renderer");
 
 	Engine::getSong()->startExport();
 	// Skip first empty buffer.
 	Engine::audioEngine()->nextBuffer();
+	if (m_stems) { m_stems->skip(); }
 
 	m_progress = 0;
 
@@ -168,6 +173,7 @@ void ProjectRenderer::run()
 	while (!Engine::getSong()->isExportDone() && !m_abort)
 	{
 		m_fileDev->processNextBuffer();
+		if (m_stems) { m_stems->capture(); }
 		const int nprog = Engine::getSong()->getExportProgress();
 		if (m_progress != nprog)
 		{
@@ -34,6 +34,7 @@
 #endif
 
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "MidiEvent.h"
 #include "Song.h"
@@ -144,9 +145,23 @@ RemotePlugin::RemotePlugin() :
 #endif
 	m_splitChannels( false ),
 	m_audioBufferSize( 0 ),
+	m_pipelined(ConfigManager::inst()->value("audioengine", "remotepipelining").toInt()),
+	m_pendingSlot(-1),
+	m_periodsInFlight(0),
 	m_inputCount( DEFAULT_CHANNELS ),
 	m_outputCount( DEFAULT_CHANNELS )
 {
+	if (m_pipelined)
+	{
+		static bool warned = false;
+		if (!warned)
+		{
+			qWarning("RemotePlugin: bridged plugins run in parallel, their output is one period late. "
+				"This delay is not compensated.");
+			warned = true;
+		}
+	}
+
 #ifndef SYNC_WITH_SHM_FIFO
 	struct sockaddr_un sa;
 	sa.sun_family = AF_LOCAL;
@@ -362,7 +377,14 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		return false;
 	}
 
-	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
+	lock();
+	// in pipelined mode, write to the slot the remote process isn't busy with
+	waitForPeriodsInFlight(m_pipelined ? 1 : 0);
+	const int slot = m_pendingSlot == 0 ? 1 : 0;
+	const std::size_t slotSize = (m_inputCount + m_outputCount) * frames;
+	float* buffer = m_audioBuffer.get() + slot * slotSize;
+
+	memset(buffer, 0, slotSize * sizeof(float));
 
 	ch_cnt_t inputs = std::min<ch_cnt_t>(m_inputCount, DEFAULT_CHANNELS);
 
@@ -374,19 +396,18 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
 				{
-					m_audioBuffer[ch * frames + frame] =
+					buffer[ch * frames + frame] =
 							_in_buf[frame][ch];
 				}
 			}
 		}
 		else if( inputs == DEFAULT_CHANNELS )
 		{
-			auto target = m_audioBuffer.get();
-			copyFromSampleFrames(target, _in_buf, frames);
+			copyFromSampleFrames(buffer, _in_buf, frames);
 		}
 		else
 		{
-			auto o = (SampleFrame*)m_audioBuffer.get();
+			auto o = (SampleFrame*)buffer;
 			for( ch_cnt_t ch = 0; ch < inputs; ++ch )
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
@@ -397,8 +418,18 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		}
 	}
 
-	lock();
-	sendMessage( IdStartProcessing );
+	int readySlot = slot;
+	if (m_pipelined)
+	{
+		sendMessage(message(IdStartProcessing).addInt(slot));
+		readySlot = m_pendingSlot;
+		m_pendingSlot = slot;
+	}
+	else
+	{
+		sendMessage(IdStartProcessing);
+	}
+	++m_periodsInFlight;
 
 	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
 	{
@@ -406,7 +437,16 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		return false;
 	}
 
-	waitForMessage( IdProcessingDone );
+	if (readySlot < 0)
+	{
+		// nothing submitted before, the first period is silent
+		unlock();
+		zeroSampleFrames(_out_buf, frames);
+		return true;
+	}
+	buffer = m_audioBuffer.get() + readySlot * slotSize;
+
+	waitForPeriodsInFlight(m_pipelined ? 1 : 0);
 	unlock();
 
 	const ch_cnt_t outputs = std::min<ch_cnt_t>(m_outputCount,
@@ -417,19 +457,19 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 		{
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				_out_buf[frame][ch] = m_audioBuffer[( m_inputCount+ch )*
+				_out_buf[frame][ch] = buffer[( m_inputCount+ch )*
 								frames + frame];
 			}
 		}
 	}
 	else if( outputs == DEFAULT_CHANNELS )
 	{
-		auto source = m_audioBuffer.get() + m_inputCount * frames;
+		auto source = buffer + m_inputCount * frames;
 		copyToSampleFrames(_out_buf, source, frames);
 	}
 	else
 	{
-		auto o = (SampleFrame*)(m_audioBuffer.get() + m_inputCount * frames);
+		auto o = (SampleFrame*)(buffer + m_inputCount * frames);
 		// clear buffer, if plugin didn't fill up both channels
 		zeroSampleFrames(_out_buf, frames);
 
@@ -449,6 +489,22 @@ bool RemotePlugin::process( const SampleFrame* _in_buf, SampleFrame* _out_buf )
 
 
 
+void RemotePlugin::waitForPeriodsInFlight(int periods)
+{
+	// the remote process finishes the periods in order, and their replies
+	// may already have been fetched by other waitForMessage() calls
+	while (m_periodsInFlight > periods && !m_failed)
+	{
+		if (waitForMessage(IdProcessingDone).id != IdProcessingDone)
+		{
+			break;
+		}
+	}
+}
+
+
+
+
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 							const f_cnt_t _offset )
 {
@@ -482,7 +538,9 @@ void RemotePlugin::hideUI()
 
 void RemotePlugin::resizeSharedProcessingMemory()
 {
-	const size_t s = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod();
+	// two slots in pipelined mode
+	const size_t s = (m_inputCount + m_outputCount) * Engine::audioEngine()->framesPerPeriod()
+		* (m_pipelined ? 2 : 1);
 	try
 	{
 		m_audioBuffer.create(s);
@@ -571,6 +629,10 @@ bool RemotePlugin::processMessage( const message & _m )
 			break;
 
 		case IdProcessingDone:
+			// counted here, as any waitForMessage() call may fetch the reply
+			if (m_periodsInFlight > 0) { --m_periodsInFlight; }
+			break;
+
 		case IdQuit:
 		default:
 			break;
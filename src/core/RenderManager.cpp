@@ -27,6 +27,7 @@
 
 #include "RenderManager.h"
 
+#include "Mixer.h"
 #include "PatternStore.h"
 #include "Song.h"
 
@@ -53,8 +54,20 @@ void RenderManager::abortProcessing()
 	if ( m_activeRenderer ) {
 		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
 				this, SLOT(renderNextTrack()));
+		disconnect( m_activeRenderer.get(), SIGNAL(finished()),
+				this, SLOT(finishStems()));
 		m_activeRenderer->abortProcessing();
 	}
+	if (m_stemExporter)
+	{
+		m_stemExporter->abort();
+		m_stemExporter.reset();
+	}
+	if (m_segmentRenderer)
+	{
+		m_segmentRenderer->abort();
+		m_segmentRenderer.reset();
+	}
 	restoreMutedState();
 }
 
@@ -91,39 +104,135 @@ void RenderManager::renderNextTrack()
 // Render the song into individual tracks
 void RenderManager::renderTracks()
 {
-	const TrackContainer::TrackList& tl = Engine::getSong()->tracks();
-
 	// find all currently unnmuted tracks -- we want to render these.
-	for (const auto& tk : tl)
+	m_unmuted = unmutedTracks();
+
+	// copy the list of unmuted tracks into our rendering queue.
+	// we need to remember which tracks were unmuted to restore state at the end.
+	m_tracksToRender = m_unmuted;
+
+	renderNextTrack();
+}
+
+// Render the song once, tapping each track on its way into the mixer
+void RenderManager::renderTracksInOnePass(bool mixerChannels)
+{
+	m_stemExporter = std::make_unique<StemExporter>(m_outputSettings, m_format);
+
+	const auto tracks = unmutedTracks();
+	for (std::size_t i = 0; i < tracks.size(); ++i)
 	{
-		Track::Type type = tk->type();
+		// same numbering as renderTracks()
+		m_stemExporter->addTrack(tracks[i], pathForTrack(tracks[i], i + 1));
+	}
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+	if (mixerChannels)
+	{
+		const auto mixer = Engine::mixer();
+		for (mix_ch_t i = 0; i < mixer->numChannels(); ++i)
 		{
-			m_unmuted.push_back(tk);
+			m_stemExporter->addMixerChannel(mixer->mixerChannel(i), pathForMixerChannel(mixer->mixerChannel(i)));
 		}
 	}
 
-	const TrackContainer::TrackList& t2 = Engine::patternStore()->tracks();
-	for (const auto& tk : t2)
+	const auto mixPath = QDir(m_outputPath).filePath("Mix" + ProjectRenderer::getFileExtensionFromFormat(m_format));
+	m_activeRenderer = std::make_unique<ProjectRenderer>(m_outputSettings, m_format, mixPath);
+
+	if (!m_activeRenderer->isReady())
+	{
+		qDebug( "Renderer failed to acquire a file device!" );
+		m_stemExporter->abort();
+		finishStems();
+		return;
+	}
+
+	m_activeRenderer->setStemExporter(m_stemExporter.get());
+	m_stemExporter->attach();
+
+	connect(m_activeRenderer.get(), SIGNAL(progressChanged(int)),
+			this, SIGNAL(progressChanged(int)));
+	connect(m_activeRenderer.get(), SIGNAL(finished()),
+			this, SLOT(finishStems()));
+
+	m_activeRenderer->startProcessing();
+}
+
+// Called when the one pass render of all tracks is done
+void RenderManager::finishStems()
+{
+	m_activeRenderer.reset();
+
+	if (m_stemExporter)
+	{
+		m_stemExporter->finish();
+		m_stemExporter.reset();
+	}
+
+	emit finished();
+}
+
+// Render the song in segments, each by a process of its own
+void RenderManager::renderProjectInSegments(int segments, int prerollBars, bool verify)
+{
+	m_segmentRenderer = std::make_unique<SegmentRenderer>(m_outputSettings, m_format, m_outputPath);
+
+	if (!m_segmentRenderer->plan(segments, prerollBars))
+	{
+		m_segmentRenderer.reset();
+		renderProject();
+		return;
+	}
+
+	connect(m_segmentRenderer.get(), SIGNAL(progressChanged(int)),
+			this, SIGNAL(progressChanged(int)));
+	// queued, the segment renderer is deleted once it is finished
+	connect(m_segmentRenderer.get(), SIGNAL(finished()),
+			this, SLOT(finishSegments()), Qt::QueuedConnection);
+
+	m_segmentRenderer->start(verify);
+}
+
+// Called when all segments are rendered and stitched together
+void RenderManager::finishSegments()
+{
+	const bool successful = m_segmentRenderer->successful();
+	if (!m_segmentRenderer->report().isEmpty())
+	{
+		fprintf(stderr, "\n%s\n", qPrintable(m_segmentRenderer->report()));
+	}
+	m_segmentRenderer.reset();
+
+	if (!successful)
 	{
-		Track::Type type = tk->type();
+		qWarning("Rendering in segments failed, rendering the song normally");
+		renderProject();
+		return;
+	}
+
+	emit finished();
+}
+
+// Instrument and sample tracks of the song and the pattern store which are not muted
+std::vector<Track*> RenderManager::unmutedTracks() const
+{
+	std::vector<Track*> tracks;
 
-		// Don't render automation tracks
-		if ( tk->isMuted() == false &&
-				( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+	for (const auto& trackList : {Engine::getSong()->tracks(), Engine::patternStore()->tracks()})
+	{
+		for (const auto& tk : trackList)
 		{
-			m_unmuted.push_back(tk);
+			Track::Type type = tk->type();
+
+			// Don't render automation tracks
+			if ( tk->isMuted() == false &&
+					( type == Track::Type::Instrument || type == Track::Type::Sample ) )
+			{
+				tracks.push_back(tk);
+			}
 		}
 	}
 
-	// copy the list of unmuted tracks into our rendering queue.
-	// we need to remember which tracks were unmuted to restore state at the end.
-	m_tracksToRender = m_unmuted;
-
-	renderNextTrack();
+	return tracks;
 }
 
 // Render the song into a single track
@@ -177,8 +286,24 @@ QString RenderManager::pathForTrack(const Track *track, int num)
 	return QDir(m_outputPath).filePath(name);
 }
 
+// Determine the output path for a mixer channel when rendering tracks in one pass
+QString RenderManager::pathForMixerChannel(const MixerChannel* channel)
+{
+	QString extension = ProjectRenderer::getFileExtensionFromFormat( m_format );
+	QString name = channel->m_name;
+	name = name.remove(QRegularExpression(FILENAME_FILTER));
+	name = QString( "Mixer_%1_%2%3" ).arg( channel->index() ).arg( name ).arg( extension );
+	return QDir(m_outputPath).filePath(name);
+}
+
 void RenderManager::updateConsoleProgress()
 {
+	if (m_segmentRenderer)
+	{
+		fprintf(stderr, "\rRendering %zu segments... %3d%%  ", m_segmentRenderer->count(), m_segmentRenderer->progress());
+		return;
+	}
+
 	if ( m_activeRenderer )
 	{
 		m_activeRenderer->updateConsoleProgress();
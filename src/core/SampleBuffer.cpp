@@ -23,13 +23,85 @@
  */
 
 #include "SampleBuffer.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstdint>
 #include <cstring>
 
 #include "PathUtil.h"
 #include "SampleDecoder.h"
+#include "ThreadPool.h"
 
 namespace lmms {
 
+namespace {
+
+//! Cache files are removed, oldest first, when the directory grows beyond this
+constexpr auto MaxCacheBytes = qint64{4} << 30;
+
+//! Bump when the layout of cache files or the way samples are decoded changes
+constexpr auto CacheFileVersion = std::uint32_t{1};
+constexpr char CacheFileMagic[8] = {'L', 'M', 'M', 'S', 'S', 'M', 'P', 'L'};
+
+//! A cache file is this header followed by the frames in native byte order. The header is padded, so the frames
+//! are suitably aligned in the mapping.
+struct CacheFileHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t sampleRate;
+	std::uint64_t frames;
+	char reserved[40];
+};
+static_assert(sizeof(CacheFileHeader) == 64);
+
+auto cacheDir() -> QString
+{
+	return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/samples";
+}
+
+auto cacheFilePath(const QFileInfo& fileInfo) -> QString
+{
+	const auto key = QString{"%1\n%2\n%3"}
+		.arg(fileInfo.absoluteFilePath())
+		.arg(fileInfo.lastModified().toMSecsSinceEpoch())
+		.arg(fileInfo.size());
+	const auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+	return cacheDir() + "/" + QString::fromLatin1(hash) + ".f32";
+}
+
+void trimCache()
+{
+	const auto files = QDir{cacheDir()}.entryInfoList({"*.f32"}, QDir::Files, QDir::Time);
+
+	auto total = qint64{0};
+	for (const auto& file : files)
+	{
+		total += file.size();
+		if (total > MaxCacheBytes) { QFile::remove(file.absoluteFilePath()); }
+	}
+}
+
+//! Reads the mapping once in the background, so playback rarely has to wait for the disk
+void prefetch(std::shared_ptr<QFile> file, const SampleFrame* data, std::size_t frames)
+{
+	ThreadPool::instance().enqueue([file = std::move(file), data, frames] {
+		constexpr auto PageSize = std::size_t{4096};
+		const auto bytes = reinterpret_cast<const volatile unsigned char*>(data);
+		for (auto offset = std::size_t{0}; offset < frames * sizeof(SampleFrame); offset += PageSize)
+		{
+			static_cast<void>(bytes[offset]);
+		}
+	});
+}
+
+} // namespace
+
 SampleBuffer::SampleBuffer(const SampleFrame* data, size_t numFrames, int sampleRate)
 	: m_data(data, data + numFrames)
 	, m_sampleRate(sampleRate)
@@ -41,12 +113,26 @@ SampleBuffer::SampleBuffer(const QString& audioFile)
 	if (audioFile.isEmpty()) { throw std::runtime_error{"Failure loading audio file: Audio file path is empty."}; }
 	const auto absolutePath = PathUtil::toAbsolute(audioFile);
 
+	const auto fileInfo = QFileInfo{absolutePath};
+	const auto cacheFile = fileInfo.exists() ? cacheFilePath(fileInfo) : QString{};
+	if (!cacheFile.isEmpty() && mapCacheFile(cacheFile))
+	{
+		m_audioFile = PathUtil::toShortestRelative(audioFile);
+		return;
+	}
+
 	if (auto decodedResult = SampleDecoder::decode(absolutePath))
 	{
 		auto& [data, sampleRate] = *decodedResult;
 		m_data = std::move(data);
 		m_sampleRate = sampleRate;
 		m_audioFile = PathUtil::toShortestRelative(audioFile);
+
+		if (!cacheFile.isEmpty() && m_data.size() * sizeof(SampleFrame) > MappedSizeThreshold)
+		{
+			writeCacheFile(cacheFile);
+			if (mapCacheFile(cacheFile)) { m_data = std::vector<SampleFrame>{}; }
+		}
 		return;
 	}
 
@@ -73,6 +159,9 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 {
 	using std::swap;
 	swap(first.m_data, second.m_data);
+	swap(first.m_mappedFile, second.m_mappedFile);
+	swap(first.m_mappedData, second.m_mappedData);
+	swap(first.m_mappedSize, second.m_mappedSize);
 	swap(first.m_audioFile, second.m_audioFile);
 	swap(first.m_sampleRate, second.m_sampleRate);
 }
@@ -80,12 +169,60 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 QString SampleBuffer::toBase64() const
 {
 	// TODO: Replace with non-Qt equivalent
-	const auto data = reinterpret_cast<const char*>(m_data.data());
-	const auto size = static_cast<int>(m_data.size() * sizeof(SampleFrame));
+	const auto data = reinterpret_cast<const char*>(this->data());
+	const auto size = static_cast<int>(this->size() * sizeof(SampleFrame));
 	const auto byteArray = QByteArray{data, size};
 	return byteArray.toBase64();
 }
 
+auto SampleBuffer::mapCacheFile(const QString& cacheFile) -> bool
+{
+	auto file = std::make_shared<QFile>(cacheFile);
+	if (!file->open(QFile::ReadOnly)) { return false; }
+
+	const auto size = static_cast<std::size_t>(file->size());
+	if (size < sizeof(CacheFileHeader)) { return false; }
+
+	auto header = CacheFileHeader{};
+	if (file->read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) { return false; }
+	if (std::memcmp(header.magic, CacheFileMagic, sizeof(CacheFileMagic)) != 0 || header.version != CacheFileVersion
+		|| header.sampleRate == 0 || header.frames == 0
+		|| header.frames > (size - sizeof(header)) / sizeof(SampleFrame))
+	{
+		return false;
+	}
+
+	const auto mapping = file->map(0, file->size());
+	if (!mapping) { return false; }
+
+	m_mappedFile = std::move(file);
+	m_mappedData = reinterpret_cast<const SampleFrame*>(mapping + sizeof(CacheFileHeader));
+	m_mappedSize = header.frames;
+	m_sampleRate = header.sampleRate;
+
+	prefetch(m_mappedFile, m_mappedData, m_mappedSize);
+	return true;
+}
+
+void SampleBuffer::writeCacheFile(const QString& cacheFile) const
+{
+	if (!QDir{}.mkpath(cacheDir())) { return; }
+
+	auto header = CacheFileHeader{};
+	std::memcpy(header.magic, CacheFileMagic, sizeof(CacheFileMagic));
+	header.version = CacheFileVersion;
+	header.sampleRate = m_sampleRate;
+	header.frames = m_data.size();
+
+	auto file = QSaveFile{cacheFile};
+	if (!file.open(QFile::WriteOnly)) { return; }
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_data.data()), m_data.size() * sizeof(SampleFrame));
+
+	if (file.commit()) { trimCache(); }
+}
+
 auto SampleBuffer::emptyBuffer() -> std::shared_ptr<const SampleBuffer>
 {
 	static auto s_buffer = std::make_shared<const SampleBuffer>();
@@ -0,0 +1,141 @@
+/*
+ * SampleCache.cpp - shares decoded samples between everything that loads them
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleCache.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "PathUtil.h"
+#include "SampleBuffer.h"
+
+namespace lmms {
+
+auto SampleCache::get(const QString& audioFile) -> std::shared_ptr<const SampleBuffer>
+{
+	const auto fileInfo = QFileInfo{PathUtil::toAbsolute(audioFile)};
+	if (!fileInfo.exists())
+	{
+		// Nothing to identify the content by, let the buffer report the error
+		return std::make_shared<const SampleBuffer>(audioFile);
+	}
+
+	const auto key = QString{"%1\n%2\n%3\n%4"}
+		.arg(fileInfo.canonicalFilePath())
+		.arg(fileInfo.lastModified().toMSecsSinceEpoch())
+		.arg(fileInfo.size())
+		.arg(Engine::audioEngine()->outputSampleRate());
+
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		if (const auto it = m_entries.find(key); it != m_entries.end())
+		{
+			it->second.lastUse = ++m_useCounter;
+			++m_stats.hits;
+			return it->second.buffer;
+		}
+		++m_stats.misses;
+	}
+
+	// Decode without holding the lock, so other files can be loaded meanwhile
+	auto buffer = std::make_shared<const SampleBuffer>(audioFile);
+	const auto bytes = buffer->size() * sizeof(SampleFrame);
+
+	const auto lock = std::lock_guard{m_mutex};
+	auto& entry = m_entries[key];
+	if (!entry.buffer)
+	{
+		// Another thread may have loaded the same file in the meantime, in which case its buffer is used
+		entry.buffer = std::move(buffer);
+		entry.bytes = bytes;
+	}
+	entry.lastUse = ++m_useCounter;
+
+	// Hold a reference while evicting, so the new entry counts as used
+	auto result = entry.buffer;
+	evict();
+	return result;
+}
+
+
+
+
+auto SampleCache::stats() const -> Stats
+{
+	const auto lock = std::lock_guard{m_mutex};
+	auto stats = m_stats;
+	stats.unusedBytes = unusedBytes();
+	return stats;
+}
+
+
+
+
+auto SampleCache::instance() -> SampleCache&
+{
+	static auto s_cache = SampleCache{};
+	return s_cache;
+}
+
+
+
+
+auto SampleCache::unusedBytes() const -> std::size_t
+{
+	auto bytes = std::size_t{0};
+	for (const auto& [key, entry] : m_entries)
+	{
+		if (entry.buffer.use_count() == 1) { bytes += entry.bytes; }
+	}
+	return bytes;
+}
+
+
+
+
+void SampleCache::evict()
+{
+	auto bytes = unusedBytes();
+	while (bytes > MemoryBudget)
+	{
+		auto leastRecent = m_entries.end();
+		for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+		{
+			if (it->second.buffer.use_count() != 1) { continue; }
+			if (leastRecent == m_entries.end() || it->second.lastUse < leastRecent->second.lastUse)
+			{
+				leastRecent = it;
+			}
+		}
+		if (leastRecent == m_entries.end()) { break; }
+
+		bytes -= leastRecent->second.bytes;
+		m_entries.erase(leastRecent);
+		++m_stats.evictions;
+	}
+}
+
+} // namespace lmms
@@ -26,6 +26,7 @@
 
 #include <QFile>
 #include <QString>
+#include <algorithm>
 #include <memory>
 #include <sndfile.h>
 
@@ -68,29 +69,39 @@ auto decodeSampleSF(const QString& audioFile) -> std::optional<SampleDecoder::Re
 	sndFile = sf_open_fd(file.handle(), SFM_READ, &sfInfo, false);
 	if (sf_error(sndFile) != 0) { return std::nullopt; }
 
-	auto buf = std::vector<sample_t>(sfInfo.channels * sfInfo.frames);
-	sf_read_float(sndFile, buf.data(), buf.size());
-
-	sf_close(sndFile);
-	file.close();
-
+	// Decode in chunks, so long files aren't held twice in memory
+	constexpr auto ChunkFrames = sf_count_t{65536};
+	auto buf = std::vector<sample_t>(sfInfo.channels * ChunkFrames);
 	auto result = std::vector<SampleFrame>(sfInfo.frames);
-	for (int i = 0; i < static_cast<int>(result.size()); ++i)
+
+	auto framesRead = sf_count_t{0};
+	while (framesRead < sfInfo.frames)
 	{
-		if (sfInfo.channels == 1)
-		{
-			// Upmix from mono to stereo
-			result[i] = {buf[i], buf[i]};
-		}
-		else if (sfInfo.channels > 1)
+		const auto chunk = sf_readf_float(sndFile, buf.data(), std::min(ChunkFrames, sfInfo.frames - framesRead));
+		if (chunk <= 0) { break; }
+
+		const auto frames = result.data() + framesRead;
+		for (auto i = sf_count_t{0}; i < chunk; ++i)
 		{
-			// TODO: Add support for higher number of channels (i.e., 5.1 channel systems)
-			// The current behavior assumes stereo in all cases excluding mono.
-			// This may not be the expected behavior, given some audio files with a higher number of channels.
-			result[i] = {buf[i * sfInfo.channels], buf[i * sfInfo.channels + 1]};
+			if (sfInfo.channels == 1)
+			{
+				// Upmix from mono to stereo
+				frames[i] = {buf[i], buf[i]};
+			}
+			else if (sfInfo.channels > 1)
+			{
+				// TODO: Add support for higher number of channels (i.e., 5.1 channel systems)
+				// The current behavior assumes stereo in all cases excluding mono.
+				// This may not be the expected behavior, given some audio files with a higher number of channels.
+				frames[i] = {buf[i * sfInfo.channels], buf[i * sfInfo.channels + 1]};
+			}
 		}
+		framesRead += chunk;
 	}
 
+	sf_close(sndFile);
+	file.close();
+
 	return SampleDecoder::Result{std::move(result), static_cast<int>(sfInfo.samplerate)};
 }
 
@@ -0,0 +1,523 @@
+/*
+ * SegmentRenderer.cpp - renders segments of the song in parallel processes
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SegmentRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <sndfile.h>
+
+#include "AudioFileDevice.h"
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "Song.h"
+#include "lmms_math.h"
+
+
+namespace lmms
+{
+
+namespace
+{
+
+// frames over which two segments are crossfaded
+constexpr f_cnt_t CrossfadeFrames = 512;
+// frames encoded at once
+constexpr f_cnt_t BlockFrames = 16384;
+
+static_assert(sizeof(SampleFrame) == DEFAULT_CHANNELS * sizeof(sample_t), "frames are read from files in place");
+
+//! Reads a rendered segment or the verification render
+class RenderedFile
+{
+public:
+	explicit RenderedFile(const QString& path) :
+		m_file(path)
+	{
+		// Use file handle to handle unicode file name on Windows
+		if (!m_file.open(QIODevice::ReadOnly)) { return; }
+		m_sndFile = sf_open_fd(m_file.handle(), SFM_READ, &m_info, false);
+	}
+
+	~RenderedFile()
+	{
+		if (m_sndFile) { sf_close(m_sndFile); }
+	}
+
+	bool isValid() const { return m_sndFile && m_info.channels == DEFAULT_CHANNELS; }
+
+	f_cnt_t frames() const { return static_cast<f_cnt_t>(m_info.frames); }
+
+	bool seek(f_cnt_t frame) { return sf_seek(m_sndFile, frame, SEEK_SET) == static_cast<sf_count_t>(frame); }
+
+	//! Reads up to @p frames frames and fills the rest with silence, returns the frames read
+	f_cnt_t read(SampleFrame* buffer, f_cnt_t frames)
+	{
+		const auto read = static_cast<f_cnt_t>(std::max<sf_count_t>(0, sf_readf_float(m_sndFile, buffer->data(), frames)));
+		zeroSampleFrames(buffer + read, frames - read);
+		return read;
+	}
+
+private:
+	QFile m_file;
+	SF_INFO m_info = {};
+	SNDFILE* m_sndFile = nullptr;
+};
+
+//! Compares the stitched segments with the verification render
+class Comparison
+{
+public:
+	explicit Comparison(const QString& path) :
+		m_reference(path),
+		m_buffer(BlockFrames)
+	{
+	}
+
+	bool isValid() const { return m_reference.isValid(); }
+
+	void compare(const SampleFrame* frames, f_cnt_t count)
+	{
+		const auto read = m_reference.read(m_buffer.data(), count);
+		for (f_cnt_t f = 0; f < count; ++f)
+		{
+			const auto deviation = std::max(std::abs(frames[f].left() - m_buffer[f].left()),
+				std::abs(frames[f].right() - m_buffer[f].right()));
+			if (deviation == 0.f && f < read) { continue; }
+
+			if (m_differing == 0) { m_firstDifference = m_compared + f; }
+			m_maxDeviation = std::max(m_maxDeviation, deviation);
+			++m_differing;
+		}
+		m_compared += count;
+	}
+
+	QString report(sample_rate_t sampleRate) const
+	{
+		const auto lengthDifference = static_cast<long long>(m_compared) - static_cast<long long>(m_reference.frames());
+		if (m_differing == 0 && lengthDifference == 0)
+		{
+			return QString("Segments are bit-exact with a normal render (%1 frames)").arg(m_compared);
+		}
+
+		return QString("Segments differ from a normal render in %1 of %2 frames, first at %3 s, "
+			"by up to %4 dBFS; the length differs by %5 frames")
+			.arg(m_differing)
+			.arg(m_compared)
+			.arg(static_cast<double>(m_firstDifference) / sampleRate, 0, 'f', 3)
+			.arg(safeAmpToDbfs(m_maxDeviation), 0, 'f', 1)
+			.arg(lengthDifference);
+	}
+
+private:
+	RenderedFile m_reference;
+	std::vector<SampleFrame> m_buffer;
+	f_cnt_t m_compared = 0;
+	f_cnt_t m_differing = 0;
+	f_cnt_t m_firstDifference = 0;
+	float m_maxDeviation = 0.f;
+};
+
+} // namespace
+
+
+
+
+SegmentRenderer::SegmentRenderer(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format,
+		const QString& outputPath) :
+	m_outputSettings(outputSettings),
+	m_format(format),
+	m_outputPath(outputPath)
+{
+}
+
+
+
+
+SegmentRenderer::~SegmentRenderer()
+{
+	abort();
+}
+
+
+
+
+bool SegmentRenderer::plan(int segments, int prerollBars)
+{
+	const auto song = Engine::getSong();
+	if (song->projectFileName().isEmpty())
+	{
+		qWarning("Only saved projects can be rendered in segments");
+		return false;
+	}
+	if (song->getLoopRenderCount() > 1)
+	{
+		qWarning("Songs with repeated loops can't be rendered in segments");
+		return false;
+	}
+	if (song->tempoModel().isAutomated())
+	{
+		qWarning("Songs with tempo automation can't be rendered in segments");
+		return false;
+	}
+
+	// same range as Song::startExport()
+	song->updateLength();
+	const auto& timeline = song->getTimeline(Song::PlayMode::Song);
+	TimePos end;
+	if (song->renderBetweenMarkers())
+	{
+		m_begin = timeline.loopBegin();
+		end = timeline.loopEnd();
+	}
+	else
+	{
+		m_begin = TimePos{0};
+		end = TimePos{song->length(), 0};
+		if (!song->exportLoop()) { end += TimePos{1, 0}; }
+	}
+
+	// every segment is at least a bar long, the last one gets what is left
+	const tick_t ticksPerBar = TimePos::ticksPerBar();
+	const int bars = (end.getTicks() - m_begin.getTicks()) / ticksPerBar;
+	const int count = std::min(segments, bars);
+	if (count < 2)
+	{
+		qWarning("The song is too short to be rendered in segments");
+		return false;
+	}
+
+	m_framesPerTick = Engine::framesPerTick(m_outputSettings.getSampleRate());
+	const auto crossfadeTicks = static_cast<tick_t>(std::ceil(CrossfadeFrames / m_framesPerTick)) + 1;
+	const auto preroll = std::max(0, prerollBars) * ticksPerBar;
+
+	m_segments.clear();
+	for (int i = 0; i < count; ++i)
+	{
+		const bool last = i + 1 == count;
+
+		Segment segment;
+		segment.begin = m_begin.getTicks() + bars * i / count * ticksPerBar;
+		segment.end = last ? end : TimePos{m_begin.getTicks() + bars * (i + 1) / count * ticksPerBar};
+		// nothing plays before the beginning of the export, so there is no point in rendering it
+		segment.renderBegin = std::max(m_begin.getTicks(), segment.begin.getTicks() - preroll);
+		segment.renderEnd = last ? end : TimePos{std::min(end.getTicks(), segment.end.getTicks() + crossfadeTicks)};
+		m_segments.push_back(segment);
+	}
+
+	return true;
+}
+
+
+
+
+void SegmentRenderer::start(bool verify)
+{
+	m_directory = std::make_unique<QTemporaryDir>();
+	if (!m_directory->isValid())
+	{
+		qWarning("Could not create a directory for the segments");
+		m_failed = true;
+		// let the caller connect to finished() first
+		QMetaObject::invokeMethod(this, [this] { finish(); }, Qt::QueuedConnection);
+		return;
+	}
+
+	for (std::size_t i = 0; i < m_segments.size(); ++i)
+	{
+		m_segments[i].file = m_directory->filePath(QString("segment_%1.wav").arg(i));
+	}
+
+	m_maxRunning = std::max(1, QThread::idealThreadCount());
+
+	if (verify)
+	{
+		auto outputSettings = m_outputSettings;
+		outputSettings.setBitDepth(OutputSettings::BitDepth::Depth32Bit);
+		m_verificationFile = m_directory->filePath("verification.wav");
+		m_verificationRenderer = std::make_unique<ProjectRenderer>(
+			outputSettings, ProjectRenderer::ExportFileFormat::Wave, m_verificationFile);
+
+		if (m_verificationRenderer->isReady())
+		{
+			connect(m_verificationRenderer.get(), SIGNAL(finished()), this, SLOT(verificationRendered()));
+			m_verificationDone = false;
+			// the normal render takes a core of its own
+			m_maxRunning = std::max<std::size_t>(1, m_maxRunning - 1);
+			m_verificationRenderer->startProcessing();
+		}
+		else
+		{
+			qWarning("Could not render the song normally, the segments won't be verified");
+			m_verificationRenderer.reset();
+		}
+	}
+
+	while (m_running < m_maxRunning && m_nextSegment < m_segments.size())
+	{
+		startNextSegment();
+	}
+}
+
+
+
+
+void SegmentRenderer::abort()
+{
+	for (auto& segment : m_segments)
+	{
+		if (!segment.process) { continue; }
+
+		segment.process->disconnect(this);
+		segment.process->kill();
+		segment.process->waitForFinished();
+		segment.process = nullptr;
+	}
+	m_nextSegment = m_segments.size();
+	m_running = 0;
+
+	if (m_verificationRenderer)
+	{
+		disconnect(m_verificationRenderer.get(), SIGNAL(finished()), this, SLOT(verificationRendered()));
+		m_verificationRenderer->abortProcessing();
+		m_verificationRenderer.reset();
+		m_verificationDone = true;
+	}
+}
+
+
+
+
+void SegmentRenderer::verificationRendered()
+{
+	m_verificationRenderer.reset();
+	m_verificationDone = true;
+
+	if (m_running == 0 && m_nextSegment == m_segments.size()) { finish(); }
+}
+
+
+
+
+void SegmentRenderer::startNextSegment()
+{
+	const auto index = m_nextSegment++;
+	auto& segment = m_segments[index];
+
+	QStringList arguments;
+	// children are only started by a process which already passed the root check
+	arguments << "--allowroot";
+	if (QFileInfo::exists(ConfigManager::inst()->rcFile()))
+	{
+		arguments << "--config" << ConfigManager::inst()->rcFile();
+	}
+	arguments << "render" << QFileInfo(Engine::getSong()->projectFileName()).absoluteFilePath()
+		<< "--segment" << QString("%1:%2").arg(segment.renderBegin.getTicks()).arg(segment.renderEnd.getTicks())
+		<< "--format" << "wav" << "--float"
+		<< "--samplerate" << QString::number(m_outputSettings.getSampleRate())
+		<< "--output" << segment.file;
+
+	const auto process = new QProcess(this);
+	process->setStandardOutputFile(QProcess::nullDevice());
+	process->setStandardErrorFile(QProcess::nullDevice());
+	connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished), this,
+		[this, index](int exitCode, QProcess::ExitStatus exitStatus) {
+			segmentRendered(index, exitCode, exitStatus);
+		});
+	connect(process, &QProcess::errorOccurred, this, [this, index](QProcess::ProcessError error) {
+		// a process which could not be started never finishes
+		if (error == QProcess::FailedToStart) { segmentRendered(index, EXIT_FAILURE, QProcess::CrashExit); }
+	});
+
+	segment.process = process;
+	++m_running;
+	process->start(QCoreApplication::applicationFilePath(), arguments);
+}
+
+
+
+
+void SegmentRenderer::segmentRendered(std::size_t index, int exitCode, QProcess::ExitStatus exitStatus)
+{
+	auto& segment = m_segments[index];
+	if (!segment.process) { return; }
+
+	segment.process->deleteLater();
+	segment.process = nullptr;
+	--m_running;
+
+	segment.done = exitStatus == QProcess::NormalExit && exitCode == EXIT_SUCCESS;
+	if (!segment.done && !m_failed)
+	{
+		qWarning("Rendering segment %zu failed", index + 1);
+		m_failed = true;
+		// the remaining segments are useless now
+		m_nextSegment = m_segments.size();
+		for (auto& other : m_segments)
+		{
+			if (other.process) { other.process->kill(); }
+		}
+		if (m_verificationRenderer)
+		{
+			disconnect(m_verificationRenderer.get(), SIGNAL(finished()), this, SLOT(verificationRendered()));
+			m_verificationRenderer->abortProcessing();
+			m_verificationRenderer.reset();
+			m_verificationDone = true;
+		}
+	}
+
+	const auto done = static_cast<std::size_t>(
+		std::count_if(m_segments.begin(), m_segments.end(), [](const Segment& s) { return s.done; }));
+	const auto progress = static_cast<int>(done * 100 / m_segments.size());
+	if (progress != m_progress)
+	{
+		m_progress = progress;
+		emit progressChanged(m_progress);
+	}
+
+	if (m_nextSegment < m_segments.size())
+	{
+		startNextSegment();
+	}
+	else if (m_running == 0 && m_verificationDone)
+	{
+		finish();
+	}
+}
+
+
+
+
+void SegmentRenderer::finish()
+{
+	if (!m_failed) { m_successful = stitch(); }
+
+	// removes the segments
+	m_directory.reset();
+
+	emit finished();
+}
+
+
+
+
+bool SegmentRenderer::stitch()
+{
+	const auto factory = ProjectRenderer::fileEncodeDevices[static_cast<std::size_t>(m_format)].m_getDevInst;
+	bool successful = false;
+	const auto output = std::unique_ptr<AudioFileDevice>{factory
+		? factory(m_outputPath, m_outputSettings, DEFAULT_CHANNELS, Engine::audioEngine(), successful)
+		: nullptr};
+	if (!successful)
+	{
+		qWarning("Could not write %s", qPrintable(m_outputPath));
+		return false;
+	}
+
+	std::unique_ptr<Comparison> comparison;
+	if (!m_verificationFile.isEmpty())
+	{
+		comparison = std::make_unique<Comparison>(m_verificationFile);
+		if (!comparison->isValid()) { comparison.reset(); }
+	}
+
+	const auto write = [&output, &comparison](const SampleFrame* frames, f_cnt_t count) {
+		output->writeFrames(frames, count);
+		if (comparison) { comparison->compare(frames, count); }
+	};
+
+	auto block = std::vector<SampleFrame>(BlockFrames);
+	auto tail = std::vector<SampleFrame>(CrossfadeFrames);
+
+	for (std::size_t i = 0; i < m_segments.size(); ++i)
+	{
+		const auto& segment = m_segments[i];
+		const bool last = i + 1 == m_segments.size();
+
+		RenderedFile file(segment.file);
+		if (!file.isValid() || !file.seek(frameOf(segment.begin) - frameOf(segment.renderBegin)))
+		{
+			qWarning("Segment %zu was not rendered", i + 1);
+			return false;
+		}
+
+		auto remaining = last
+			? std::numeric_limits<f_cnt_t>::max()
+			: frameOf(segment.end) - frameOf(segment.begin);
+
+		if (i > 0)
+		{
+			// the head of this segment overlaps the tail of the previous one
+			file.read(block.data(), CrossfadeFrames);
+			for (f_cnt_t f = 0; f < CrossfadeFrames; ++f)
+			{
+				const float position = (f + 0.5f) / CrossfadeFrames;
+				for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+				{
+					// written this way, equal frames stay exactly equal
+					block[f][ch] = tail[f][ch] + (block[f][ch] - tail[f][ch]) * position;
+				}
+			}
+			write(block.data(), CrossfadeFrames);
+			remaining -= CrossfadeFrames;
+		}
+
+		while (remaining > 0)
+		{
+			const auto read = file.read(block.data(), std::min(remaining, BlockFrames));
+			if (read == 0) { break; }
+
+			write(block.data(), read);
+			remaining -= read;
+		}
+
+		if (!last && (remaining > 0 || file.read(tail.data(), CrossfadeFrames) < CrossfadeFrames))
+		{
+			qWarning("Segment %zu is incomplete", i + 1);
+			return false;
+		}
+	}
+
+	if (comparison) { m_report = comparison->report(m_outputSettings.getSampleRate()); }
+
+	return true;
+}
+
+
+
+
+f_cnt_t SegmentRenderer::frameOf(const TimePos& time) const
+{
+	return static_cast<f_cnt_t>(std::lround(static_cast<double>(time.getTicks() - m_begin.getTicks()) * m_framesPerTick));
+}
+
+} // namespace lmms
@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "AutomationTrack.h"
 #include "AutomationEditor.h"
@@ -234,14 +235,19 @@ void Song::processNextBuffer()
 			return;
 	}
 
+	// The automation is rendered for the rest of the period at once, and again
+	// only if the playback position jumps or other clips take over
+	bool automationStale = true;
+
 	// If the playback position is outside of the range [begin, end), move it to
 	// begin and inform interested parties.
 	// Returns true if the playback position was moved, else false.
-	const auto enforceLoop = [this](const TimePos& begin, const TimePos& end)
+	const auto enforceLoop = [this, &automationStale](const TimePos& begin, const TimePos& end)
 	{
 		if (getPlayPos() < begin || getPlayPos() >= end)
 		{
 			setToTime(begin);
+			automationStale = true;
 			m_vstSyncController.setPlaybackJumped(true);
 			emit updateSampleTracks();
 			return true;
@@ -327,10 +333,16 @@ void Song::processNextBuffer()
 			m_vstSyncController.update();
 		}
 
+		if (automationStale || getPlayPos() >= m_automationValidUntil)
+		{
+			processAutomations(trackList, getPlayPos(), frameOffsetInPeriod, framesPerPeriod - frameOffsetInPeriod);
+			automationStale = false;
+		}
+
 		if (static_cast<f_cnt_t>(frameOffsetInTick) == 0)
 		{
-			// First frame of tick: process automation and play tracks
-			processAutomations(trackList, getPlayPos(), framesToPlay);
+			// First frame of tick: record automation and play tracks
+			processAutomationRecording(trackList, getPlayPos());
 			processMetronome(frameOffsetInPeriod);
 
 			for (const auto track : trackList)
@@ -350,44 +362,43 @@ void Song::processNextBuffer()
 }
 
 
-void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp_t)
+TrackContainer* Song::automationContainer(const TrackList& tracklist, int& clipNum)
 {
-	AutomatedValueMap values;
-
-	QSet<const AutomatableModel*> recordedModels;
-
-	TrackContainer* container = this;
-	int clipNum = -1;
+	clipNum = -1;
 
 	switch (m_playMode)
 	{
 	case PlayMode::Song:
-		break;
+		return this;
 	case PlayMode::Pattern:
 	{
-		if (tracklist.empty()) { return; }
+		if (tracklist.empty()) { return nullptr; }
 		Q_ASSERT(tracklist.at(0)->type() == Track::Type::Pattern);
 		auto patternTrack = dynamic_cast<PatternTrack*>(tracklist.at(0));
-		container = Engine::patternStore();
 		clipNum = patternTrack->patternIndex();
+		return Engine::patternStore();
 	}
-		break;
 	default:
-		return;
+		return nullptr;
 	}
+}
+
+void Song::processAutomationRecording(const TrackList& tracklist, TimePos timeStart)
+{
+	m_recordedModels.clear();
 
-	values = container->automatedValuesAt(timeStart, clipNum);
-	const TrackList& tracks = container->tracks();
+	int clipNum;
+	TrackContainer* container = automationContainer(tracklist, clipNum);
+	if (!container) { return; }
 
 	Track::clipVector clips;
-	for (Track* track : tracks)
+	for (Track* track : container->tracks())
 	{
 		if (track->type() == Track::Type::Automation) {
 			track->getClipsInRange(clips, 0, timeStart);
 		}
 	}
 
-	// Process recording
 	for (Clip* clip : clips)
 	{
 		auto p = dynamic_cast<AutomationClip *>(clip);
@@ -404,33 +415,60 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp
 			// and store that so that when playing it back, it scales the value correctly.
 			p->recordValue(relTime, recordedModel->inverseScaledValue(recordedModel->value<float>()));
 
-			recordedModels << recordedModel;
+			m_recordedModels << recordedModel;
 		}
 	}
+}
+
+void Song::processAutomations(const TrackList& tracklist, const PlayPos& timeStart, f_cnt_t frameOffset, f_cnt_t frames)
+{
+	m_automationValidUntil = TimePos{std::numeric_limits<tick_t>::max()};
+
+	int clipNum;
+	TrackContainer* container = automationContainer(tracklist, clipNum);
+	if (!container) { return; }
+
+	const auto sources = container->automationSourcesAt(timeStart, clipNum, &m_automationValidUntil);
 
 	// Checks if an automated model stopped being automated by automation clip
 	// so we can move the control back to any connected controller again
 	for (auto it = m_oldAutomatedValues.begin(); it != m_oldAutomatedValues.end(); it++)
 	{
 		AutomatableModel * am = it.key();
-		if (am->controllerConnection() && !values.contains(am))
+		if (am->controllerConnection() && !sources.contains(am))
 		{
 			am->setUseControllerValue(true);
 		}
 	}
-	m_oldAutomatedValues = values;
+	m_oldAutomatedValues.clear();
 
-	// Apply values
-	for (auto it = values.begin(); it != values.end(); it++)
+	// Render the values for every frame left in this period
+	const double framesPerTick = Engine::framesPerTick();
+	const double start = timeStart.getTicks() + timeStart.currentFrame() / framesPerTick;
+	m_automationBuffer.resize(frames);
+	float* values = m_automationBuffer.data();
+	for (auto it = sources.begin(); it != sources.end(); it++)
 	{
-		if (! recordedModels.contains(it.key()))
+		AutomatableModel* model = it.key();
+		if (m_recordedModels.contains(model))
 		{
-			it.key()->setAutomatedValue(it.value());
+			if (!model->useControllerValue()) { model->setUseControllerValue(true); }
+			continue;
 		}
-		else if (!it.key()->useControllerValue())
+
+		const AutomationSource& source = it.value();
+		const double clipStart = start - source.shift;
+		// frames until the clip time reaches the limit, the value stays there
+		const auto unclamped = static_cast<f_cnt_t>(std::clamp(
+			std::ceil((source.limit - clipStart) * framesPerTick), 0.0, static_cast<double>(frames)));
+		source.clip->valuesAt(clipStart, 1.0 / framesPerTick, values, unclamped);
+		if (unclamped < frames)
 		{
-			it.key()->setUseControllerValue(true);
+			std::fill(values + unclamped, values + frames, source.clip->valueAt(source.limit));
 		}
+
+		model->setAutomatedValues(values, frameOffset, frames);
+		m_oldAutomatedValues[model] = values[frames - 1];
 	}
 }
 
@@ -849,11 +887,11 @@ bpm_t Song::getTempo()
 }
 
 
-AutomatedValueMap Song::automatedValuesAt(TimePos time, int clipNum) const
+AutomationSourceMap Song::automationSourcesAt(TimePos time, int clipNum, TimePos* validUntil) const
 {
 	auto trackList = TrackList{m_globalAutomationTrack};
 	trackList.insert(trackList.end(), tracks().begin(), tracks().end());
-	return TrackContainer::automatedValuesFromTracks(trackList, time, clipNum);
+	return TrackContainer::automationSourcesFromTracks(trackList, time, clipNum, validUntil);
 }
 
 
@@ -0,0 +1,203 @@
+/*
+ * StemExporter.cpp - writes many tracks and mixer channels during one render
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "StemExporter.h"
+
+#include <QFile>
+#include <QStringList>
+
+#include "AudioBusHandle.h"
+#include "AudioEngine.h"
+#include "AudioFileDevice.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "Mixer.h"
+#include "SampleTrack.h"
+
+
+namespace lmms
+{
+
+StemExporter::StemExporter(const OutputSettings& outputSettings, ProjectRenderer::ExportFileFormat format) :
+	m_outputSettings(outputSettings),
+	m_format(format)
+{
+}
+
+
+
+
+StemExporter::~StemExporter()
+{
+	detach();
+}
+
+
+
+
+bool StemExporter::addTrack(Track* track, const QString& file)
+{
+	AudioBusHandle* busHandle = nullptr;
+	if (const auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track))
+	{
+		busHandle = instrumentTrack->audioBusHandle();
+	}
+	else if (const auto sampleTrack = dynamic_cast<SampleTrack*>(track))
+	{
+		busHandle = sampleTrack->audioBusHandle();
+	}
+	if (!busHandle) { return false; }
+
+	const auto stem = addStem(file);
+	if (!stem) { return false; }
+
+	stem->busHandle = busHandle;
+	return true;
+}
+
+
+
+
+bool StemExporter::addMixerChannel(MixerChannel* channel, const QString& file)
+{
+	const auto stem = addStem(file);
+	if (!stem) { return false; }
+
+	stem->channel = channel;
+	return true;
+}
+
+
+
+
+StemExporter::Stem* StemExporter::addStem(const QString& file)
+{
+	const auto factory = ProjectRenderer::fileEncodeDevices[static_cast<std::size_t>(m_format)].m_getDevInst;
+	if (!factory) { return nullptr; }
+
+	bool successful = false;
+	auto device = std::unique_ptr<AudioFileDevice>{
+		factory(file, m_outputSettings, DEFAULT_CHANNELS, Engine::audioEngine(), successful)};
+	if (!successful)
+	{
+		qWarning("Could not export stem %s", qPrintable(file));
+		return nullptr;
+	}
+
+	auto stem = std::make_unique<Stem>(Engine::audioEngine()->framesPerPeriod());
+	stem->device = std::move(device);
+
+	m_stems.push_back(std::move(stem));
+	return m_stems.back().get();
+}
+
+
+
+
+void StemExporter::attach()
+{
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
+	for (const auto& stem : m_stems)
+	{
+		if (stem->busHandle) { stem->busHandle->setTap(&stem->tap); }
+		if (stem->channel) { stem->channel->m_tap = &stem->tap; }
+	}
+	m_attached = true;
+}
+
+
+
+
+void StemExporter::detach()
+{
+	if (!m_attached) { return; }
+
+	const auto guard = Engine::audioEngine()->requestChangesGuard();
+	for (const auto& stem : m_stems)
+	{
+		if (stem->busHandle) { stem->busHandle->setTap(nullptr); }
+		if (stem->channel) { stem->channel->m_tap = nullptr; }
+	}
+	m_attached = false;
+}
+
+
+
+
+void StemExporter::finish()
+{
+	detach();
+
+	for (const auto& stem : m_stems)
+	{
+		// encodes what is left and closes the file
+		stem->device.reset();
+	}
+}
+
+
+
+
+void StemExporter::abort()
+{
+	detach();
+
+	QStringList files;
+	for (const auto& stem : m_stems)
+	{
+		if (!stem->device) { continue; }
+
+		files << stem->device->outputFile();
+		stem->device.reset();
+	}
+	for (const auto& file : files)
+	{
+		QFile::remove(file);
+	}
+}
+
+
+
+
+void StemExporter::capture()
+{
+	for (const auto& stem : m_stems)
+	{
+		if (!stem->device) { continue; }
+		stem->device->writeFrames(stem->tap.takePeriod(), stem->tap.framesPerPeriod());
+	}
+}
+
+
+
+
+void StemExporter::skip()
+{
+	for (const auto& stem : m_stems)
+	{
+		stem->tap.takePeriod();
+	}
+}
+
+} // namespace lmms
@@ -0,0 +1,407 @@
+/*
+ * TraceRecorder.cpp - per-thread lock-free trace of the audio threads
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "TraceRecorder.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+
+namespace lmms
+{
+
+std::atomic_int TraceRecorder::s_mode = 0;
+
+namespace
+{
+
+using Event = TraceRecorder::Event;
+using Category = TraceRecorder::Category;
+
+constexpr int MaxThreads = 32;
+constexpr std::size_t RingSize = 8192;
+// the writer wakes up this often, the rings must hold the events of that time
+constexpr auto DrainInterval = std::chrono::milliseconds{20};
+
+constexpr auto CategoryNames = std::array{
+	"period", "stage", "playhandle", "audiobushandle", "mixerchannel", "effect"
+};
+static_assert(CategoryNames.size() == static_cast<std::size_t>(Category::Count));
+
+
+//! Written by one thread, read by the writer
+struct Ring
+{
+	std::unique_ptr<Event[]> events = std::make_unique<Event[]>(RingSize);
+	std::atomic_size_t written = 0;
+	std::atomic_size_t read = 0;
+	std::atomic_size_t dropped = 0;
+	std::atomic<std::uint32_t> threadName = TraceRecorder::Unnamed;
+
+	void push(const Event& event)
+	{
+		const auto w = written.load(std::memory_order_relaxed);
+		if (w - read.load(std::memory_order_acquire) >= RingSize)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		events[w % RingSize] = event;
+		written.store(w + 1, std::memory_order_release);
+	}
+};
+
+// rings are allocated by the first start() and never freed, the
+// thread_local indices below stay valid across restarts
+std::array<std::atomic<Ring*>, MaxThreads> s_rings{};
+// a thread claims the first free ring when it records its first event
+std::array<std::atomic_bool, MaxThreads> s_ringClaimed{};
+// threads which found all rings claimed, reported by stop()
+std::atomic_int s_threadsWithoutRing = 0;
+
+//! The ring of the thread, given back when the thread exits
+struct RingClaim
+{
+	int index = -1;
+	bool counted = false;
+
+	~RingClaim()
+	{
+		if (index < 0) { return; }
+		// what is left in the ring is still drained
+		if (auto ring = s_rings[index].load(std::memory_order_acquire))
+		{
+			ring->threadName.store(TraceRecorder::Unnamed, std::memory_order_relaxed);
+		}
+		s_ringClaimed[index].store(false, std::memory_order_release);
+	}
+
+	bool claim()
+	{
+		for (int i = 0; i < MaxThreads; ++i)
+		{
+			if (!s_ringClaimed[i].load(std::memory_order_relaxed)
+				&& !s_ringClaimed[i].exchange(true, std::memory_order_acq_rel))
+			{
+				index = i;
+				return true;
+			}
+		}
+		if (!counted)
+		{
+			s_threadsWithoutRing.fetch_add(1, std::memory_order_relaxed);
+			counted = true;
+		}
+		return false;
+	}
+};
+
+thread_local RingClaim t_ring;
+thread_local std::uint32_t t_threadName = TraceRecorder::Unnamed;
+
+// serializes interning, never locked by the audio threads
+std::mutex s_namesMutex;
+QHash<QString, std::uint32_t> s_nameIds;
+QStringList s_names{QString{}};
+
+QString nameOf(std::uint32_t id)
+{
+	const auto lock = std::lock_guard{s_namesMutex};
+	return id < static_cast<std::uint32_t>(s_names.size()) ? s_names[id] : QString{};
+}
+
+
+
+
+//! Drains the rings into the files
+class Writer
+{
+public:
+	~Writer()
+	{
+		stop();
+	}
+
+	bool start(const QString& traceFile, const QString& periodLogFile)
+	{
+		stop();
+
+		if (!traceFile.isEmpty())
+		{
+			m_traceFile.setFileName(traceFile);
+			if (!m_traceFile.open(QFile::WriteOnly | QFile::Truncate))
+			{
+				qWarning() << "Could not open trace file" << traceFile;
+				return false;
+			}
+			m_traceFile.write("[\n");
+			m_wroteEvent = false;
+			writeJson({
+				{"name", "process_name"}, {"ph", "M"}, {"pid", 1},
+				{"args", QJsonObject{{"name", "LMMS"}}}
+			});
+		}
+
+		if (!periodLogFile.isEmpty())
+		{
+			m_periodLogFile.setFileName(periodLogFile);
+			if (!m_periodLogFile.open(QFile::WriteOnly | QFile::Truncate))
+			{
+				qWarning() << "Could not open profiler output file" << periodLogFile;
+			}
+		}
+
+		// forget about what was recorded while nothing was written
+		for (auto& ring : s_rings)
+		{
+			if (auto r = ring.load(std::memory_order_acquire))
+			{
+				r->read.store(r->written.load(std::memory_order_acquire), std::memory_order_release);
+				r->dropped = 0;
+			}
+		}
+		m_threadNames.fill(TraceRecorder::Unnamed - 1);
+		s_threadsWithoutRing = 0;
+		m_startTime = TraceRecorder::now();
+
+		m_quit = false;
+		m_thread = std::thread{[this] { run(); }};
+		return true;
+	}
+
+	void stop()
+	{
+		if (!m_thread.joinable()) { return; }
+
+		m_quit = true;
+		m_thread.join();
+
+		std::size_t dropped = 0;
+		for (auto& ring : s_rings)
+		{
+			if (auto r = ring.load(std::memory_order_acquire)) { dropped += r->dropped; }
+		}
+		if (dropped > 0)
+		{
+			qWarning() << "Trace rings overflowed," << dropped << "events were dropped";
+		}
+		if (const auto threads = s_threadsWithoutRing.load(); threads > 0)
+		{
+			qWarning() << "More than" << MaxThreads << "threads recorded at once, the events of"
+				<< threads << "threads were dropped";
+		}
+
+		if (m_traceFile.isOpen())
+		{
+			m_traceFile.write("\n]\n");
+			m_traceFile.close();
+		}
+		m_periodLogFile.close();
+	}
+
+private:
+	void run()
+	{
+		while (!m_quit)
+		{
+			std::this_thread::sleep_for(DrainInterval);
+			drain();
+		}
+		// everything that was recorded before stop() set the mode to 0
+		drain();
+	}
+
+	void drain()
+	{
+		for (int i = 0; i < MaxThreads; ++i)
+		{
+			auto ring = s_rings[i].load(std::memory_order_acquire);
+			if (!ring) { continue; }
+
+			const auto threadName = ring->threadName.load(std::memory_order_relaxed);
+			if (m_traceFile.isOpen() && threadName != m_threadNames[i])
+			{
+				m_threadNames[i] = threadName;
+				const auto name = threadName != TraceRecorder::Unnamed
+					? nameOf(threadName) : QString{"Thread %1"}.arg(i);
+				writeJson({
+					{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", i},
+					{"args", QJsonObject{{"name", name}}}
+				});
+			}
+
+			const auto r = ring->read.load(std::memory_order_relaxed);
+			const auto w = ring->written.load(std::memory_order_acquire);
+			for (auto n = r; n != w; ++n)
+			{
+				write(ring->events[n % RingSize], i);
+			}
+			ring->read.store(w, std::memory_order_release);
+		}
+
+		m_traceFile.flush();
+		m_periodLogFile.flush();
+	}
+
+	void write(const Event& event, int thread)
+	{
+		if (event.category == Category::Period && m_periodLogFile.isOpen())
+		{
+			m_periodLogFile.write(QByteArray::number((event.end - event.begin) / 1000) + '\n');
+		}
+
+		if (!m_traceFile.isOpen()) { return; }
+
+		// events from before start() might still be in flight
+		if (event.begin < m_startTime) { return; }
+
+		const auto category = CategoryNames[static_cast<std::size_t>(event.category)];
+		const auto name = event.name != TraceRecorder::Unnamed ? nameOf(event.name) : QString{category};
+
+		QJsonObject json{
+			{"name", name},
+			{"cat", category},
+			{"ph", "X"},
+			{"pid", 1},
+			{"tid", thread},
+			{"ts", (event.begin - m_startTime) / 1000.},
+			{"dur", (event.end - event.begin) / 1000.}
+		};
+		if (event.queued != 0 && event.queued <= event.begin)
+		{
+			json["args"] = QJsonObject{{"queueUs", (event.begin - event.queued) / 1000.}};
+		}
+		writeJson(json);
+	}
+
+	void writeJson(const QJsonObject& json)
+	{
+		if (m_wroteEvent) { m_traceFile.write(",\n"); }
+		m_traceFile.write(QJsonDocument{json}.toJson(QJsonDocument::Compact));
+		m_wroteEvent = true;
+	}
+
+	std::thread m_thread;
+	std::atomic_bool m_quit = false;
+	QFile m_traceFile;
+	QFile m_periodLogFile;
+	bool m_wroteEvent = false;
+	std::uint64_t m_startTime = 0;
+	// last thread name written for each ring
+	std::array<std::uint32_t, MaxThreads> m_threadNames{};
+};
+
+Writer s_writer;
+
+} // namespace
+
+
+
+
+bool TraceRecorder::start(const QString& traceFile, const QString& periodLogFile)
+{
+	stop();
+
+	if (traceFile.isEmpty() && periodLogFile.isEmpty()) { return true; }
+
+	for (auto& ring : s_rings)
+	{
+		if (!ring.load(std::memory_order_relaxed)) { ring.store(new Ring, std::memory_order_release); }
+	}
+
+	if (!s_writer.start(traceFile, periodLogFile)) { return false; }
+
+	s_mode = (traceFile.isEmpty() ? 0 : TraceMode) | (periodLogFile.isEmpty() ? 0 : PeriodLogMode);
+	return true;
+}
+
+
+
+
+void TraceRecorder::stop()
+{
+	s_mode = 0;
+	s_writer.stop();
+}
+
+
+
+
+std::uint32_t TraceRecorder::intern(const QString& name)
+{
+	const auto lock = std::lock_guard{s_namesMutex};
+
+	const auto it = s_nameIds.constFind(name);
+	if (it != s_nameIds.constEnd()) { return it.value(); }
+
+	const auto id = static_cast<std::uint32_t>(s_names.size());
+	s_names.append(name);
+	s_nameIds.insert(name, id);
+	return id;
+}
+
+
+
+
+void TraceRecorder::setThreadName(const QString& name)
+{
+	t_threadName = intern(name);
+	if (t_ring.index >= 0)
+	{
+		if (auto ring = s_rings[t_ring.index].load(std::memory_order_acquire))
+		{
+			ring->threadName = t_threadName;
+		}
+	}
+}
+
+
+
+
+void TraceRecorder::record(const Event& event)
+{
+	if (t_ring.index < 0 && !t_ring.claim()) { return; }
+
+	auto ring = s_rings[t_ring.index].load(std::memory_order_acquire);
+	if (!ring) { return; }
+
+	// the name may have been set before the thread had a ring
+	if (ring->threadName.load(std::memory_order_relaxed) != t_threadName)
+	{
+		ring->threadName.store(t_threadName, std::memory_order_relaxed);
+	}
+	ring->push(event);
+}
+
+} // namespace lmms
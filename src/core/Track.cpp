@@ -29,6 +29,8 @@
 
 #include "Track.h"
 
+#include <thread>
+
 #include <QDomElement>
 #include <QVariant>
 
@@ -63,7 +65,10 @@ Track::Track( Type type, TrackContainer * tc ) :
 	m_name(),                       /*!< The track's name */
 	m_mutedModel( false, this, tr( "Mute" ) ), /*!< For controlling track muting */
 	m_soloModel( false, this, tr( "Solo" ) ), /*!< For controlling track soloing */
-	m_clips()        /*!< The clips (segments) */
+	m_clips(),       /*!< The clips (segments) */
+	m_clipIndexReaders{},
+	m_currentClipIndex(0),
+	m_clipIndexBatch(0)
 {	
 	m_trackContainer->addTrack( this );
 	m_height = -1;
@@ -81,10 +86,7 @@ Track::~Track()
 	lock();
 	emit destroyedTrack();
 
-	while (!m_clips.empty())
-	{
-		delete m_clips.back();
-	}
+	deleteClips();
 
 	m_trackContainer->removeTrack( this );
 	unlock();
@@ -281,6 +283,8 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		deleteClips();
 	}
 
+	// the clips are indexed once all of them are loaded
+	++m_clipIndexBatch;
 	QDomNode node = element.firstChild();
 	while( !node.isNull() )
 	{
@@ -301,6 +305,8 @@ void Track::loadTrack(const QDomElement& element, bool presetMode)
 		}
 		node = node.nextSibling();
 	}
+	--m_clipIndexBatch;
+	rebuildClipIndex();
 
 	int storedHeight = element.attribute( "trackheight" ).toInt();
 	if( storedHeight >= MINIMAL_TRACK_HEIGHT )
@@ -340,7 +346,11 @@ void Track::loadSettings(const QDomElement& element)
  */
 Clip * Track::addClip( Clip * clip )
 {
-	m_clips.push_back( clip );
+	m_clips.push_back(clip);
+	rebuildClipIndex();
+
+	connect(clip, &Clip::positionChanged, this, &Track::rebuildClipIndex, Qt::DirectConnection);
+	connect(clip, &Clip::lengthChanged, this, &Track::rebuildClipIndex, Qt::DirectConnection);
 
 	emit clipAdded( clip );
 
@@ -359,7 +369,13 @@ void Track::removeClip( Clip * clip )
 	clipVector::iterator it = std::find( m_clips.begin(), m_clips.end(), clip );
 	if( it != m_clips.end() )
 	{
-		m_clips.erase( it );
+		m_clips.erase(it);
+		// returns once no lookup can still return the clip, clips added in bulk aren't indexed yet
+		if (m_clipIndexBatch == 0 || m_clipIndices[m_currentClipIndex].contains(clip))
+		{
+			publishClipIndex(m_clips);
+		}
+		disconnect(clip, nullptr, this, nullptr);
 		if( Engine::getSong() )
 		{
 			Engine::getSong()->updateLength();
@@ -372,10 +388,14 @@ void Track::removeClip( Clip * clip )
 /*! \brief Remove all Clips from this track */
 void Track::deleteClips()
 {
+	// take all clips out of the index at once instead of rebuilding it after each of them
+	++m_clipIndexBatch;
+	publishClipIndex({});
 	while (!m_clips.empty())
 	{
 		delete m_clips.front();
 	}
+	--m_clipIndexBatch;
 }
 
 
@@ -456,17 +476,81 @@ int Track::getClipNum( const Clip * clip )
 void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
 							const TimePos & end )
 {
-	for( Clip* clip : m_clips )
+	// announce the lookup on the current index, and make sure it wasn't replaced in the meantime, so
+	// publishClipIndex() doesn't rebuild it under us
+	int current = m_currentClipIndex.load();
+	while (true)
+	{
+		++m_clipIndexReaders[current];
+		const int check = m_currentClipIndex.load();
+		if (check == current) { break; }
+		--m_clipIndexReaders[current];
+		current = check;
+	}
+
+	// the index returns the clips sorted by position already
+	const bool append = clipV.empty();
+	m_clipIndices[current].forEachOverlapping(start, end, [&](Clip* clip)
 	{
-		int s = clip->startPosition();
-		int e = clip->endPosition();
-		if( ( s <= end ) && ( e >= start ) )
+		if (append)
+		{
+			clipV.push_back(clip);
+		}
+		else
 		{
-			// Clip is within given range
 			// Insert sorted by Clip's position
 			clipV.insert(std::upper_bound(clipV.begin(), clipV.end(), clip, Clip::comparePosition),
 						clip);
 		}
+	});
+
+	--m_clipIndexReaders[current];
+}
+
+
+
+
+/*! \brief Rebuild the index used by getClipsInRange() from m_clips
+ *
+ *  Called from the model side whenever a clip was added, removed, moved or
+ *  resized, unless clips are being added in bulk.
+ */
+void Track::rebuildClipIndex()
+{
+	if (m_clipIndexBatch > 0) { return; }
+	publishClipIndex(m_clips);
+}
+
+
+
+
+/*! \brief Make getClipsInRange() find the given clips
+ *
+ *  The index which isn't read by the lookups is rebuilt and swapped in, so
+ *  lookups from the audio thread neither allocate nor block. The previous
+ *  index only gets new readers that immediately step back, so waiting for it
+ *  takes as long as the lookups still running on it. Afterwards none of them
+ *  can return a clip that is missing from \p clips.
+ */
+void Track::publishClipIndex(const clipVector& clips)
+{
+	QMutexLocker m(&m_clipIndexMutex);
+
+	auto intervals = std::vector<IntervalIndex<Clip*>::Interval>{};
+	intervals.reserve(clips.size());
+	for (Clip* clip : clips)
+	{
+		intervals.push_back({clip->startPosition(), clip->endPosition(), clip});
+	}
+
+	const int previous = m_currentClipIndex.load();
+	const int next = 1 - previous;
+	m_clipIndices[next].rebuild(std::move(intervals));
+	m_currentClipIndex.store(next);
+
+	while (m_clipIndexReaders[previous].load() > 0)
+	{
+		std::this_thread::yield();
 	}
 }
 
@@ -483,7 +567,8 @@ void Track::getClipsInRange( clipVector & clipV, const TimePos & start,
  */
 void Track::swapPositionOfClips( int clipNum1, int clipNum2 )
 {
-	qSwap( m_clips[clipNum1], m_clips[clipNum2] );
+	qSwap(m_clips[clipNum1], m_clips[clipNum2]);
+	rebuildClipIndex();
 
 	const TimePos pos = m_clips[clipNum1]->startPosition();
 
@@ -252,11 +252,26 @@ bool TrackContainer::isEmpty() const
 
 AutomatedValueMap TrackContainer::automatedValuesAt(TimePos time, int clipNum) const
 {
-	return automatedValuesFromTracks(tracks(), time, clipNum);
+	AutomatedValueMap valueMap;
+
+	const auto sources = automationSourcesAt(time, clipNum);
+	for (auto it = sources.begin(); it != sources.end(); ++it)
+	{
+		valueMap[it.key()] = it->clip->valueAt(std::min(time - it->shift, it->limit));
+	}
+
+	return valueMap;
 }
 
 
-AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tracks, TimePos time, int clipNum)
+AutomationSourceMap TrackContainer::automationSourcesAt(TimePos time, int clipNum, TimePos* validUntil) const
+{
+	return automationSourcesFromTracks(tracks(), time, clipNum, validUntil);
+}
+
+
+AutomationSourceMap TrackContainer::automationSourcesFromTracks(const TrackList& tracks, TimePos time,
+	int clipNum, TimePos* validUntil)
 {
 	Track::clipVector clips;
 
@@ -273,6 +288,18 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 		case Track::Type::Pattern:
 			if (clipNum < 0) {
 				track->getClipsInRange(clips, 0, time);
+
+				// a clip starting later takes over its models
+				if (validUntil)
+				{
+					for (const Clip* clip : track->getClips())
+					{
+						if (clip->startPosition() > time && clip->startPosition() < *validUntil)
+						{
+							*validUntil = clip->startPosition();
+						}
+					}
+				}
 			} else {
 				Q_ASSERT(track->numOfClips() > clipNum);
 				clips.push_back(track->getClip(clipNum));
@@ -282,7 +309,7 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 		}
 	}
 
-	AutomatedValueMap valueMap;
+	AutomationSourceMap sources;
 
 	Q_ASSERT(std::is_sorted(clips.begin(), clips.end(), Clip::comparePosition));
 
@@ -297,31 +324,51 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 			if (! p->hasAutomation()) {
 				continue;
 			}
-			TimePos relTime = time - p->startPosition() - p->startTimeOffset();
+			auto source = AutomationSource{p, p->startPosition() + p->startTimeOffset()};
 			if (!p->isInPattern()) {
-				relTime = std::min(static_cast<int>(relTime), p->length() - p->startTimeOffset());
+				source.limit = p->length() - p->startTimeOffset();
 			}
-			float value = p->valueAt(relTime);
 
 			for (AutomatableModel* model : p->objects())
 			{
-				valueMap[model] = value;
+				sources[model] = source;
 			}
 		}
 		else if (auto* pattern = dynamic_cast<PatternClip*>(clip))
 		{
 			auto patIndex = dynamic_cast<class PatternTrack*>(pattern->getTrack())->patternIndex();
 			auto patStore = Engine::patternStore();
+			const tick_t patLength = patStore->lengthOfPattern(patIndex) * TimePos::ticksPerBar();
 
 			TimePos patTime = time - clip->startPosition();
+			const bool ended = patTime >= clip->length();
 			patTime = std::min(patTime, clip->length());
-			patTime = patTime % (patStore->lengthOfPattern(patIndex) * TimePos::ticksPerBar());
+			patTime = patTime % patLength;
+
+			// time at which the current repetition of the pattern started
+			const tick_t patStart = time - patTime;
+			if (validUntil && !ended)
+			{
+				*validUntil = std::min(*validUntil, TimePos{std::min(patStart + patLength, clip->endPosition().getTicks())});
+			}
 
-			auto patValues = patStore->automatedValuesAt(patTime, patIndex);
-			for (auto it=patValues.begin(); it != patValues.end(); it++)
+			auto patSources = patStore->automationSourcesAt(patTime, patIndex);
+			for (auto it=patSources.begin(); it != patSources.end(); it++)
 			{
+				auto source = it.value();
+				if (ended)
+				{
+					// the pattern stays at patTime, so the clip time must not advance either
+					const tick_t clipTime = std::min(patTime - source.shift, source.limit);
+					source.shift = time - clipTime;
+					source.limit = clipTime;
+				}
+				else
+				{
+					source.shift += patStart;
+				}
 				// override old values, pattern track with the highest index takes precedence
-				valueMap[it.key()] = it.value();
+				sources[it.key()] = source;
 			}
 		}
 		else
@@ -330,7 +377,7 @@ AutomatedValueMap TrackContainer::automatedValuesFromTracks(const TrackList &tra
 		}
 	}
 
-	return valueMap;
+	return sources;
 };
 
 
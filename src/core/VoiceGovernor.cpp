@@ -0,0 +1,245 @@
+/*
+ * VoiceGovernor.cpp - sheds voices when the audio engine runs out of time
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "VoiceGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AudioEngine.h"
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "NotePlayHandle.h"
+#include "Song.h"
+
+
+namespace lmms
+{
+
+namespace
+{
+
+// less headroom than this counts as overload
+constexpr float OverloadedLoad = 0.9f;
+// shedding aims for this load
+constexpr float TargetLoad = 0.8f;
+// reduced quality is left below this load
+constexpr float RecoveredLoad = 0.6f;
+// sustained notes are only stolen after this many overloaded periods in a row
+constexpr int StealAfterPeriods = 4;
+// faded voices still cost time until they are done, don't count them twice
+constexpr int CooldownPeriods = 2;
+// at most this part of all voices is faded out at once
+constexpr float MaxShedRatio = 0.25f;
+
+} // namespace
+
+
+
+
+VoiceGovernor::VoiceGovernor() :
+	m_policy(policyFromName(ConfigManager::inst()->value("audioengine", "voiceshedding"))),
+	m_reducedQualityAllowed(ConfigManager::inst()->value("audioengine", "voicesheddingquality", "1").toInt())
+{
+	// every note handle can be a candidate
+	m_candidates.reserve(NotePlayHandleManager::MaxHandles);
+}
+
+
+
+
+QString VoiceGovernor::policyName(Policy policy)
+{
+	switch (policy)
+	{
+		case Policy::Off: return "off";
+		case Policy::DropNew: return "dropnew";
+		case Policy::StealVoices: return "steal";
+		case Policy::FadeReleasing: break;
+	}
+	return "fade";
+}
+
+
+
+
+VoiceGovernor::Policy VoiceGovernor::policyFromName(const QString& name)
+{
+	if (name == "off") { return Policy::Off; }
+	if (name == "dropnew") { return Policy::DropNew; }
+	if (name == "steal") { return Policy::StealVoices; }
+	return Policy::FadeReleasing;
+}
+
+
+
+
+bool VoiceGovernor::admit(const PlayHandle* handle)
+{
+	// Instrument play handles are not added during playback, but when the
+	// associated instrument is created, so add those unconditionally.
+	if (handle->type() == PlayHandle::Type::InstrumentPlayHandle) { return true; }
+
+	bool admitted = true;
+	switch (policy())
+	{
+		case Policy::Off:
+		case Policy::StealVoices:
+			break;
+		case Policy::DropNew:
+			admitted = !Engine::audioEngine()->criticalXRuns();
+			break;
+		case Policy::FadeReleasing:
+			// new notes are more important than releasing ones, only
+			// drop them once there is nothing left to fade out
+			admitted = m_canShed || !Engine::audioEngine()->criticalXRuns();
+			break;
+	}
+
+	if (!admitted) { m_rejectedVoices.fetch_add(1, std::memory_order_relaxed); }
+	return admitted;
+}
+
+
+
+
+void VoiceGovernor::shed(const PlayHandleList& playHandles)
+{
+	const auto currentPolicy = policy();
+	if (currentPolicy == Policy::Off || currentPolicy == Policy::DropNew || exporting())
+	{
+		m_canShed = true;
+		return;
+	}
+	if (m_overloadedPeriods == 0) { m_canShed = true; }
+	if (m_overloadedPeriods == 0 || m_cooldown > 0) { return; }
+
+	const auto sampleRate = static_cast<float>(Engine::audioEngine()->outputSampleRate());
+
+	m_candidates.clear();
+	int releasedCandidates = 0;
+	for (const auto playHandle : playHandles)
+	{
+		if (playHandle->type() != PlayHandle::Type::NotePlayHandle) { continue; }
+
+		const auto note = static_cast<NotePlayHandle*>(playHandle);
+		// chords and arpeggios fade out with their master note, new notes are kept
+		if (note->hasParent() || note->isFinished() || note->isFadingOut() || note->totalFramesPlayed() == 0)
+		{
+			continue;
+		}
+
+		const bool released = note->isReleased();
+		// the lower, the earlier the note is shed: releasing notes by how long
+		// they have been releasing, sustained ones by volume and age
+		const float priority = released
+			? -static_cast<float>(note->releaseFramesDone())
+			: note->getVolume() / (1.f + note->totalFramesPlayed() / sampleRate);
+		m_candidates.push_back({note, released, priority});
+		releasedCandidates += released ? 1 : 0;
+	}
+
+	std::sort(m_candidates.begin(), m_candidates.end(), [](const Candidate& a, const Candidate& b) {
+		return a.released != b.released ? a.released : a.priority < b.priority;
+	});
+
+	const auto voices = static_cast<int>(m_candidates.size());
+	const auto excess = 1.f - TargetLoad / std::max(load(), OverloadedLoad);
+	const auto toShed = std::clamp(static_cast<int>(std::ceil(voices * excess)),
+		1, std::max(1, static_cast<int>(voices * MaxShedRatio)));
+	const bool steal = currentPolicy == Policy::StealVoices && m_overloadedPeriods >= StealAfterPeriods;
+	// short enough to free the time soon, long enough not to click
+	const auto fadeFrames = Engine::audioEngine()->framesPerPeriod();
+
+	int shed = 0;
+	int shedReleased = 0;
+	for (const auto& candidate : m_candidates)
+	{
+		if (shed >= toShed || (!candidate.released && !steal)) { break; }
+
+		candidate.handle->lock();
+		candidate.handle->fadeOut(fadeFrames);
+		candidate.handle->unlock();
+
+		auto& counter = candidate.released ? m_fadedVoices : m_stolenVoices;
+		counter.fetch_add(1, std::memory_order_relaxed);
+		shedReleased += candidate.released ? 1 : 0;
+		++shed;
+	}
+
+	m_canShed = releasedCandidates > shedReleased;
+	if (shed > 0) { m_cooldown = CooldownPeriods; }
+}
+
+
+
+
+void VoiceGovernor::finishPeriod(int periodTime, int periodLimit)
+{
+	if (periodLimit <= 0) { return; }
+
+	// react to overruns right away, but recover slowly
+	const auto newLoad = static_cast<float>(periodTime) / periodLimit;
+	const auto oldLoad = load();
+	m_load.store(newLoad > oldLoad ? newLoad : newLoad * 0.2f + oldLoad * 0.8f, std::memory_order_relaxed);
+
+	if (m_cooldown > 0) { --m_cooldown; }
+
+	const auto currentPolicy = policy();
+	if (currentPolicy == Policy::Off || currentPolicy == Policy::DropNew || exporting())
+	{
+		m_overloadedPeriods = 0;
+		m_reducedQuality = false;
+		return;
+	}
+
+	m_overloadedPeriods = newLoad > OverloadedLoad ? m_overloadedPeriods + 1 : 0;
+
+	if (load() > OverloadedLoad) { m_reducedQuality = true; }
+	else if (load() < RecoveredLoad) { m_reducedQuality = false; }
+
+	if (reducedQuality()) { m_reducedQualityPeriods.fetch_add(1, std::memory_order_relaxed); }
+}
+
+
+
+
+void VoiceGovernor::resetStatistics()
+{
+	m_rejectedVoices = 0;
+	m_fadedVoices = 0;
+	m_stolenVoices = 0;
+	m_reducedQualityPeriods = 0;
+}
+
+
+
+
+bool VoiceGovernor::exporting() const
+{
+	const auto song = Engine::getSong();
+	return song && song->isExporting();
+}
+
+} // namespace lmms
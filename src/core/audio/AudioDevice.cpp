@@ -34,8 +34,7 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 	m_supportsCapture( false ),
 	m_sampleRate( _audioEngine->outputSampleRate() ),
 	m_channels( _channels ),
-	m_audioEngine( _audioEngine ),
-	m_buffer(new SampleFrame[audioEngine()->framesPerPeriod()])
+	m_audioEngine( _audioEngine )
 {
 }
 
@@ -44,7 +43,6 @@ AudioDevice::AudioDevice( const ch_cnt_t _channels, AudioEngine*  _audioEngine )
 
 AudioDevice::~AudioDevice()
 {
-	delete[] m_buffer;
 	m_devMutex.tryLock();
 	unlock();
 }
@@ -54,8 +52,9 @@ AudioDevice::~AudioDevice()
 
 void AudioDevice::processNextBuffer()
 {
-	const fpp_t frames = getNextBuffer( m_buffer );
-	if (frames) { writeBuffer(m_buffer, frames); }
+	// the buffer stays valid until the next call to nextBuffer(), so write it in place
+	const SampleFrame* b = audioEngine()->nextBuffer();
+	if (b) { writeBuffer(b, audioEngine()->framesPerPeriod()); }
 	else
 	{
 		m_inProcess = false;
@@ -70,8 +69,6 @@ fpp_t AudioDevice::getNextBuffer(SampleFrame* _ab)
 	if (!b) { return 0; }
 
 	memcpy(_ab, b, frames * sizeof(SampleFrame));
-
-	if (audioEngine()->hasFifoWriter()) { delete[] b; }
 	return frames;
 }
 
@@ -23,6 +23,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QMessageBox>
 
 #include "AudioFileDevice.h"
@@ -75,12 +77,91 @@ AudioFileDevice::AudioFileDevice( OutputSettings const & outputSettings,
 
 AudioFileDevice::~AudioFileDevice()
 {
+	// the encoder thread was stopped by finishWriting(), it can't call
+	// encodeBuffer() of a subclass which has already been destroyed
 	m_outputFile.close();
 }
 
 
 
 
+void AudioFileDevice::writeBuffer(const SampleFrame* buffer, const fpp_t frames)
+{
+	if (!m_encoder.joinable())
+	{
+		m_ring.resize(NumBlocks * BlockFrames);
+		m_encoder = std::thread{&AudioFileDevice::runEncoder, this};
+	}
+
+	for (f_cnt_t done = 0; done < frames; )
+	{
+		const auto count = std::min(frames - done, BlockFrames - m_filled);
+		std::copy_n(buffer + done, count, m_ring.data() + m_writeBlock * BlockFrames + m_filled);
+		m_filled += count;
+		done += count;
+
+		if (m_filled == BlockFrames) { queueBlock(); }
+	}
+}
+
+
+
+
+void AudioFileDevice::queueBlock()
+{
+	auto lock = std::unique_lock{m_mutex};
+	m_blockFrames[m_writeBlock] = m_filled;
+	++m_queuedBlocks;
+	m_blockQueued.notify_one();
+
+	// wait until the encoder is done with the block which is filled next
+	m_blockEncoded.wait(lock, [this] { return m_queuedBlocks < NumBlocks; });
+	m_writeBlock = (m_writeBlock + 1) % NumBlocks;
+	m_filled = 0;
+}
+
+
+
+
+void AudioFileDevice::runEncoder()
+{
+	auto lock = std::unique_lock{m_mutex};
+	while (true)
+	{
+		m_blockQueued.wait(lock, [this] { return m_queuedBlocks > 0 || m_stopEncoder; });
+		// only stop once everything is encoded
+		if (m_queuedBlocks == 0) { return; }
+
+		const auto block = m_readBlock;
+		lock.unlock();
+		encodeBuffer(m_ring.data() + block * BlockFrames, m_blockFrames[block]);
+		lock.lock();
+
+		m_readBlock = (m_readBlock + 1) % NumBlocks;
+		--m_queuedBlocks;
+		m_blockEncoded.notify_one();
+	}
+}
+
+
+
+
+void AudioFileDevice::finishWriting()
+{
+	if (!m_encoder.joinable()) { return; }
+
+	if (m_filled > 0) { queueBlock(); }
+	{
+		const auto lock = std::lock_guard{m_mutex};
+		m_stopEncoder = true;
+	}
+	m_blockQueued.notify_one();
+	m_encoder.join();
+}
+
+
+
+
 int AudioFileDevice::writeData( const void* data, int len )
 {
 	if( m_outputFile.isOpen() )
@@ -41,6 +41,7 @@ AudioFileFlac::AudioFileFlac(OutputSettings const& outputSettings, ch_cnt_t cons
 
 AudioFileFlac::~AudioFileFlac()
 {
+	finishWriting();
 	finishEncoding();
 }
 
@@ -87,31 +88,31 @@ bool AudioFileFlac::startEncoding()
 	return true;
 }
 
-void AudioFileFlac::writeBuffer(const SampleFrame* _ab, fpp_t const frames)
+void AudioFileFlac::encodeBuffer(const SampleFrame* _ab, f_cnt_t const frames)
 {
 	OutputSettings::BitDepth depth = getOutputSettings().getBitDepth();
 	float clipvalue = std::nextafterf( -1.0f, 0.0f );
 
 	if (depth == OutputSettings::BitDepth::Depth24Bit || depth == OutputSettings::BitDepth::Depth32Bit) // Float encoding
 	{
-		auto buf = std::vector<sample_t>(frames * channels());
-		for(fpp_t frame = 0; frame < frames; ++frame)
+		m_floatBuffer.resize(frames * channels());
+		for(f_cnt_t frame = 0; frame < frames; ++frame)
 		{
 			for(ch_cnt_t channel=0; channel<channels(); ++channel)
 			{
 				// Clip the negative side to just above -1.0 in order to prevent it from changing sign
 				// Upstream issue: https://github.com/erikd/libsndfile/issues/309
 				// When this commit is reverted libsndfile-1.0.29 must be made a requirement for FLAC
-				buf[frame*channels() + channel] = std::max(clipvalue, _ab[frame][channel]);
+				m_floatBuffer[frame*channels() + channel] = std::max(clipvalue, _ab[frame][channel]);
 			}
 		}
-		sf_writef_float(m_sf, static_cast<float*>(buf.data()), frames);
+		sf_writef_float(m_sf, m_floatBuffer.data(), frames);
 	}
 	else // integer PCM encoding
 	{
-		auto buf = std::vector<int_sample_t>(frames * channels());
-		convertToS16(_ab, frames, buf.data(), !isLittleEndian());
-		sf_writef_short(m_sf, static_cast<short*>(buf.data()), frames);
+		m_intBuffer.resize(frames * channels());
+		convertToS16(_ab, frames, m_intBuffer.data(), !isLittleEndian());
+		sf_writef_short(m_sf, m_intBuffer.data(), frames);
 	}
 
 }
@@ -30,6 +30,7 @@
 #ifdef LMMS_HAVE_MP3LAME
 
 
+#include <algorithm>
 #include <cassert>
 
 namespace lmms
@@ -51,31 +52,26 @@ AudioFileMP3::AudioFileMP3(	OutputSettings const & outputSettings,
 
 AudioFileMP3::~AudioFileMP3()
 {
+	finishWriting();
 	flushRemainingBuffers();
 	tearDownEncoder();
 }
 
-void AudioFileMP3::writeBuffer(const SampleFrame* _buf, const fpp_t _frames)
+void AudioFileMP3::encodeBuffer(const SampleFrame* _buf, const f_cnt_t _frames)
 {
 	if (_frames < 1)
 	{
 		return;
 	}
 
-	std::vector<float> interleavedDataBuffer(_frames * 2);
-	for (fpp_t i = 0; i < _frames; ++i)
-	{
-		interleavedDataBuffer[2*i] = _buf[i][0];
-		interleavedDataBuffer[2*i + 1] = _buf[i][1];
-	}
-
 	size_t minimumBufferSize = 1.25 * _frames + 7200;
-	std::vector<unsigned char> encodingBuffer(minimumBufferSize);
+	m_encodingBuffer.resize(std::max(m_encodingBuffer.size(), minimumBufferSize));
 
-	int bytesWritten = lame_encode_buffer_interleaved_ieee_float(m_lame, &interleavedDataBuffer[0], _frames, &encodingBuffer[0], static_cast<int>(encodingBuffer.size()));
+	// Only stereo sources are accepted, so the sample frames are interleaved already
+	int bytesWritten = lame_encode_buffer_interleaved_ieee_float(m_lame, _buf->data(), static_cast<int>(_frames), m_encodingBuffer.data(), static_cast<int>(m_encodingBuffer.size()));
 	assert (bytesWritten >= 0);
 
-	writeData(&encodingBuffer[0], bytesWritten);
+	writeData(m_encodingBuffer.data(), bytesWritten);
 }
 
 void AudioFileMP3::flushRemainingBuffers()
@@ -79,6 +79,7 @@ AudioFileOgg::AudioFileOgg(OutputSettings const& outputSettings, const ch_cnt_t
 
 AudioFileOgg::~AudioFileOgg()
 {
+	finishWriting();
 	vorbis_analysis_wrote(&m_vds, 0);
 	ogg_stream_clear(&m_oss);
 	vorbis_block_clear(&m_vb);
@@ -87,7 +88,7 @@ AudioFileOgg::~AudioFileOgg()
 	vorbis_info_clear(&m_vi);
 }
 
-void AudioFileOgg::writeBuffer(const SampleFrame* _ab, const fpp_t _frames)
+void AudioFileOgg::encodeBuffer(const SampleFrame* _ab, const f_cnt_t _frames)
 {
 	const auto vab = vorbis_analysis_buffer(&m_vds, _frames);
 
@@ -46,6 +46,7 @@ AudioFileWave::AudioFileWave( OutputSettings const & outputSettings,
 
 AudioFileWave::~AudioFileWave()
 {
+	finishWriting();
 	finishEncoding();
 }
 
@@ -93,30 +94,35 @@ bool AudioFileWave::startEncoding()
 	return true;
 }
 
-void AudioFileWave::writeBuffer(const SampleFrame* _ab, const fpp_t _frames)
+void AudioFileWave::encodeBuffer(const SampleFrame* _ab, const f_cnt_t _frames)
 {
 	OutputSettings::BitDepth bitDepth = getOutputSettings().getBitDepth();
 
 	if( bitDepth == OutputSettings::BitDepth::Depth32Bit || bitDepth == OutputSettings::BitDepth::Depth24Bit )
 	{
-		auto buf = new float[_frames * channels()];
-		for( fpp_t frame = 0; frame < _frames; ++frame )
+		if (channels() == DEFAULT_CHANNELS)
+		{
+			// sample frames are interleaved already
+			sf_writef_float(m_sf, _ab->data(), _frames);
+			return;
+		}
+
+		m_floatBuffer.resize(_frames * channels());
+		for( f_cnt_t frame = 0; frame < _frames; ++frame )
 		{
 			for( ch_cnt_t chnl = 0; chnl < channels(); ++chnl )
 			{
-				buf[frame * channels() + chnl] = _ab[frame][chnl];
+				m_floatBuffer[frame * channels() + chnl] = chnl < DEFAULT_CHANNELS ? _ab[frame][chnl] : 0.f;
 			}
 		}
-		sf_writef_float( m_sf, buf, _frames );
-		delete[] buf;
+		sf_writef_float(m_sf, m_floatBuffer.data(), _frames);
 	}
 	else
 	{
-		auto buf = new int_sample_t[_frames * channels()];
-		convertToS16(_ab, _frames, buf, !isLittleEndian());
+		m_intBuffer.resize(_frames * channels());
+		convertToS16(_ab, _frames, m_intBuffer.data(), !isLittleEndian());
 
-		sf_writef_short( m_sf, buf, _frames );
-		delete[] buf;
+		sf_writef_short(m_sf, m_intBuffer.data(), _frames);
 	}
 }
 
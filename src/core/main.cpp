@@ -58,7 +58,9 @@
 #include <csignal>  // To register the signal handler
 
 #include "MainApplication.h"
+#include "AudioEngineProfiler.h"
 #include "ConfigManager.h"
+#include "CpuMeter.h"
 #include "DataFile.h"
 #include "NotePlayHandle.h"
 #include "embed.h"
@@ -197,12 +199,29 @@ void printHelp()
 		"            j: Joint Stereo\n"
 		"            m: Mono\n"
 		"          Default: j\n"
+		"      --one-pass                 For \"rendertracks\", render the song only once\n"
+		"          and take each track before the mixer. The full mix is written as well.\n"
+		"      --mixer-channels           For \"rendertracks\", also render each mixer channel\n"
+		"          to a different file. Implies --one-pass.\n"
+		"  -j, --jobs <n>                 For \"render\", render up to <n> segments of the\n"
+		"          song in parallel processes and stitch them together. This is only\n"
+		"          exact if nothing sounds across the segment boundaries for longer\n"
+		"          than the pre-roll. Default: 1\n"
+		"      --preroll <bars>           Bars rendered before each segment and dropped\n"
+		"          afterwards. Default: 2\n"
+		"      --verify                   With --jobs, also render the song normally and\n"
+		"          report how far the segments differ from it\n"
+		"      --segment <begin>:<end>    Render only the ticks from <begin> to <end>,\n"
+		"          used by --jobs\n"
 		"  -o, --output <path>            Render into <path>\n"
 		"          For \"render\", provide a file path\n"
 		"          For \"rendertracks\", provide a directory path\n"
 		"          If not specified, render will overwrite the input file\n"
 		"          For \"rendertracks\", this might be required\n"
 		"  -p, --profile <out>            Dump profiling information to file <out>\n"
+		"          and print the CPU usage of instruments, effects and mixer channels\n"
+		"      --trace <out>              Write a Chrome trace of all audio jobs to file <out>,\n"
+		"          which can be opened in Perfetto or chrome://tracing\n"
 		"  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
 		"          Range: 44100 (default) to 192000\n"
 		"          Possible values: 1, 2, 4, 8\n"
@@ -254,7 +273,13 @@ int main( int argc, char * * argv )
 	bool allowRoot = false;
 	bool renderLoop = false;
 	bool renderTracks = false;
-	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, configFile;
+	bool renderOnePass = false;
+	bool renderMixerChannels = false;
+	bool renderVerify = false;
+	int renderJobs = 1;
+	int renderPreroll = 2;
+	tick_t renderSegmentBegin = -1, renderSegmentEnd = -1;
+	QString fileToLoad, fileToImport, renderOut, profilerOutputFile, traceOutputFile, configFile;
 
 	// first of two command-line parsing stages
 	for (int i = 1; i < argc; ++i)
@@ -487,6 +512,71 @@ int main( int argc, char * * argv )
 		{
 			renderLoop = true;
 		}
+		else if (arg == "--one-pass")
+		{
+			renderOnePass = true;
+		}
+		else if (arg == "--mixer-channels")
+		{
+			renderOnePass = true;
+			renderMixerChannels = true;
+		}
+		else if (arg == "--jobs" || arg == "-j")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No number of jobs specified");
+			}
+
+			renderJobs = QString(argv[i]).toInt();
+			if (renderJobs < 1)
+			{
+				return usageError(QString("Invalid number of jobs %1").arg(argv[i]));
+			}
+		}
+		else if (arg == "--preroll")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No pre-roll specified");
+			}
+
+			bool ok = false;
+			renderPreroll = QString(argv[i]).toInt(&ok);
+			if (!ok || renderPreroll < 0)
+			{
+				return usageError(QString("Invalid pre-roll %1").arg(argv[i]));
+			}
+		}
+		else if (arg == "--verify")
+		{
+			renderVerify = true;
+		}
+		else if (arg == "--segment")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No segment specified");
+			}
+
+			const auto range = QString(argv[i]).split(':');
+			bool beginOk = false, endOk = false;
+			if (range.size() == 2)
+			{
+				renderSegmentBegin = range[0].toInt(&beginOk);
+				renderSegmentEnd = range[1].toInt(&endOk);
+			}
+			if (!beginOk || !endOk || renderSegmentBegin < 0 || renderSegmentEnd <= renderSegmentBegin)
+			{
+				return usageError(QString("Invalid segment %1").arg(argv[i]));
+			}
+		}
 		else if( arg == "--output" || arg == "-o" )
 		{
 			++i;
@@ -639,6 +729,17 @@ int main( int argc, char * * argv )
 
 			profilerOutputFile = QString::fromLocal8Bit( argv[i] );
 		}
+		else if (arg == "--trace")
+		{
+			++i;
+
+			if (i == argc)
+			{
+				return usageError("No trace file specified");
+			}
+
+			traceOutputFile = QString::fromLocal8Bit(argv[i]);
+		}
 		else if( arg == "--config" || arg == "-c" )
 		{
 			++i;
@@ -728,6 +829,15 @@ int main( int argc, char * * argv )
 
 		Engine::getSong()->setExportLoop( renderLoop );
 
+		if (renderSegmentBegin >= 0)
+		{
+			// render between the loop markers, which are not saved again
+			Engine::getSong()->getTimeline(Song::PlayMode::Song).setLoopPoints(
+				TimePos{renderSegmentBegin}, TimePos{renderSegmentEnd});
+			Engine::getSong()->setRenderBetweenMarkers(true);
+			Engine::getSong()->setLoopRenderCount(1);
+		}
+
 		// when rendering multiple tracks, renderOut is a directory
 		// otherwise, it is a file, so we need to append the file extension
 		if ( !renderTracks )
@@ -750,10 +860,24 @@ int main( int argc, char * * argv )
 		if( profilerOutputFile.isEmpty() == false )
 		{
 			Engine::audioEngine()->profiler().setOutputFile( profilerOutputFile );
+			CpuMeter::setEnabled(true);
+		}
+
+		if (!traceOutputFile.isEmpty())
+		{
+			Engine::audioEngine()->profiler().setTraceFile(traceOutputFile);
 		}
 
 		// start now!
-		if ( renderTracks )
+		if (renderTracks && renderOnePass)
+		{
+			r->renderTracksInOnePass(renderMixerChannels);
+		}
+		else if (!renderTracks && renderJobs > 1)
+		{
+			r->renderProjectInSegments(renderJobs, renderPreroll, renderVerify);
+		}
+		else if ( renderTracks )
 		{
 			r->renderTracks();
 		}
@@ -922,6 +1046,10 @@ int main( int argc, char * * argv )
 
 	if( destroyEngine )
 	{
+		if (!profilerOutputFile.isEmpty())
+		{
+			printf("\n\n%s", qPrintable(AudioEngineProfiler::cpuMeterReport()));
+		}
 		Engine::destroy();
 	}
 
@@ -40,14 +40,19 @@
 #include "CaptionMenu.h"
 #include "ColorChooser.h"
 #include "ConfigManager.h"
+#include "CpuMeter.h"
+#include "Effect.h"
 #include "EffectRackView.h"
 #include "Fader.h"
 #include "FontHelper.h"
 #include "GuiApplication.h"
+#include "Instrument.h"
+#include "InstrumentTrack.h"
 #include "Knob.h"
 #include "LcdWidget.h"
 #include "Mixer.h"
 #include "MixerView.h"
+#include "PatternStore.h"
 #include "PeakIndicator.h"
 #include "SendButtonIndicator.h"
 #include "Song.h"
@@ -139,6 +144,11 @@ MixerChannelView::MixerChannelView(QWidget* parent, MixerView* mixerView, int ch
 	m_peakIndicator = new PeakIndicator(this);
 	connect(m_fader, &Fader::peakChanged, m_peakIndicator, &PeakIndicator::updatePeak);
 
+	m_cpuLabel = new QLabel{this};
+	m_cpuLabel->setFont(adjustedToPixelSize(font(), SMALL_FONT_SIZE));
+	m_cpuLabel->setAlignment(Qt::AlignHCenter);
+	m_cpuLabel->setVisible(CpuMeter::isEnabled());
+
 	m_effectRackView = new EffectRackView{&mixerChannel->m_fxChain, mixerView->m_racksWidget};
 	m_effectRackView->setFixedWidth(EffectRackView::DEFAULT_WIDTH);
 
@@ -153,6 +163,7 @@ MixerChannelView::MixerChannelView(QWidget* parent, MixerView* mixerView, int ch
 	mainLayout->addWidget(m_renameLineEditView, 0, Qt::AlignHCenter);
 	mainLayout->addLayout(soloMuteLayout);
 	mainLayout->addWidget(m_peakIndicator);
+	mainLayout->addWidget(m_cpuLabel);
 	mainLayout->addWidget(m_fader, 1, Qt::AlignHCenter);
 
 	connect(m_renameLineEdit, &QLineEdit::editingFinished, this, &MixerChannelView::renameFinished);
@@ -258,6 +269,42 @@ void MixerChannelView::setChannelIndex(int index)
 	m_channelIndex = index;
 }
 
+void MixerChannelView::updateCpuMeter()
+{
+	m_cpuLabel->setVisible(CpuMeter::isEnabled());
+	if (!CpuMeter::isEnabled()) { return; }
+
+	const auto channel = mixerChannel();
+	m_cpuLabel->setText(QString::number(channel->m_cpuMeter.averageLoad(), 'f', 1) + "%");
+
+	// only collect the details while somebody might read them
+	if (!m_cpuLabel->underMouse()) { return; }
+
+	const auto line = [](const QString& name, const CpuMeter& meter) {
+		return tr("%1: %2% (worst %3%)").arg(name,
+			QString::number(meter.averageLoad(), 'f', 1), QString::number(meter.worstLoad(), 'f', 1));
+	};
+
+	auto lines = QStringList{line(channel->m_name, channel->m_cpuMeter)};
+	for (const auto effect : channel->m_fxChain.effects())
+	{
+		lines << line(effect->displayName(), effect->cpuMeter());
+	}
+	for (const auto& tracks : {Engine::getSong()->tracks(), Engine::patternStore()->tracks()})
+	{
+		for (const auto track : tracks)
+		{
+			const auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track);
+			if (instrumentTrack && instrumentTrack->instrument()
+				&& instrumentTrack->mixerChannelModel()->value() == m_channelIndex)
+			{
+				lines << line(instrumentTrack->name(), instrumentTrack->instrument()->cpuMeter());
+			}
+		}
+	}
+	m_cpuLabel->setToolTip(lines.join('\n'));
+}
+
 void MixerChannelView::renameChannel()
 {
 	m_inRename = true;
@@ -289,6 +336,7 @@ void MixerChannelView::renameFinished()
 	if (!newName.isEmpty() && mc->m_name != newName)
 	{
 		mc->m_name = newName;
+		mc->setTraceName(newName);
 		m_renameLineEdit->setText(elideName(newName));
 		Engine::getSong()->setModified();
 	}
@@ -619,6 +619,8 @@ void MixerView::updateFaders()
 		{
 			m_mixerChannelViews[i]->m_fader->setPeak_R(opr/fallOff);
 		}
+
+		m_mixerChannelViews[i]->updateCpuMeter();
 	}
 }
 
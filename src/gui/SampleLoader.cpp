@@ -32,6 +32,7 @@
 #include "FileDialog.h"
 #include "GuiApplication.h"
 #include "PathUtil.h"
+#include "SampleCache.h"
 #include "SampleDecoder.h"
 
 namespace lmms::gui {
@@ -93,7 +94,7 @@ std::shared_ptr<const SampleBuffer> SampleLoader::createBufferFromFile(const QSt
 
 	try
 	{
-		return std::make_shared<SampleBuffer>(filePath);
+		return SampleCache::instance().get(filePath);
 	}
 	catch (const std::runtime_error& error)
 	{
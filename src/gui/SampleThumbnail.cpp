@@ -25,14 +25,78 @@
 
 #include "SampleThumbnail.h"
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
+#include "PathUtil.h"
 #include "Sample.h"
+#include "ThreadPool.h"
 
 namespace {
 	constexpr auto MaxSampleThumbnailCacheSize = 32;
 	constexpr auto AggregationPerZoomStep = 10;
+
+	//! Shorter samples are cheap enough to be visualized right away
+	constexpr auto MinBackgroundFrames = std::size_t{1} << 18;
+
+	//! Peak files are removed, oldest first, when the directory grows beyond this
+	constexpr auto MaxPeakCacheBytes = qint64{512} << 20;
+
+	//! Bump when the layout of peak files or the way the peaks are computed changes
+	constexpr auto PeakFileVersion = std::uint32_t{1};
+	constexpr char PeakFileMagic[8] = {'L', 'M', 'M', 'S', 'P', 'E', 'A', 'K'};
+
+	// A peak file is the header, followed by one `PeakFileLevel` per thumbnail and then the peaks of every
+	// thumbnail as pairs of floats, all in native byte order, so it can be mapped and read in place.
+	struct PeakFileHeader
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t levels;
+		std::uint64_t frames;
+	};
+
+	struct PeakFileLevel
+	{
+		std::uint64_t width;
+		double samplesPerPeak;
+	};
+
+	auto peakCacheDir() -> QString
+	{
+		return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/peaks";
+	}
+
+	auto peakFilePath(const QFileInfo& fileInfo) -> QString
+	{
+		const auto key = QString{"%1\n%2\n%3"}
+			.arg(fileInfo.absoluteFilePath())
+			.arg(fileInfo.lastModified().toMSecsSinceEpoch())
+			.arg(fileInfo.size());
+		const auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+		return peakCacheDir() + "/" + QString::fromLatin1(hash) + ".peaks";
+	}
+
+	void trimPeakCache()
+	{
+		const auto files = QDir{peakCacheDir()}.entryInfoList({"*.peaks"}, QDir::Files, QDir::Time);
+
+		auto total = qint64{0};
+		for (const auto& file : files)
+		{
+			total += file.size();
+			if (total > MaxPeakCacheBytes) { QFile::remove(file.absoluteFilePath()); }
+		}
+	}
 }
 
 namespace lmms {
@@ -71,16 +135,32 @@ SampleThumbnail::Thumbnail SampleThumbnail::Thumbnail::zoomOut(float factor) con
 	return Thumbnail{std::move(peaks), m_samplesPerPeak * factor};
 }
 
-SampleThumbnail::SampleThumbnail(const Sample& sample)
+SampleThumbnail::SampleThumbnail(const Sample& sample, QObject* context, std::function<void()> onReady)
 	: m_buffer(sample.buffer())
 {
-	auto entry = SampleThumbnailEntry{sample.sampleFile(), QFileInfo{sample.sampleFile()}.lastModified()};
-	if (!entry.filePath.isEmpty())
+	const auto waitForCache = [&] {
+		if (!onReady) { return; }
+
+		const auto lock = std::lock_guard{m_thumbnailCache->waitingMutex};
+		if (m_thumbnailCache->ready.load(std::memory_order_relaxed)) { return; }
+
+		auto& waiting = m_thumbnailCache->waiting;
+		const auto it = std::find_if(waiting.begin(), waiting.end(),
+			[&](const auto& waiter) { return context && waiter.first == context; });
+		if (it != waiting.end()) { it->second = std::move(onReady); }
+		else { waiting.emplace_back(context, std::move(onReady)); }
+	};
+
+	const auto fileInfo = QFileInfo{PathUtil::toAbsolute(sample.sampleFile())};
+	auto entry = SampleThumbnailEntry{sample.sampleFile(), fileInfo.lastModified()};
+	const auto hasFile = !entry.filePath.isEmpty();
+	if (hasFile)
 	{
 		const auto it = s_sampleThumbnailCacheMap.find(entry);
 		if (it != s_sampleThumbnailCacheMap.end())
 		{
 			m_thumbnailCache = it->second;
+			waitForCache();
 			return;
 		}
 
@@ -94,14 +174,124 @@ SampleThumbnail::SampleThumbnail(const Sample& sample)
 		s_sampleThumbnailCacheMap[std::move(entry)] = m_thumbnailCache;
 	}
 
-	const auto flatBuffer = m_buffer->data()->data();
-	const auto flatBufferSize = m_buffer->size() * DEFAULT_CHANNELS;
-	m_thumbnailCache->emplace_back(flatBuffer, flatBufferSize, flatBufferSize / AggregationPerZoomStep);
+	if (m_buffer->size() < MinBackgroundFrames)
+	{
+		generate(*m_thumbnailCache, *m_buffer);
+		m_thumbnailCache->ready.store(true, std::memory_order_release);
+		return;
+	}
+
+	waitForCache();
+
+	const auto peakFile = hasFile && fileInfo.exists() ? peakFilePath(fileInfo) : QString{};
+	ThreadPool::instance().enqueue([cache = m_thumbnailCache, buffer = m_buffer, peakFile] {
+		if (peakFile.isEmpty() || !load(*cache, peakFile, buffer->size()))
+		{
+			generate(*cache, *buffer);
+			if (!peakFile.isEmpty()) { save(*cache, peakFile, buffer->size()); }
+		}
+		finish(*cache);
+	});
+}
+
+void SampleThumbnail::generate(ThumbnailCache& cache, const SampleBuffer& buffer)
+{
+	const auto flatBuffer = buffer.data()->data();
+	const auto flatBufferSize = buffer.size() * DEFAULT_CHANNELS;
+	cache.thumbnails.emplace_back(flatBuffer, flatBufferSize, flatBufferSize / AggregationPerZoomStep);
+
+	while (cache.thumbnails.back().width() >= AggregationPerZoomStep)
+	{
+		auto zoomedOutThumbnail = cache.thumbnails.back().zoomOut(AggregationPerZoomStep);
+		cache.thumbnails.emplace_back(std::move(zoomedOutThumbnail));
+	}
+}
+
+bool SampleThumbnail::load(ThumbnailCache& cache, const QString& peakFile, std::size_t frames)
+{
+	auto file = QFile{peakFile};
+	if (!file.open(QFile::ReadOnly)) { return false; }
+
+	const auto size = static_cast<std::size_t>(file.size());
+	if (size < sizeof(PeakFileHeader)) { return false; }
+
+	const auto data = file.map(0, file.size());
+	if (!data) { return false; }
+
+	auto header = PeakFileHeader{};
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, PeakFileMagic, sizeof(PeakFileMagic)) != 0 || header.version != PeakFileVersion
+		|| header.frames != frames)
+	{
+		return false;
+	}
+
+	// a corrupt or truncated file is a cache miss, check the sizes before allocating anything
+	if (header.levels > (size - sizeof(PeakFileHeader)) / sizeof(PeakFileLevel)) { return false; }
+
+	auto levels = std::vector<PeakFileLevel>(header.levels);
+	auto offset = sizeof(PeakFileHeader) + levels.size() * sizeof(PeakFileLevel);
+	std::memcpy(levels.data(), data + sizeof(PeakFileHeader), levels.size() * sizeof(PeakFileLevel));
+
+	auto thumbnails = std::vector<Thumbnail>{};
+	thumbnails.reserve(levels.size());
+	for (const auto& level : levels)
+	{
+		if (level.width > (size - offset) / sizeof(Thumbnail::Peak)) { return false; }
+		const auto bytes = level.width * sizeof(Thumbnail::Peak);
+
+		auto peaks = std::vector<Thumbnail::Peak>(level.width);
+		std::memcpy(peaks.data(), data + offset, bytes);
+		thumbnails.emplace_back(std::move(peaks), level.samplesPerPeak);
+		offset += bytes;
+	}
+
+	if (thumbnails.empty()) { return false; }
+	cache.thumbnails = std::move(thumbnails);
+	return true;
+}
+
+void SampleThumbnail::save(const ThumbnailCache& cache, const QString& peakFile, std::size_t frames)
+{
+	if (!QDir{}.mkpath(peakCacheDir())) { return; }
+
+	auto header = PeakFileHeader{};
+	std::memcpy(header.magic, PeakFileMagic, sizeof(PeakFileMagic));
+	header.version = PeakFileVersion;
+	header.levels = static_cast<std::uint32_t>(cache.thumbnails.size());
+	header.frames = frames;
+
+	auto file = QSaveFile{peakFile};
+	if (!file.open(QFile::WriteOnly)) { return; }
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for (const auto& thumbnail : cache.thumbnails)
+	{
+		const auto level = PeakFileLevel{static_cast<std::uint64_t>(thumbnail.width()), thumbnail.samplesPerPeak()};
+		file.write(reinterpret_cast<const char*>(&level), sizeof(level));
+	}
+	for (const auto& thumbnail : cache.thumbnails)
+	{
+		file.write(reinterpret_cast<const char*>(thumbnail.data()), thumbnail.width() * sizeof(Thumbnail::Peak));
+	}
+
+	if (file.commit()) { trimPeakCache(); }
+}
+
+void SampleThumbnail::finish(ThumbnailCache& cache)
+{
+	auto waiting = decltype(cache.waiting){};
+	{
+		const auto lock = std::lock_guard{cache.waitingMutex};
+		cache.ready.store(true, std::memory_order_release);
+		std::swap(waiting, cache.waiting);
+	}
 
-	while (m_thumbnailCache->back().width() >= AggregationPerZoomStep)
+	for (auto& [context, onReady] : waiting)
 	{
-		auto zoomedOutThumbnail = m_thumbnailCache->back().zoomOut(AggregationPerZoomStep);
-		m_thumbnailCache->emplace_back(std::move(zoomedOutThumbnail));
+		QMetaObject::invokeMethod(QCoreApplication::instance(), [context = std::move(context), onReady = std::move(onReady)] {
+			if (context) { onReady(); }
+		}, Qt::QueuedConnection);
 	}
 }
 
@@ -116,11 +306,19 @@ void SampleThumbnail::visualize(VisualizeParameters parameters, QPainter& painte
 	const auto sampleRange = parameters.sampleEnd - parameters.sampleStart;
 	if (sampleRange <= 0.0f || sampleRange > 1.0f) { return; }
 
+	if (!isReady())
+	{
+		// placeholder until the thumbnail has been generated
+		painter.drawLine(renderRect.left(), renderRect.center().y(), renderRect.right(), renderRect.center().y());
+		return;
+	}
+
 	const auto targetThumbnailWidth = static_cast<int>(sampleRect.width() / sampleRange);
-	const auto finerThumbnail = std::find_if(m_thumbnailCache->rbegin(), m_thumbnailCache->rend(),
+	const auto& thumbnails = m_thumbnailCache->thumbnails;
+	const auto finerThumbnail = std::find_if(thumbnails.rbegin(), thumbnails.rend(),
 		[&](const auto& thumbnail) { return thumbnail.width() >= targetThumbnailWidth; });
 
-	const auto useOriginalBuffer = finerThumbnail == m_thumbnailCache->rend();
+	const auto useOriginalBuffer = finerThumbnail == thumbnails.rend();
 	const auto drawOriginalBuffer = static_cast<size_t>(targetThumbnailWidth) == m_buffer->size();
 
 	painter.save();
@@ -32,6 +32,7 @@
 #include <QMenu>
 #include <QPainter>
 #include <set>
+#include <vector>
 
 #include "AutomationEditor.h"
 #include "ConfigManager.h"
@@ -318,7 +319,8 @@ void MidiClipView::mergeClips(QVector<ClipView*> clipvs)
 
 	newMidiClip->saveJournallingState(false);
 
-	// Add the notes and remove the Clips that are being merged
+	// Collect the notes and remove the Clips that are being merged
+	std::vector<Note> notes;
 	for (auto clipv: clipvs)
 	{
 		// Convert ClipV to MidiClipView
@@ -343,9 +345,10 @@ void MidiClipView::mergeClips(QVector<ClipView*> clipvs)
 			const TimePos newLength = newNoteEnd - newNoteStart;
 			if (newLength > 0)
 			{
-				Note* newNote = newMidiClip->addNote(*note, false);
-				newNote->setPos(newNoteStart + (mcViewPos - earliestPos));
-				newNote->setLength(newLength);
+				Note newNote = Note{*note};
+				newNote.setPos(newNoteStart + (mcViewPos - earliestPos));
+				newNote.setLength(newLength);
+				notes.push_back(newNote);
 			}
 		}
 
@@ -356,11 +359,11 @@ void MidiClipView::mergeClips(QVector<ClipView*> clipvs)
 		clipv->remove();
 	}
 
+	newMidiClip->addNotes(notes, false);
+
 	// Update length to extend from the start of the first clip to the end of the last clip
 	newMidiClip->changeLength(latestPos - earliestPos);
 	newMidiClip->setAutoResize(false);
-	// Rearrange notes because we might have moved them
-	newMidiClip->rearrangeAllNotes();
 	// Restore journalling states now that the operation is finished
 	newMidiClip->restoreJournallingState();
 	track->restoreJournallingState();
@@ -381,6 +384,7 @@ void MidiClipView::clearNotesOutOfBounds()
 	TimePos startBound = -m_clip->startTimeOffset();
 	TimePos endBound = m_clip->length() - m_clip->startTimeOffset();
 
+	std::vector<Note> notes;
 	for (Note const* note: m_clip->m_notes)
 	{
 		const TimePos newNoteStart = std::max(note->pos(), startBound) - startBound;
@@ -391,9 +395,10 @@ void MidiClipView::clearNotesOutOfBounds()
 			Note newNote = Note{*note};
 			newNote.setPos(newNoteStart);
 			newNote.setLength(newLength);
-			newClip->addNote(newNote, false);
+			notes.push_back(newNote);
 		}
 	}
+	newClip->addNotes(notes, false);
 	newClip->changeLength(m_clip->length());
 	newClip->updateLength();
 
@@ -891,20 +896,22 @@ bool MidiClipView::destructiveSplitClip(const TimePos pos)
 	auto rightClip =  m_clip->clone();
 	rightClip->clearNotes();
 
+	std::vector<Note> leftNotes;
+	std::vector<Note> rightNotes;
 	for (Note const* note : m_clip->m_notes)
 	{
 		if (note->pos() >= internalSplitPos)
 		{
 			auto movedNote = Note{*note};
 			movedNote.setPos(note->pos() - internalSplitPos);
-			rightClip->addNote(movedNote, false);
+			rightNotes.push_back(movedNote);
 		}
 		else if (note->endPos() > internalSplitPos)
 		{
 			auto movedNote = Note{*note};
 			movedNote.setPos(0);
 			movedNote.setLength(note->endPos() - internalSplitPos);
-			rightClip->addNote(movedNote, false);
+			rightNotes.push_back(movedNote);
 		}
 	}
 
@@ -912,16 +919,19 @@ bool MidiClipView::destructiveSplitClip(const TimePos pos)
 	{
 		if (note->endPos() <= internalSplitPos)
 		{
-			leftClip->addNote(*note, false);
+			leftNotes.push_back(*note);
 		}
 		else if (note->pos() < internalSplitPos)
 		{
 			auto movedNote = Note{*note};
 			movedNote.setLength(internalSplitPos - note->pos());
-			leftClip->addNote(movedNote, false);
+			leftNotes.push_back(movedNote);
 		}
 	}
 
+	rightClip->addNotes(rightNotes, false);
+	leftClip->addNotes(leftNotes, false);
+
 	leftClip->movePosition(m_initialClipPos);
 	leftClip->setAutoResize(false);
 	leftClip->changeLength(splitPos - m_initialClipPos);
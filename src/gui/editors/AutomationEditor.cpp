@@ -1030,7 +1030,7 @@ void AutomationEditor::setGhostSample(SampleClip* newGhostSample)
 	// Expects a pointer to a Sample buffer or nullptr.
 	m_ghostSample = newGhostSample;
 	m_renderSample = true;
-	m_sampleThumbnail = SampleThumbnail{newGhostSample->sample()};
+	m_sampleThumbnail = SampleThumbnail{newGhostSample->sample(), this, [this] { update(); }};
 }
 
 void AutomationEditor::paintEvent(QPaintEvent * pe )
@@ -45,6 +45,7 @@
 
 #include <cmath>
 #include <utility>
+#include <vector>
 
 #include "AutomationEditor.h"
 #include "ActionGroup.h"
@@ -1912,11 +1913,14 @@ void PianoRoll::mousePressEvent(QMouseEvent * me )
 					// if they're holding shift, copy all selected notes
 					if( ! is_new_note && me->modifiers() & Qt::ShiftModifier )
 					{
+						std::vector<Note> copies;
+						copies.reserve(selectedNotes.size());
 						for (Note *note: selectedNotes)
 						{
-							Note *newNote = m_midiClip->addNote(*note, false);
-							newNote->setSelected(false);
+							copies.push_back(*note);
+							copies.back().setSelected(false);
 						}
+						m_midiClip->addNotes(copies, false);
 
 						if (!selectedNotes.empty())
 						{
@@ -4565,6 +4569,8 @@ void PianoRoll::pasteNotes()
 			m_midiClip->addJournalCheckPoint();
 		}
 
+		std::vector<Note> notes;
+		notes.reserve(list.size());
 		for( int i = 0; ! list.item( i ).isNull(); ++i )
 		{
 			// create the note
@@ -4575,10 +4581,12 @@ void PianoRoll::pasteNotes()
 			// select it
 			cur_note.setSelected( true );
 
-			// add to MIDI clip
-			m_midiClip->addNote( cur_note, false );
+			notes.push_back(cur_note);
 		}
 
+		// add to MIDI clip
+		m_midiClip->addNotes(notes, false);
+
 		// we only have to do the following lines if we pasted at
 		// least one note...
 		Engine::getSong()->setModified();
@@ -4780,6 +4788,8 @@ void PianoRoll::quantizeNotes(QuantizeAction mode)
 		}
 	}
 
+	std::vector<Note> quantized;
+	quantized.reserve(notes.size());
 	for( Note* n : notes )
 	{
 		if( n->length() == TimePos( 0 ) )
@@ -4797,8 +4807,9 @@ void PianoRoll::quantizeNotes(QuantizeAction mode)
 		{
 			copy.quantizeLength(quantization());
 		}
-		m_midiClip->addNote(copy, false);
+		quantized.push_back(copy);
 	}
+	m_midiClip->addNotes(quantized, false);
 
 	update();
 	getGUI()->songEditor()->update();
@@ -106,6 +106,11 @@ ExportProjectDialog::ExportProjectDialog( const QString & _file_name,
 	const auto currentIndex = std::max(0, samplerateCB->findData(Engine::audioEngine()->outputSampleRate()));
 	samplerateCB->setCurrentIndex(currentIndex);
 
+	// exporting tracks in one pass is only possible when exporting tracks
+	onePassCB->setVisible(m_multiExport);
+	mixerChannelsCB->setVisible(m_multiExport);
+	connect(onePassCB, &QCheckBox::toggled, mixerChannelsCB, &QCheckBox::setEnabled);
+
 	connect( startButton, SIGNAL(clicked()),
 			this, SLOT(startBtnClicked()));
 }
@@ -197,7 +202,11 @@ void ExportProjectDialog::startExport()
 	connect( m_renderManager.get(), SIGNAL(finished()),
 			getGUI()->mainWindow(), SLOT(resetWindowTitle()));
 
-	if ( m_multiExport )
+	if ( m_multiExport && onePassCB->isChecked() )
+	{
+		m_renderManager->renderTracksInOnePass(mixerChannelsCB->isChecked());
+	}
+	else if ( m_multiExport )
 	{
 		m_renderManager->renderTracks();
 	}
@@ -33,6 +33,7 @@
 #include <QScrollArea>
 
 #include "AudioEngine.h"
+#include "CpuMeter.h"
 #include "embed.h"
 #include "Engine.h"
 #include "FileDialog.h"
@@ -139,6 +140,14 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 			"ui", "vstalwaysontop").toInt()),
 	m_disableAutoQuit(ConfigManager::inst()->value(
 			"ui", "disableautoquit", "1").toInt()),
+	m_remotePipelining(ConfigManager::inst()->value(
+			"audioengine", "remotepipelining").toInt()),
+	m_workStealing(ConfigManager::inst()->value(
+			"audioengine", "workstealing", "1").toInt()),
+	m_cpuMeters(ConfigManager::inst()->value(
+			"audioengine", "cpumeters").toInt()),
+	m_voiceSheddingQuality(ConfigManager::inst()->value(
+			"audioengine", "voicesheddingquality", "1").toInt()),
 	m_NaNHandler(ConfigManager::inst()->value(
 			"app", "nanhandler", "1").toInt()),
 	m_bufferSize(ConfigManager::inst()->value(
@@ -449,11 +458,50 @@ SetupDialog::SetupDialog(ConfigTab tab_to_open) :
 	addCheckBox(tr("Keep effects running even without input"), pluginsBox, pluginsLayout,
 		m_disableAutoQuit, SLOT(toggleDisableAutoQuit(bool)), false);
 
+	addCheckBox(tr("Run bridged plugins in parallel (adds one period of latency)"), pluginsBox, pluginsLayout,
+		m_remotePipelining, SLOT(toggleRemotePipelining(bool)), true);
+
+	m_remotePipeliningWarnLbl = new QLabel(tr("Warning: bridged plugins will play one period later than all other "
+		"tracks. This delay is not compensated, so they drift out of phase with the rest of the song."), pluginsBox);
+	m_remotePipeliningWarnLbl->setWordWrap(true);
+	m_remotePipeliningWarnLbl->setVisible(m_remotePipelining);
+	pluginsLayout->addWidget(m_remotePipeliningWarnLbl);
+
+
+	// Audio engine group
+	QGroupBox * audioEngineBox = new QGroupBox(tr("Audio engine"), performance_w);
+	QVBoxLayout * audioEngineLayout = new QVBoxLayout(audioEngineBox);
+
+	addCheckBox(tr("Let idle worker threads steal jobs from busy ones"), audioEngineBox, audioEngineLayout,
+		m_workStealing, SLOT(toggleWorkStealing(bool)), true);
+
+	addCheckBox(tr("Measure CPU usage of instruments, effects and mixer channels"), audioEngineBox,
+		audioEngineLayout, m_cpuMeters, SLOT(toggleCpuMeters(bool)), false);
+
+	audioEngineLayout->addWidget(new QLabel{tr("When running out of CPU time:"), audioEngineBox});
+
+	m_voiceSheddingComboBox = new QComboBox{audioEngineBox};
+	m_voiceSheddingComboBox->addItem(tr("Fade out releasing notes"),
+		VoiceGovernor::policyName(VoiceGovernor::Policy::FadeReleasing));
+	m_voiceSheddingComboBox->addItem(tr("Fade out releasing, then old and quiet notes"),
+		VoiceGovernor::policyName(VoiceGovernor::Policy::StealVoices));
+	m_voiceSheddingComboBox->addItem(tr("Skip new notes"),
+		VoiceGovernor::policyName(VoiceGovernor::Policy::DropNew));
+	m_voiceSheddingComboBox->addItem(tr("Do nothing"),
+		VoiceGovernor::policyName(VoiceGovernor::Policy::Off));
+	m_voiceSheddingComboBox->setCurrentIndex(m_voiceSheddingComboBox->findData(
+		VoiceGovernor::policyName(Engine::audioEngine()->voiceGovernor().policy())));
+	audioEngineLayout->addWidget(m_voiceSheddingComboBox);
+
+	addCheckBox(tr("Use cheaper interpolation for new notes when running out of CPU time"), audioEngineBox,
+		audioEngineLayout, m_voiceSheddingQuality, SLOT(toggleVoiceSheddingQuality(bool)), false);
+
 
 	// Performance layout ordering.
 	performance_layout->addWidget(autoSaveBox);
 	performance_layout->addWidget(uiFxBox);
 	performance_layout->addWidget(pluginsBox);
+	performance_layout->addWidget(audioEngineBox);
 	performance_layout->addStretch();
 
 
@@ -1008,6 +1056,20 @@ void SetupDialog::accept()
 					QString::number(m_vstAlwaysOnTop));
 	ConfigManager::inst()->setValue("ui", "disableautoquit",
 					QString::number(m_disableAutoQuit));
+	ConfigManager::inst()->setValue("audioengine", "remotepipelining",
+					QString::number(m_remotePipelining));
+	ConfigManager::inst()->setValue("audioengine", "workstealing",
+					QString::number(m_workStealing));
+	ConfigManager::inst()->setValue("audioengine", "cpumeters",
+					QString::number(m_cpuMeters));
+	// takes effect right away
+	CpuMeter::setEnabled(m_cpuMeters);
+	const auto voiceShedding = m_voiceSheddingComboBox->currentData().toString();
+	ConfigManager::inst()->setValue("audioengine", "voiceshedding", voiceShedding);
+	ConfigManager::inst()->setValue("audioengine", "voicesheddingquality",
+					QString::number(m_voiceSheddingQuality));
+	Engine::audioEngine()->voiceGovernor().setPolicy(VoiceGovernor::policyFromName(voiceShedding));
+	Engine::audioEngine()->voiceGovernor().setReducedQualityAllowed(m_voiceSheddingQuality);
 	ConfigManager::inst()->setValue("audioengine", "audiodev",
 					m_audioIfaceNames[m_audioInterfaces->currentText()]);
 	ConfigManager::inst()->setValue("app", "nanhandler",
@@ -1214,6 +1276,31 @@ void SetupDialog::toggleDisableAutoQuit(bool enabled)
 	m_disableAutoQuit = enabled;
 }
 
+
+void SetupDialog::toggleRemotePipelining(bool enabled)
+{
+	m_remotePipelining = enabled;
+	m_remotePipeliningWarnLbl->setVisible(enabled);
+}
+
+
+void SetupDialog::toggleWorkStealing(bool enabled)
+{
+	m_workStealing = enabled;
+}
+
+
+void SetupDialog::toggleCpuMeters(bool enabled)
+{
+	m_cpuMeters = enabled;
+}
+
+
+void SetupDialog::toggleVoiceSheddingQuality(bool enabled)
+{
+	m_voiceSheddingQuality = enabled;
+}
+
 void SetupDialog::audioInterfaceChanged(const QString & iface)
 {
 	for(AswMap::iterator it = m_audioIfaceSetupWidgets.begin();
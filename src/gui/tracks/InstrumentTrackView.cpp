@@ -231,6 +231,7 @@ void InstrumentTrackView::createMixerLine()
 	auto channel = Engine::mixer()->mixerChannel(channelIndex);
 
 	channel->m_name = getTrack()->name();
+	channel->setTraceName(channel->m_name);
 	channel->setColor(getTrack()->color());
 
 	assignMixerLine(channelIndex);
@@ -31,6 +31,7 @@
 #include "CPULoadWidget.h"
 #include "embed.h"
 #include "Engine.h"
+#include "NotePlayHandle.h"
 
 
 namespace lmms::gui
@@ -98,12 +99,16 @@ void CPULoadWidget::updateCpuLoad()
 	if (new_load != m_currentLoad)
 	{
 		auto engine = Engine::audioEngine();
+		const auto nphStats = NotePlayHandleManager::statistics();
+		const auto& governor = engine->voiceGovernor();
 		setToolTip(
 			tr("DSP total: %1%").arg(new_load) + "\n"
 			+ tr(" - Notes and setup: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::NoteSetup)) + "\n"
-			+ tr(" - Instruments: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Instruments)) + "\n"
-			+ tr(" - Effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Effects)) + "\n"
-			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing))
+			+ tr(" - Instruments and effects: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Processing)) + "\n"
+			+ tr(" - Mixing: %1%").arg(engine->detailLoad(AudioEngineProfiler::DetailType::Mixing)) + "\n"
+			+ tr("Note play handles: %1 of %2 in use").arg(nphStats.inUse).arg(nphStats.allocated) + "\n"
+			+ tr("Notes shed: %1 releasing, %2 sustained, %3 skipped")
+				.arg(governor.fadedVoices()).arg(governor.stolenVoices()).arg(governor.rejectedVoices())
 		);
 		m_currentLoad = new_load;
 		m_changed = true;
@@ -23,6 +23,8 @@
  */
 #include "InstrumentTrack.h"
 
+#include <algorithm>
+
 #include "AudioEngine.h"
 #include "AutomationClip.h"
 #include "ConfigManager.h"
@@ -270,11 +272,13 @@ void InstrumentTrack::processAudioBuffer( SampleFrame* buf, const fpp_t frames,
 		const float vol = ( (float) n->getVolume() * DefaultVolumeRatio );
 		const panning_t pan = std::clamp(n->getPanning(), PanningLeft, PanningRight);
 		StereoVolumeVector vv = panningToVolumeVector( pan, vol );
+		const bool fadingOut = n->isFadingOut();
 		for( f_cnt_t f = offset; f < frames; ++f )
 		{
+			const float fade = fadingOut ? n->fadeOutGain( f - offset ) : 1.0f;
 			for( int c = 0; c < 2; ++c )
 			{
-				buf[f][c] *= vv.vol[c];
+				buf[f][c] *= vv.vol[c] * fade;
 			}
 		}
 	}
@@ -582,7 +586,10 @@ void InstrumentTrack::playNote( NotePlayHandle* n, SampleFrame* workingBuffer )
 	if( n->isMasterNote() == false && m_instrument != nullptr )
 	{
 		// all is done, so now lets play the note!
-		m_instrument->playNote( n, workingBuffer );
+		{
+			const auto meterScope = CpuMeter::Scope{m_instrument->cpuMeter()};
+			m_instrument->playNote( n, workingBuffer );
+		}
 
 		// This is effectively the same as checking if workingBuffer is not a nullptr.
 		// Calling processAudioBuffer with a nullptr leads to crashes. Hence the check.
@@ -638,7 +645,7 @@ void InstrumentTrack::updateBaseNote()
 	Engine::audioEngine()->requestChangeInModel();
 	for (const auto& processHandle : m_processHandles)
 	{
-		processHandle->setFrequencyUpdate();
+		processHandle->updateFrequency();
 	}
 	Engine::audioEngine()->doneChangeInModel();
 }
@@ -754,33 +761,9 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 			cur_start -= c->startPosition() + c->startTimeOffset();
 		}
 
-		// get all notes from the given clip...
-		const NoteVector & notes = c->notes();
-		// ...and set our index to zero
-		auto nit = notes.begin();
-
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
-
-		if( cur_start > 0 )
+		const auto playNote = [&](Note* currentNote)
 		{
-			// skip notes which end before start-bar
-			while( nit != notes.end() && ( *nit )->endPos() < cur_start )
-			{
-				++nit;
-			}
-		}
-
-		while (nit != notes.end() && (*nit)->pos() < c->length() - c->startTimeOffset())
-		{
-			const auto currentNote = *nit;
-			// Skip any notes note at the current time pos or not overlapping with the start.
-			if (!(currentNote->pos() == cur_start
-				|| (cur_start == -c->startTimeOffset() && (*nit)->pos() < cur_start && (*nit)->endPos() > cur_start)))
-			{
-				++nit;
-				continue;
-			}
+			if (currentNote->pos() >= c->length() - c->startTimeOffset()) { return; }
 
 			// Calculate the overlap of the note over the clip end.
 			const auto noteOverlap = std::max(0, currentNote->endPos() - (c->length() - c->startTimeOffset()));
@@ -802,8 +785,25 @@ bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 
 			Engine::audioEngine()->addPlayHandle( notePlayHandle );
 			played_a_note = true;
-			++nit;
+		};
+
+		// The notes are sorted by position, so only the ones starting at
+		// cur_start need to be looked at. Only at the start of the clip we
+		// also play the notes which began before it and are still sounding.
+		const NoteVector & notes = c->notes();
+		const auto notesBegin = std::lower_bound(notes.begin(), notes.end(), cur_start,
+			[](const Note* note, const TimePos& pos) { return note->pos() < pos; });
+		const auto notesEnd = std::upper_bound(notesBegin, notes.end(), cur_start,
+			[](const TimePos& pos, const Note* note) { return pos < note->pos(); });
+
+		if (cur_start == -c->startTimeOffset())
+		{
+			for (auto nit = notes.begin(); nit != notesBegin; ++nit)
+			{
+				if ((*nit)->endPos() > cur_start) { playNote(*nit); }
+			}
 		}
+		std::for_each(notesBegin, notesEnd, playNote);
 	}
 	unlock();
 	return played_a_note;
@@ -200,6 +200,44 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 
 
 
+NoteVector MidiClip::addNotes(const std::vector<Note>& notes, const bool quantPos)
+{
+	auto newNotes = NoteVector{};
+	if (notes.empty()) { return newNotes; }
+
+	const bool quantize = quantPos && gui::getGUI()->pianoRoll();
+	newNotes.reserve(notes.size());
+	for (const auto& note : notes)
+	{
+		auto newNote = note.clone();
+		if (quantize)
+		{
+			newNote->quantizePos(gui::getGUI()->pianoRoll()->quantization());
+		}
+		newNotes.push_back(newNote);
+	}
+
+	auto sortedNotes = newNotes;
+	std::stable_sort(sortedNotes.begin(), sortedNotes.end(), Note::lessThan);
+
+	instrumentTrack()->lock();
+	const auto oldCount = static_cast<NoteVector::difference_type>(m_notes.size());
+	m_notes.insert(m_notes.end(), sortedNotes.begin(), sortedNotes.end());
+	// stable, so new notes end up behind existing equal ones like with addNote()
+	std::inplace_merge(m_notes.begin(), m_notes.begin() + oldCount, m_notes.end(), Note::lessThan);
+	instrumentTrack()->unlock();
+
+	checkType();
+	updateLength();
+
+	emit dataChanged();
+
+	return newNotes;
+}
+
+
+
+
 NoteVector::const_iterator MidiClip::removeNote(NoteVector::const_iterator it)
 {
 	instrumentTrack()->lock();
@@ -335,6 +373,7 @@ void MidiClip::splitNotes(const NoteVector& notes, TimePos pos)
 
 	addJournalCheckPoint();
 
+	std::vector<Note> newNotes;
 	for (const auto& note : notes)
 	{
 		int leftLength = pos.getTicks() - note->pos();
@@ -354,8 +393,10 @@ void MidiClip::splitNotes(const NoteVector& notes, TimePos pos)
 		newNote.setLength(rightLength);
 		newNote.setPos(note->pos() + leftLength);
 
-		addNote(newNote, false);
+		newNotes.push_back(newNote);
 	}
+
+	addNotes(newNotes, false);
 }
 
 void MidiClip::splitNotesAlongLine(const NoteVector notes, TimePos pos1, int key1, TimePos pos2, int key2, bool deleteShortEnds)
@@ -370,6 +411,7 @@ void MidiClip::splitNotesAlongLine(const NoteVector notes, TimePos pos1, int key
 	const auto slope = 1.f * (pos2 - pos1) / (key2 - key1);
 	const auto& [minKey, maxKey] = std::minmax(key1, key2);
 
+	std::vector<Note> newNotes;
 	for (const auto& note : notes)
 	{
 		// Skip if the key is <= to minKey, since the line is drawn from the top of minKey to the top of maxKey, but only passes through maxKey - minKey - 1 total keys.
@@ -388,17 +430,19 @@ void MidiClip::splitNotesAlongLine(const NoteVector notes, TimePos pos1, int key
 
 			if (deleteShortEnds)
 			{
-				addNote(newNote1.length() >= newNote2.length() ? newNote1 : newNote2, false);
+				newNotes.push_back(newNote1.length() >= newNote2.length() ? newNote1 : newNote2);
 			}
 			else
 			{
-				addNote(newNote1, false);
-				addNote(newNote2, false);
+				newNotes.push_back(newNote1);
+				newNotes.push_back(newNote2);
 			}
 
 			removeNote(note);
 		}
 	}
+
+	addNotes(newNotes, false);
 }
 
 
@@ -504,6 +548,8 @@ void MidiClip::loadSettings( const QDomElement & _this )
 		}
 		node = node.nextSibling();
         }
+	// playback relies on the notes being sorted
+	rearrangeAllNotes();
 
 	m_steps = _this.attribute( "steps" ).toInt();
 	if( m_steps == 0 )
@@ -0,0 +1,641 @@
+/*
+ * LmmsBench.cpp - headless offline render benchmark
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+/*
+ * Renders projects period by period on the calling thread, the same way
+ * ProjectRenderer drives the engine, and prints a JSON report with the
+ * per-stage times of AudioEngineProfiler, heap allocations per period,
+ * the realtime factor, the CpuMeter of every instrument, effect and mixer
+ * channel and, with --per-track, the cost of each instrument track measured
+ * by rendering it alone.
+ *
+ * Besides project files, four synthetic stress projects can be generated:
+ *   voices      one TripleOscillator track holding --voices notes
+ *   mixer       --channels mixer channels with an effect chain each, fed
+ *               by one TripleOscillator track per channel
+ *   automation  a TripleOscillator chord whose volume and panning follow
+ *               automation clips with --nodes nodes each
+ *   noise       --channels TripleOscillator tracks playing white noise, so
+ *               several worker threads draw random numbers at the same time
+ *
+ * With --insert-notes, the time it takes to fill a MidiClip note by note is
+ * compared with one MidiClip::addNotes() call. The notes come in the order a
+ * MIDI file delivers them, i.e. by time with many channels interleaved.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "AudioDummy.h"
+#include "AudioEngine.h"
+#include "AudioEngineProfiler.h"
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "ConfigManager.h"
+#include "CpuMeter.h"
+#include "Effect.h"
+#include "Engine.h"
+#include "Instrument.h"
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "Mixer.h"
+#include "Note.h"
+#include "Oscillator.h"
+#include "PatternStore.h"
+#include "ProjectJournal.h"
+#include "Song.h"
+#include "denormals.h"
+#include "lmmsversion.h"
+
+namespace
+{
+
+// Every heap allocation of the process, including the worker threads
+std::atomic<std::uint64_t> s_allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size != 0 ? size : 1)) { return p; }
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+
+namespace
+{
+
+using namespace lmms;
+using DetailType = AudioEngineProfiler::DetailType;
+
+struct Options
+{
+	int periods = 2000;
+	int warmup = 100;
+	int voices = 64;
+	int channels = 16;
+	int nodes = 10000;
+	int bars = 16;
+	int insertNotes = 0;
+	bool perTrack = false;
+};
+
+
+struct RenderResult
+{
+	std::vector<int> periodTimes;
+	std::array<std::int64_t, AudioEngineProfiler::DetailCount> detailTotals{};
+	std::uint64_t allocations = 0;
+	double wallSeconds = 0;
+};
+
+
+//! Renders `periods` periods after `warmup` periods, restarting the song whenever it ends
+RenderResult render(const Options& options, int periods)
+{
+	auto audioEngine = Engine::audioEngine();
+	auto song = Engine::getSong();
+	const auto& profiler = audioEngine->profiler();
+
+	RenderResult result;
+	result.periodTimes.reserve(periods);
+
+	song->startExport();
+	for (int i = 0; i < options.warmup; ++i)
+	{
+		audioEngine->nextBuffer();
+		if (song->isExportDone()) { song->startExport(); }
+	}
+
+	CpuMeter::resetAll();
+	const auto allocationsBefore = s_allocations.load(std::memory_order_relaxed);
+	const auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < periods; ++i)
+	{
+		audioEngine->nextBuffer();
+
+		result.periodTimes.push_back(profiler.periodTime());
+		for (std::size_t d = 0; d < AudioEngineProfiler::DetailCount; ++d)
+		{
+			result.detailTotals[d] += profiler.detailTime(static_cast<DetailType>(d));
+		}
+
+		if (song->isExportDone()) { song->startExport(); }
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	// the vector was reserved up front, so nothing of the harness is counted here
+	result.allocations = s_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+	result.wallSeconds = std::chrono::duration<double>(end - start).count();
+
+	song->stopExport();
+	return result;
+}
+
+
+double mean(const std::vector<int>& values)
+{
+	if (values.empty()) { return 0; }
+	std::int64_t sum = 0;
+	for (const auto value : values) { sum += value; }
+	return static_cast<double>(sum) / values.size();
+}
+
+
+int percentile(std::vector<int> values, double p)
+{
+	if (values.empty()) { return 0; }
+	const auto n = static_cast<std::size_t>(p * (values.size() - 1));
+	std::nth_element(values.begin(), values.begin() + n, values.end());
+	return values[n];
+}
+
+
+QJsonObject report(const RenderResult& result, int periods)
+{
+	const auto audioEngine = Engine::audioEngine();
+	const double audioSeconds = static_cast<double>(periods) * audioEngine->framesPerPeriod()
+		/ audioEngine->outputSampleRate();
+
+	QJsonObject period;
+	period["meanUs"] = mean(result.periodTimes);
+	period["p99Us"] = percentile(result.periodTimes, 0.99);
+	period["maxUs"] = result.periodTimes.empty()
+		? 0 : *std::max_element(result.periodTimes.begin(), result.periodTimes.end());
+
+	const auto stageMean = [&](DetailType type) {
+		return periods > 0 ? static_cast<double>(result.detailTotals[static_cast<std::size_t>(type)]) / periods : 0.;
+	};
+	QJsonObject stages;
+	stages["noteSetupUs"] = stageMean(DetailType::NoteSetup);
+	stages["processingUs"] = stageMean(DetailType::Processing);
+	stages["mixingUs"] = stageMean(DetailType::Mixing);
+
+	QJsonObject object;
+	object["periods"] = periods;
+	object["audioSeconds"] = audioSeconds;
+	object["wallSeconds"] = result.wallSeconds;
+	object["realtimeFactor"] = result.wallSeconds > 0 ? audioSeconds / result.wallSeconds : 0.;
+	object["allocationsPerPeriod"] = periods > 0 ? static_cast<double>(result.allocations) / periods : 0.;
+	object["period"] = period;
+	object["stages"] = stages;
+	return object;
+}
+
+
+QJsonObject meterReport(const QString& name, const CpuMeter& meter)
+{
+	QJsonObject object;
+	object["name"] = name;
+	object["averageLoad"] = meter.averageLoad();
+	object["worstLoad"] = meter.worstLoad();
+	object["totalUs"] = static_cast<double>(meter.totalTime());
+	return object;
+}
+
+
+QJsonObject cpuMeters()
+{
+	const auto effectMeters = [](const EffectChain* chain) {
+		QJsonArray effects;
+		if (!chain) { return effects; }
+		for (const auto effect : chain->effects())
+		{
+			effects.append(meterReport(effect->displayName(), effect->cpuMeter()));
+		}
+		return effects;
+	};
+
+	QJsonArray instruments;
+	for (const auto& tracks : {Engine::getSong()->tracks(), Engine::patternStore()->tracks()})
+	{
+		for (const auto track : tracks)
+		{
+			const auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track);
+			if (!instrumentTrack || !instrumentTrack->instrument()) { continue; }
+
+			auto instrument = meterReport(instrumentTrack->name(), instrumentTrack->instrument()->cpuMeter());
+			instrument["instrument"] = instrumentTrack->instrumentName();
+			instrument["effects"] = effectMeters(instrumentTrack->audioBusHandle()->effects());
+			instruments.append(instrument);
+		}
+	}
+
+	QJsonArray channels;
+	const auto mixer = Engine::mixer();
+	for (mix_ch_t i = 0; i < mixer->numChannels(); ++i)
+	{
+		const auto channel = mixer->mixerChannel(i);
+		auto object = meterReport(channel->m_name, channel->m_cpuMeter);
+		object["effects"] = effectMeters(&channel->m_fxChain);
+		channels.append(object);
+	}
+
+	QJsonObject meters;
+	meters["instruments"] = instruments;
+	meters["mixerChannels"] = channels;
+	return meters;
+}
+
+
+/*
+ * Renders every instrument track of the song alone and reports its mean period
+ * time minus the one of a run with all tracks muted. This includes the effects
+ * of the track and of the mixer channels it feeds.
+ */
+QJsonArray perTrackCosts(const Options& options)
+{
+	const auto& tracks = Engine::getSong()->tracks();
+
+	std::vector<bool> wasMuted;
+	for (const auto track : tracks)
+	{
+		wasMuted.push_back(track->isMuted());
+		track->setMuted(true);
+	}
+
+	const auto periods = std::max(options.periods / 4, 1);
+	const auto baseline = mean(render(options, periods).periodTimes);
+
+	QJsonArray costs;
+	for (const auto track : tracks)
+	{
+		const auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track);
+		if (!instrumentTrack) { continue; }
+
+		instrumentTrack->setMuted(false);
+		const auto time = mean(render(options, periods).periodTimes);
+		instrumentTrack->setMuted(true);
+
+		QJsonObject cost;
+		cost["track"] = instrumentTrack->name();
+		cost["instrument"] = instrumentTrack->instrumentName();
+		cost["mixerChannel"] = instrumentTrack->mixerChannelModel()->value();
+		cost["costUs"] = time - baseline;
+		costs.append(cost);
+	}
+
+	for (std::size_t i = 0; i < tracks.size(); ++i)
+	{
+		tracks[i]->setMuted(wasMuted[i]);
+	}
+	return costs;
+}
+
+
+InstrumentTrack* createHeldChord(Song* song, int voices, int bars, int lowestKey)
+{
+	auto track = dynamic_cast<InstrumentTrack*>(Track::create(Track::Type::Instrument, song));
+	track->loadInstrument("tripleoscillator");
+
+	auto clip = dynamic_cast<MidiClip*>(track->createClip(TimePos{0}));
+	auto notes = std::vector<Note>{};
+	for (int voice = 0; voice < voices; ++voice)
+	{
+		// spread the voices over four octaves, so they don't all share one key
+		notes.emplace_back(TimePos{bars, 0}, TimePos{0}, lowestKey + (voice * 7) % 48);
+	}
+	clip->addNotes(notes, false);
+	return track;
+}
+
+
+void createVoicesProject(Song* song, const Options& options)
+{
+	createHeldChord(song, options.voices, options.bars, 24);
+}
+
+
+void createMixerProject(Song* song, const Options& options)
+{
+	static const auto effects = std::array{"amplifier", "bassbooster", "stereoenhancer", "delay", "reverbsc"};
+
+	auto mixer = Engine::mixer();
+	for (int i = 0; i < options.channels; ++i)
+	{
+		const auto channel = mixer->createChannel();
+		auto& chain = mixer->mixerChannel(channel)->m_fxChain;
+		for (const auto name : effects)
+		{
+			if (auto effect = Effect::instantiate(name, &chain, nullptr))
+			{
+				chain.appendEffect(effect);
+			}
+			else
+			{
+				std::fprintf(stderr, "Effect %s is not available, skipping it\n", name);
+			}
+		}
+
+		auto track = createHeldChord(song, 4, options.bars, 36 + i % 12);
+		track->mixerChannelModel()->setValue(channel);
+	}
+}
+
+
+void createAutomationProject(Song* song, const Options& options)
+{
+	auto track = createHeldChord(song, 8, options.bars, 36);
+
+	const auto length = TimePos{options.bars, 0}.getTicks();
+	const auto step = std::max(length / std::max(options.nodes, 1), 1);
+
+	auto automate = [&](AutomatableModel* model) {
+		auto automationTrack = Track::create(Track::Type::Automation, song);
+		auto clip = dynamic_cast<AutomationClip*>(automationTrack->createClip(TimePos{0}));
+		clip->setProgressionType(AutomationClip::ProgressionType::CubicHermite);
+		clip->addObject(model);
+		for (int tick = 0, node = 0; tick < length; tick += step, ++node)
+		{
+			// zigzag between both ends of the range, so every segment has to be interpolated
+			clip->putValue(TimePos{tick}, node % 2 ? model->maxValue<float>() : model->minValue<float>(), false);
+		}
+	};
+
+	automate(track->volumeModel());
+	automate(track->panningModel());
+}
+
+
+void createNoiseProject(Song* song, const Options& options)
+{
+	for (int i = 0; i < options.channels; ++i)
+	{
+		auto track = createHeldChord(song, 4, options.bars, 36 + i % 12);
+
+		// TripleOscillator has no public interface, so switch its oscillators through its settings
+		auto instrument = track->instrument();
+		auto doc = QDomDocument{};
+		auto element = doc.createElement("instrument");
+		instrument->saveSettings(doc, element);
+		for (int osc = 0; osc < 3; ++osc)
+		{
+			element.setAttribute(QString("wavetype%1").arg(osc), static_cast<int>(Oscillator::WaveShape::WhiteNoise));
+		}
+		instrument->loadSettings(element);
+	}
+}
+
+
+//! Times filling a clip with `count` notes by MidiClip::addNote() and by MidiClip::addNotes()
+QJsonObject noteInsertion(Song* song, int count)
+{
+	using clock = std::chrono::steady_clock;
+
+	auto notes = std::vector<Note>{};
+	notes.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		// sixteen channels playing sixteenth notes in parallel, each in its own range
+		const auto channel = i % 16;
+		const auto step = i / 16;
+		notes.emplace_back(TimePos{DefaultTicksPerBar / 4}, TimePos{step * DefaultTicksPerBar / 16},
+			24 + channel * 5 + step % 5);
+	}
+
+	song->clearProject();
+	auto track = dynamic_cast<InstrumentTrack*>(Track::create(Track::Type::Instrument, song));
+
+	auto measure = [&](auto insert) {
+		auto clip = dynamic_cast<MidiClip*>(track->createClip(TimePos{0}));
+		const auto allocations = s_allocations.load(std::memory_order_relaxed);
+		const auto start = clock::now();
+		insert(clip);
+		const auto elapsed = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+		auto result = QJsonObject{};
+		result["milliseconds"] = elapsed;
+		result["allocations"] = static_cast<double>(s_allocations.load(std::memory_order_relaxed) - allocations);
+		result["notes"] = static_cast<int>(clip->notes().size());
+		return result;
+	};
+
+	auto result = QJsonObject{};
+	result["count"] = count;
+	result["addNote"] = measure([&](MidiClip* clip) {
+		for (const auto& note : notes) { clip->addNote(note, false); }
+	});
+	result["addNotes"] = measure([&](MidiClip* clip) { clip->addNotes(notes, false); });
+
+	song->clearProject();
+	return result;
+}
+
+
+struct Scenario
+{
+	QString name;
+	void (*create)(Song*, const Options&);
+};
+
+
+const auto s_syntheticScenarios = std::array{
+	Scenario{"voices", createVoicesProject},
+	Scenario{"mixer", createMixerProject},
+	Scenario{"automation", createAutomationProject},
+	Scenario{"noise", createNoiseProject},
+};
+
+
+QJsonObject runScenario(const Options& options)
+{
+	// loop instead of rendering the silent bar after the end
+	Engine::getSong()->setExportLoop(true);
+
+	auto result = report(render(options, options.periods), options.periods);
+	result["cpuMeters"] = cpuMeters();
+	if (options.perTrack)
+	{
+		result["tracks"] = perTrackCosts(options);
+	}
+	return result;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv)
+{
+	using namespace lmms;
+
+	disable_denormals();
+
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("lmms-bench");
+	QCoreApplication::setApplicationVersion(LMMS_VERSION);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Renders projects offline and reports engine timings as JSON.");
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("projects", "Projects to render.", "[project...]");
+
+	const QCommandLineOption periodsOption("periods", "Number of periods to measure.", "n", "2000");
+	const QCommandLineOption warmupOption("warmup", "Number of periods to render before measuring.", "n", "100");
+	const QCommandLineOption syntheticOption("synthetic",
+		"Synthetic project to generate: voices, mixer, automation, noise or all. Can be given several times.", "name");
+	const QCommandLineOption voicesOption("voices", "Notes held in the voices project.", "n", "64");
+	const QCommandLineOption channelsOption("channels", "Mixer channels in the mixer project, tracks in the noise project.", "n", "16");
+	const QCommandLineOption nodesOption("nodes", "Nodes per clip in the automation project.", "n", "10000");
+	const QCommandLineOption barsOption("bars", "Length of the synthetic projects.", "n", "16");
+	const QCommandLineOption perTrackOption("per-track", "Also measure every instrument track on its own.");
+	const QCommandLineOption insertNotesOption("insert-notes",
+		"Measure inserting n notes into a clip one by one and at once.", "n");
+	const QCommandLineOption outputOption({"o", "output"}, "Write the report to a file instead of stdout.", "file");
+	const QCommandLineOption traceOption("trace", "Write a Chrome trace of all audio jobs to a file.", "file");
+	parser.addOptions({periodsOption, warmupOption, syntheticOption, voicesOption, channelsOption,
+		nodesOption, barsOption, perTrackOption, insertNotesOption, outputOption, traceOption});
+	parser.process(app);
+
+	Options options;
+	options.periods = std::max(parser.value(periodsOption).toInt(), 1);
+	options.warmup = std::max(parser.value(warmupOption).toInt(), 0);
+	options.voices = std::max(parser.value(voicesOption).toInt(), 1);
+	options.channels = std::max(parser.value(channelsOption).toInt(), 1);
+	options.nodes = std::max(parser.value(nodesOption).toInt(), 2);
+	options.bars = std::max(parser.value(barsOption).toInt(), 1);
+	options.perTrack = parser.isSet(perTrackOption);
+	options.insertNotes = std::max(parser.value(insertNotesOption).toInt(), 0);
+
+	auto synthetic = parser.values(syntheticOption);
+	if (synthetic.contains("all"))
+	{
+		synthetic.clear();
+		for (const auto& scenario : s_syntheticScenarios) { synthetic << scenario.name; }
+	}
+	const auto projects = parser.positionalArguments();
+	if (projects.isEmpty() && synthetic.isEmpty() && options.insertNotes == 0)
+	{
+		std::fprintf(stderr, "Nothing to render, give a project, --synthetic or --insert-notes\n");
+		return EXIT_FAILURE;
+	}
+
+	ConfigManager::inst()->loadConfigFile();
+	Engine::init(true);
+
+	// Drive the engine from this thread, without the fifo writer of the dummy device
+	bool success = false;
+	auto audioEngine = Engine::audioEngine();
+	audioEngine->setAudioDevice(new AudioDummy(success, audioEngine), false, false);
+
+	auto song = Engine::getSong();
+	Engine::projectJournal()->setJournalling(false);
+
+	CpuMeter::setEnabled(true);
+
+	if (parser.isSet(traceOption))
+	{
+		audioEngine->profiler().setTraceFile(parser.value(traceOption));
+	}
+
+	QJsonArray results;
+	for (const auto& name : synthetic)
+	{
+		const auto scenario = std::find_if(s_syntheticScenarios.begin(), s_syntheticScenarios.end(),
+			[&](const Scenario& s) { return s.name == name; });
+		if (scenario == s_syntheticScenarios.end())
+		{
+			std::fprintf(stderr, "Unknown synthetic project %s\n", qUtf8Printable(name));
+			return EXIT_FAILURE;
+		}
+
+		song->clearProject();
+		scenario->create(song, options);
+
+		auto result = runScenario(options);
+		result["name"] = name;
+		result["synthetic"] = true;
+		results.append(result);
+	}
+
+	for (const auto& project : projects)
+	{
+		song->loadProject(project);
+		if (song->isEmpty())
+		{
+			std::fprintf(stderr, "The project %s is empty, skipping it\n", qUtf8Printable(project));
+			continue;
+		}
+
+		auto result = runScenario(options);
+		result["name"] = project;
+		result["synthetic"] = false;
+		results.append(result);
+	}
+
+	QJsonObject root;
+	root["version"] = LMMS_VERSION;
+	root["sampleRate"] = static_cast<int>(audioEngine->outputSampleRate());
+	root["framesPerPeriod"] = static_cast<int>(audioEngine->framesPerPeriod());
+	root["warmupPeriods"] = options.warmup;
+	root["results"] = results;
+	if (options.insertNotes > 0)
+	{
+		root["noteInsertion"] = noteInsertion(song, options.insertNotes);
+	}
+
+	const auto json = QJsonDocument{root}.toJson();
+	if (parser.isSet(outputOption))
+	{
+		QFile file(parser.value(outputOption));
+		if (!file.open(QFile::WriteOnly | QFile::Truncate))
+		{
+			std::fprintf(stderr, "Could not open %s for writing\n", qUtf8Printable(file.fileName()));
+			return EXIT_FAILURE;
+		}
+		file.write(json);
+	}
+	else
+	{
+		std::fwrite(json.constData(), 1, json.size(), stdout);
+	}
+
+	song->clearProject();
+	Engine::destroy();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+/*
+ * BasicFiltersTest.cpp
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BasicFilters.h"
+
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "RandomFrames.h"
+#include "SampleFrame.h"
+
+using namespace lmms;
+
+// process() of the filter classes has to give the same results as calling
+// update() for both channels of every frame, the benchmark times both.
+class BasicFiltersTest : public QObject
+{
+	Q_OBJECT
+public:
+	static constexpr int Frames = 512;
+	static constexpr auto SampleRate = sample_rate_t{44100};
+
+	BasicFiltersTest() :
+		m_input(test::randomFrames(Frames, 1.f, 1))
+	{
+		// the channels fall silent at different frames, so the filters decay
+		// into the shortcut OnePole takes for silence
+		for (int f = 128; f < Frames; ++f)
+		{
+			m_input[f][0] = 0.f;
+			m_input[f][1] = f < 160 ? m_input[f][1] : 0.f;
+		}
+	}
+
+private:
+	//! Filters the input once by `update()` and once by `process()` and compares both
+	template<class Filter>
+	void compare(Filter& expectedFilter, Filter& actualFilter)
+	{
+		auto expected = m_input;
+		for (auto& frame : expected)
+		{
+			frame[0] = expectedFilter.update(frame[0], 0);
+			frame[1] = expectedFilter.update(frame[1], 1);
+		}
+
+		auto actual = m_input;
+		actualFilter.process(actual.data(), actual.data(), Frames);
+
+		// this file is built without FMA contraction (see tests/CMakeLists.txt), which
+		// would round update() differently than the SIMD code
+		for (int f = 0; f < Frames; ++f)
+		{
+			QVERIFY2(std::abs(actual[f][0] - expected[f][0]) <= 1e-6f
+				&& std::abs(actual[f][1] - expected[f][1]) <= 1e-6f,
+				qPrintable(QString{"frame %1"}.arg(f)));
+		}
+	}
+
+	//! Calls `fn` with a new filter of the class with the given index, set up to do something audible
+	template<class Fn>
+	static void withFilter(int filter, Fn fn)
+	{
+		switch (filter)
+		{
+			case 0:
+			{
+				auto biQuad = StereoBiQuad{};
+				// a resonant low-pass at about 1 kHz
+				biQuad.setCoeffs(-1.8f, 0.82f, 0.005f, 0.01f, 0.005f);
+				fn(biQuad);
+				break;
+			}
+			case 1:
+			{
+				auto onePole = StereoOnePole{};
+				onePole.setCoeffs(0.1f, 0.9f);
+				fn(onePole);
+				break;
+			}
+			default:
+			{
+				auto linkwitzRiley = StereoLinkwitzRiley(SampleRate);
+				linkwitzRiley.setLowpass(500.f);
+				fn(linkwitzRiley);
+				break;
+			}
+		}
+	}
+
+	static constexpr const char* FilterNames[] = {"BiQuad", "OnePole", "LinkwitzRiley"};
+
+	std::vector<SampleFrame> m_input;
+
+private slots:
+	void filterTest_data()
+	{
+		QTest::addColumn<int>("filter");
+		for (int filter = 0; filter < 3; ++filter)
+		{
+			QTest::newRow(FilterNames[filter]) << filter;
+		}
+	}
+
+	void filterTest()
+	{
+		QFETCH(int, filter);
+		withFilter(filter, [this](auto& expected) {
+			auto actual = expected;
+			compare(expected, actual);
+		});
+	}
+
+	void basicFiltersTest_data()
+	{
+		QTest::addColumn<int>("type");
+		for (int type = 0; type <= static_cast<int>(BasicFilters<>::FilterType::Tripole); ++type)
+		{
+			QTest::newRow(qPrintable(QString::number(type))) << type;
+		}
+	}
+
+	void basicFiltersTest()
+	{
+		QFETCH(int, type);
+
+		// BasicFilters owns its sub filter, so it must not be copied
+		auto expected = BasicFilters<>{SampleRate};
+		auto actual = BasicFilters<>{SampleRate};
+		for (auto filter : {&expected, &actual})
+		{
+			filter->setFilterType(static_cast<BasicFilters<>::FilterType>(type));
+			filter->calcFilterCoeffs(800.f, 2.f);
+		}
+		compare(expected, actual);
+	}
+
+	void interpolatedCoeffsTest_data()
+	{
+		QTest::addColumn<int>("type");
+		for (auto type : {BasicFilters<>::FilterType::LowPass, BasicFilters<>::FilterType::HiPass,
+			BasicFilters<>::FilterType::BandPass_CSG, BasicFilters<>::FilterType::BandPass_CZPG,
+			BasicFilters<>::FilterType::Notch, BasicFilters<>::FilterType::AllPass,
+			BasicFilters<>::FilterType::DoubleLowPass})
+		{
+			QTest::newRow(qPrintable(QString::number(static_cast<int>(type)))) << static_cast<int>(type);
+		}
+	}
+
+	//! In a fast cutoff sweep, coefficients calculated every 16 frames and interpolated in between
+	//! have to be much closer to calculating them for every frame than updating them in steps
+	void interpolatedCoeffsTest()
+	{
+		QFETCH(int, type);
+		constexpr int Block = 16;
+		const auto cutoff = [](int frame) { return 200.f * std::exp2(5.f * frame / (Frames - 1)); };
+
+		auto perFrame = BasicFilters<>{SampleRate};
+		auto stepped = BasicFilters<>{SampleRate};
+		auto interpolated = BasicFilters<>{SampleRate};
+		for (auto filter : {&perFrame, &stepped, &interpolated})
+		{
+			filter->setFilterType(static_cast<BasicFilters<>::FilterType>(type));
+			filter->calcFilterCoeffs(cutoff(0), 2.f);
+		}
+		QVERIFY(interpolated.isBiQuad());
+
+		auto expected = m_input;
+		for (int f = 0; f < Frames; ++f)
+		{
+			perFrame.calcFilterCoeffs(cutoff(f), 2.f);
+			expected[f][0] = perFrame.update(expected[f][0], 0);
+			expected[f][1] = perFrame.update(expected[f][1], 1);
+		}
+
+		auto steppedOutput = m_input;
+		auto interpolatedOutput = m_input;
+		for (int block = 0; block < Frames; block += Block)
+		{
+			const int frames = std::min(Block, Frames - block);
+			stepped.calcFilterCoeffs(cutoff(block), 2.f);
+			stepped.process(steppedOutput.data() + block, steppedOutput.data() + block, frames);
+
+			const int end = std::min(block + Block, Frames - 1);
+			interpolated.processInterpolated(interpolatedOutput.data() + block, interpolatedOutput.data() + block,
+				frames, end - block, cutoff(end), 2.f);
+		}
+
+		const auto maxError = [&](const std::vector<SampleFrame>& actual) {
+			auto error = 0.f;
+			for (int f = 0; f < Frames; ++f)
+			{
+				error = std::max({error, std::abs(actual[f][0] - expected[f][0]), std::abs(actual[f][1] - expected[f][1])});
+			}
+			return error;
+		};
+		const float steppedError = maxError(steppedOutput);
+		const float interpolatedError = maxError(interpolatedOutput);
+		// about 20 to 35 times smaller for all types
+		QVERIFY2(interpolatedError * 10 <= steppedError,
+			qPrintable(QString{"interpolated %1, stepped %2"}.arg(interpolatedError).arg(steppedError)));
+	}
+
+	void benchmark_data()
+	{
+		QTest::addColumn<int>("filter");
+		QTest::addColumn<bool>("block");
+		for (int filter = 0; filter < 3; ++filter)
+		{
+			QTest::newRow(qPrintable(QString{"%1/update"}.arg(FilterNames[filter]))) << filter << false;
+			QTest::newRow(qPrintable(QString{"%1/process"}.arg(FilterNames[filter]))) << filter << true;
+		}
+	}
+
+	void benchmark()
+	{
+		QFETCH(int, filter);
+		QFETCH(bool, block);
+		withFilter(filter, [&](auto& f) {
+			auto buffer = m_input;
+			QBENCHMARK
+			{
+				if (block)
+				{
+					f.process(buffer.data(), buffer.data(), Frames);
+				}
+				else
+				{
+					for (auto& frame : buffer)
+					{
+						frame[0] = f.update(frame[0], 0);
+						frame[1] = f.update(frame[1], 1);
+					}
+				}
+			}
+		});
+	}
+};
+
+QTEST_GUILESS_MAIN(BasicFiltersTest)
+#include "BasicFiltersTest.moc"
@@ -22,6 +22,9 @@
  *
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <QObject>
 #include <QtTest>
 
@@ -47,6 +50,28 @@ private slots:
 		QCOMPARE(numDigitsAsInt(900000000), 9);
 		QCOMPARE(numDigitsAsInt(-900000000), 10);
 	}
+
+	void RandomGeneratorTest()
+	{
+		using namespace lmms;
+		auto random = RandomGenerator{1};
+		for (int i = 0; i < 10000; ++i)
+		{
+			const auto unipolar = random.unipolar();
+			QVERIFY(unipolar >= 0.f && unipolar < 1.f);
+			const auto bipolar = random.bipolar();
+			QVERIFY(bipolar >= -1.f && bipolar < 1.f);
+			QVERIFY(fastRand() <= 32767);
+		}
+
+		// a length which is not a multiple of the lanes must still be filled completely
+		auto block = std::vector<float>(1003, 2.f);
+		random.fillBipolar(block.data(), block.size());
+		QVERIFY(std::all_of(block.begin(), block.end(), [](float x) { return x >= -1.f && x < 1.f; }));
+
+		QVERIFY(RandomGenerator{1}.next() == RandomGenerator{1}.next());
+		QVERIFY(RandomGenerator{1}.next() != RandomGenerator{2}.next());
+	}
 };
 
 QTEST_GUILESS_MAIN(MathTest)
@@ -0,0 +1,221 @@
+/*
+ * MixHelpersTest.cpp
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpers.h"
+
+#include <QObject>
+#include <QtTest>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "RandomFrames.h"
+#include "SampleFrame.h"
+#include "ValueBuffer.h"
+#include "denormals.h"
+
+using namespace lmms;
+using MixHelpers::Isa;
+
+// Compares every vectorized kernel against the scalar one. Run with
+// "-iterations N" or "-tickcounter" to get meaningful benchmark numbers.
+class MixHelpersTest : public QObject
+{
+	Q_OBJECT
+public:
+	// odd, so that the scalar tail of the kernels is tested as well
+	static constexpr int Frames = 263;
+
+	MixHelpersTest() :
+		m_src(test::randomFrames(Frames, 2.f, 1)),
+		m_dst(test::randomFrames(Frames, 2.f, 2)),
+		m_coeffs1(Frames),
+		m_coeffs2(Frames)
+	{
+		// the two channels of a third signal
+		const auto coeffs = test::randomFrames(Frames, 2.f, 3);
+		for (int f = 0; f < Frames; ++f)
+		{
+			m_coeffs1[f] = coeffs[f][0];
+			m_coeffs2[f] = coeffs[f][1];
+		}
+	}
+
+private:
+	using Kernel = std::function<void(SampleFrame* dst)>;
+
+	std::vector<std::pair<const char*, Kernel>> kernels()
+	{
+		const auto* src = m_src.data();
+		auto* coeffs1 = &m_coeffs1;
+		auto* coeffs2 = &m_coeffs2;
+		return {
+			{ "add", [=](SampleFrame* dst) { MixHelpers::add(dst, src, Frames); } },
+			{ "multiply", [=](SampleFrame* dst) { MixHelpers::multiply(dst, 0.7f, Frames); } },
+			{ "multiplyStereo", [=](SampleFrame* dst) { MixHelpers::multiplyStereo(dst, 0.7f, 0.3f, Frames); } },
+			{ "addMultiplied", [=](SampleFrame* dst) { MixHelpers::addMultiplied(dst, src, 0.7f, Frames); } },
+			{ "addSwappedMultiplied", [=](SampleFrame* dst) {
+				MixHelpers::addSwappedMultiplied(dst, src, 0.7f, Frames); } },
+			{ "addMultipliedStereo", [=](SampleFrame* dst) {
+				MixHelpers::addMultipliedStereo(dst, src, 0.7f, 0.3f, Frames); } },
+			{ "addSanitizedMultiplied", [=](SampleFrame* dst) {
+				MixHelpers::addSanitizedMultiplied(dst, src, 0.7f, Frames); } },
+			{ "addSanitizedMultipliedByBuffer", [=](SampleFrame* dst) {
+				MixHelpers::addSanitizedMultipliedByBuffer(dst, src, 0.7f, coeffs1, Frames); } },
+			{ "addSanitizedMultipliedByBuffers", [=](SampleFrame* dst) {
+				MixHelpers::addSanitizedMultipliedByBuffers(dst, src, coeffs1, coeffs2, Frames); } },
+			{ "sanitize", [=](SampleFrame* dst) { MixHelpers::sanitize(dst, Frames); } },
+		};
+	}
+
+	std::vector<Isa> supportedIsas()
+	{
+		auto isas = std::vector<Isa>{};
+		for (auto isa : { Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512, Isa::Neon })
+		{
+			if (MixHelpers::setIsa(isa)) { isas.push_back(isa); }
+		}
+		return isas;
+	}
+
+	std::vector<SampleFrame> m_src;
+	std::vector<SampleFrame> m_dst;
+	ValueBuffer m_coeffs1;
+	ValueBuffer m_coeffs2;
+	Isa m_defaultIsa = MixHelpers::isa();
+
+private slots:
+	void initTestCase()
+	{
+		// like the audio threads, and to keep denormals out of the benchmarks
+		disable_denormals();
+		MixHelpers::setNaNHandler(true);
+	}
+
+	void cleanupTestCase()
+	{
+		MixHelpers::setIsa(m_defaultIsa);
+	}
+
+	void kernelsMatchScalarTest()
+	{
+		for (bool nonFinite : { false, true })
+		{
+			if (nonFinite)
+			{
+				// only the sanitizing kernels can deal with these
+				m_src[5] = SampleFrame(std::numeric_limits<float>::infinity(), 0.5f);
+				m_src[200] = SampleFrame(0.5f, std::numeric_limits<float>::quiet_NaN());
+			}
+
+			for (const auto& [name, kernel] : kernels())
+			{
+				if (nonFinite && !QString{name}.startsWith("addSanitized")) { continue; }
+
+				QVERIFY(MixHelpers::setIsa(Isa::Scalar));
+				auto expected = m_dst;
+				kernel(expected.data());
+
+				for (auto isa : supportedIsas())
+				{
+					MixHelpers::setIsa(isa);
+					auto actual = m_dst;
+					kernel(actual.data());
+					for (int f = 0; f < Frames; ++f)
+					{
+						QVERIFY2(actual[f][0] == expected[f][0] && actual[f][1] == expected[f][1],
+							qPrintable(QString{"%1 (%2) differs at frame %3"}.arg(name, MixHelpers::isaName(isa)).arg(f)));
+					}
+				}
+			}
+		}
+
+		m_src[5] = SampleFrame(0.5f, 0.5f);
+		m_src[200] = SampleFrame(0.5f, 0.5f);
+	}
+
+	void sanitizeTest()
+	{
+		for (auto isa : supportedIsas())
+		{
+			MixHelpers::setIsa(isa);
+
+			auto buffer = std::vector<SampleFrame>(Frames, SampleFrame(2000.f, -2000.f));
+			QVERIFY(!MixHelpers::sanitize(buffer.data(), Frames));
+			QCOMPARE(buffer[Frames - 1][0], 1000.f);
+			QCOMPARE(buffer[0][1], -1000.f);
+
+			buffer[Frames - 1][1] = std::numeric_limits<float>::infinity();
+			QVERIFY(MixHelpers::sanitize(buffer.data(), Frames));
+			QCOMPARE(buffer[0][0], 0.f);
+			QCOMPARE(buffer[Frames - 1][1], 0.f);
+		}
+	}
+
+	void isSilentTest()
+	{
+		for (auto isa : supportedIsas())
+		{
+			MixHelpers::setIsa(isa);
+
+			auto buffer = std::vector<SampleFrame>(Frames);
+			QVERIFY(MixHelpers::isSilent(buffer.data(), Frames));
+			buffer[Frames - 1][1] = -0.001f;
+			QVERIFY(!MixHelpers::isSilent(buffer.data(), Frames));
+		}
+	}
+
+	void benchmark_data()
+	{
+		QTest::addColumn<int>("kernel");
+		QTest::addColumn<int>("isa");
+
+		const auto allKernels = kernels();
+		for (auto isa : supportedIsas())
+		{
+			for (std::size_t k = 0; k < allKernels.size(); ++k)
+			{
+				QTest::newRow(qPrintable(QString{"%1/%2"}.arg(allKernels[k].first, MixHelpers::isaName(isa))))
+					<< static_cast<int>(k) << static_cast<int>(isa);
+			}
+		}
+	}
+
+	void benchmark()
+	{
+		QFETCH(int, kernel);
+		QFETCH(int, isa);
+
+		QVERIFY(MixHelpers::setIsa(static_cast<Isa>(isa)));
+		const auto run = kernels()[kernel].second;
+		auto buffer = m_dst;
+		QBENCHMARK
+		{
+			run(buffer.data());
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN(MixHelpersTest)
+#include "MixHelpersTest.moc"
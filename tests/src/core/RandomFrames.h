@@ -0,0 +1,53 @@
+/*
+ * RandomFrames.h - reproducible stereo noise for tests
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef LMMS_TESTS_RANDOM_FRAMES_H
+#define LMMS_TESTS_RANDOM_FRAMES_H
+
+#include <random>
+#include <vector>
+
+#include "SampleFrame.h"
+
+namespace lmms::test
+{
+
+//! Returns uniform stereo noise between -amplitude and amplitude, which is the same
+//! on every run for the same seed
+inline std::vector<SampleFrame> randomFrames(int frames, float amplitude, unsigned seed)
+{
+	auto rng = std::mt19937{seed};
+	auto dist = std::uniform_real_distribution<float>{-amplitude, amplitude};
+	auto result = std::vector<SampleFrame>(frames);
+	for (auto& frame : result)
+	{
+		frame[0] = dist(rng);
+		frame[1] = dist(rng);
+	}
+	return result;
+}
+
+} // namespace lmms::test
+
+#endif // LMMS_TESTS_RANDOM_FRAMES_H
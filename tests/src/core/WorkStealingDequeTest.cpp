@@ -0,0 +1,125 @@
+/*
+ * WorkStealingDequeTest.cpp
+ *
+ * Copyright (c) 2026 The LMMS team
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "WorkStealingDeque.h"
+
+#include <QObject>
+#include <QtTest>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using lmms::WorkStealingDeque;
+
+class WorkStealingDequeTest : public QObject
+{
+	Q_OBJECT
+private slots:
+	void ownerIsLifoTest()
+	{
+		auto items = std::array{1, 2, 3};
+		auto deque = WorkStealingDeque<int, 4>{};
+
+		for (auto& item : items) { QVERIFY(deque.push(&item)); }
+
+		QCOMPARE(deque.pop(), &items[2]);
+		QCOMPARE(deque.pop(), &items[1]);
+		QCOMPARE(deque.pop(), &items[0]);
+		QVERIFY(deque.pop() == nullptr);
+		QVERIFY(deque.empty());
+	}
+
+	void thiefIsFifoTest()
+	{
+		auto items = std::array{1, 2, 3};
+		auto deque = WorkStealingDeque<int, 4>{};
+
+		for (auto& item : items) { QVERIFY(deque.push(&item)); }
+
+		QCOMPARE(deque.steal(), &items[0]);
+		QCOMPARE(deque.steal(), &items[1]);
+		QCOMPARE(deque.pop(), &items[2]);
+		QVERIFY(deque.steal() == nullptr);
+	}
+
+	void pushFailsWhenFullTest()
+	{
+		auto items = std::array{1, 2, 3};
+		auto deque = WorkStealingDeque<int, 2>{};
+
+		QVERIFY(deque.push(&items[0]));
+		QVERIFY(deque.push(&items[1]));
+		QVERIFY(!deque.push(&items[2]));
+
+		QCOMPARE(deque.steal(), &items[0]);
+		QVERIFY(deque.push(&items[2]));
+	}
+
+	void concurrentStealTest()
+	{
+		constexpr auto NumItems = 100000;
+		constexpr auto NumThieves = 4;
+
+		auto items = std::vector<int>(NumItems);
+		auto taken = std::vector<std::atomic_int>(NumItems);
+		auto deque = WorkStealingDeque<int, 256>{};
+		auto producing = std::atomic_bool{true};
+
+		auto take = [&](int* item) { ++taken[item - items.data()]; };
+
+		auto thieves = std::vector<std::thread>{};
+		for (auto i = 0; i < NumThieves; ++i)
+		{
+			thieves.emplace_back([&] {
+				while (producing || !deque.empty())
+				{
+					if (auto item = deque.steal()) { take(item); }
+				}
+			});
+		}
+
+		for (auto i = 0; i < NumItems; ++i)
+		{
+			while (!deque.push(&items[i]))
+			{
+				if (auto item = deque.pop()) { take(item); }
+			}
+			if (i % 3 == 0)
+			{
+				if (auto item = deque.pop()) { take(item); }
+			}
+		}
+		while (auto item = deque.pop()) { take(item); }
+
+		producing = false;
+		for (auto& thief : thieves) { thief.join(); }
+
+		// every item must have been taken exactly once
+		for (const auto& count : taken) { QCOMPARE(count.load(), 1); }
+	}
+};
+
+QTEST_GUILESS_MAIN(WorkStealingDequeTest)
+#include "WorkStealingDequeTest.moc"
@@ -23,6 +23,7 @@
  */
 
 #include <QtTest>
+#include <cmath>
 
 
 #include "AutomationClip.h"
@@ -85,6 +86,31 @@ private slots:
 		QCOMPARE(c.valueAt(150), 1.0f);
 	}
 
+	void testClipValuesAt()
+	{
+		using namespace lmms;
+
+		for (auto type : { AutomationClip::ProgressionType::Discrete,
+			AutomationClip::ProgressionType::Linear, AutomationClip::ProgressionType::CubicHermite })
+		{
+			AutomationClip c(nullptr);
+			c.setProgressionType(type);
+			c.putValue(10, 0.2, false);
+			c.putValue(50, 0.9, false);
+			c.putValue(120, 0.4, false);
+
+			// four frames per tick, starting before the first node
+			constexpr int Frames = 4 * 140;
+			float values[Frames];
+			c.valuesAt(-5.0, 0.25, values, Frames);
+
+			for (int tick = -5; tick < 135; ++tick)
+			{
+				QVERIFY(std::abs(values[(tick + 5) * 4] - c.valueAt(tick)) < 1e-5f);
+			}
+		}
+	}
+
 	void testClips()
 	{
 		using namespace lmms;